@@ -0,0 +1,360 @@
+#!/usr/bin/env python3
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or
+# (at your option) any later version.
+
+"""Serves a local project through a minimal QFieldCloud API stub.
+
+Meant to benchmark the cloud project download scheduler offline. Point
+QField's QFieldCloud server URL to http://<host>:<port> and log in with any
+credentials, the served directory then shows up as a single cloud project.
+
+Bandwidth can be capped globally and per connection, latency added to every
+request and a share of file downloads interrupted midway, which lets the
+adaptive download concurrency be observed under various network conditions.
+Gzip compressed request bodies are accepted and advertised to the client.
+
+Packaging jobs last a configurable time. Job status requests carrying a
+"Prefer: wait=<seconds>" header are held until the status differs from the
+one given in If-None-Match, unless long polling is disabled to exercise the
+client's fallback polling.
+"""
+
+import argparse
+import gzip
+import hashlib
+import json
+import os
+import random
+import re
+import threading
+import time
+import uuid
+from datetime import datetime, timezone
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import unquote
+
+PROJECT_ID = "00000000-0000-0000-0000-000000000001"
+CHUNK_SIZE = 64 * 1024
+
+
+class TokenBucket:
+    """Throttles the bytes sent by all connections sharing the bucket."""
+
+    def __init__(self, bytes_per_second):
+        self.rate = bytes_per_second
+        self.tokens = 0.0
+        self.last = time.monotonic()
+        self.lock = threading.Lock()
+
+    def consume(self, count):
+        if not self.rate:
+            return
+        while True:
+            with self.lock:
+                now = time.monotonic()
+                # allow bursts of at least one chunk so low rates still make progress
+                self.tokens = min(
+                    max(self.rate, count), self.tokens + (now - self.last) * self.rate
+                )
+                self.last = now
+                if self.tokens >= count:
+                    self.tokens -= count
+                    return
+                missing = count - self.tokens
+            time.sleep(missing / self.rate)
+
+
+def scan_files(directory):
+    files = []
+    for root, _dirs, names in os.walk(directory):
+        for name in names:
+            path = os.path.join(root, name)
+            sha256 = hashlib.sha256()
+            with open(path, "rb") as f:
+                for chunk in iter(lambda: f.read(1024 * 1024), b""):
+                    sha256.update(chunk)
+            files.append(
+                {
+                    "name": os.path.relpath(path, directory).replace(os.sep, "/"),
+                    "size": os.path.getsize(path),
+                    "sha256": sha256.hexdigest(),
+                }
+            )
+    return files
+
+
+class StubHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, fmt, *args):
+        if self.server.options.verbose:
+            super().log_message(fmt, *args)
+
+    def send_json(self, payload, status=200, conditional=False):
+        body = json.dumps(payload).encode()
+        if conditional:
+            etag = '"' + hashlib.sha256(body).hexdigest() + '"'
+            if self.headers.get("If-None-Match") == etag:
+                self.send_response(304)
+                self.send_header("ETag", etag)
+                self.send_header("Content-Length", "0")
+                self.end_headers()
+                return
+        self.send_response(status)
+        if conditional:
+            self.send_header("ETag", etag)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        # advertise compressed request bodies support (RFC 7694)
+        self.send_header("Accept-Encoding", "gzip")
+        self.end_headers()
+        self.wfile.write(body)
+
+    def project(self):
+        return {
+            "id": PROJECT_ID,
+            "name": self.server.options.name,
+            "owner": "stub",
+            "description": "Local download benchmark project",
+            "user_role": "admin",
+            "is_public": False,
+            "private": True,
+            "can_repackage": True,
+            "needs_repackaging": False,
+        }
+
+    def user(self):
+        return {
+            "token": "stub",
+            "username": "stub",
+            "email": "stub@localhost",
+            "avatar_url": "",
+        }
+
+    def delay(self):
+        if self.server.options.latency:
+            time.sleep(self.server.options.latency / 1000.0)
+
+    def read_body(self):
+        length = int(self.headers.get("Content-Length", 0))
+        body = self.rfile.read(length) if length else b""
+        if self.headers.get("Content-Encoding", "").lower() == "gzip":
+            if self.server.options.reject_gzip:
+                raise OSError("compressed request bodies are rejected")
+            body = gzip.decompress(body)
+        return body
+
+    def job(self, job_id):
+        with self.server.jobs_lock:
+            created_at = self.server.jobs.get(job_id)
+        if created_at is None:
+            return None
+        elapsed = time.monotonic() - created_at
+        duration = self.server.options.job_duration
+        if elapsed >= duration:
+            status = "finished"
+        elif elapsed >= duration / 3:
+            status = "started"
+        else:
+            status = "queued"
+        return {"id": job_id, "status": status}
+
+    def send_job(self, job_id):
+        job = self.job(job_id)
+        if job is None:
+            self.send_json({"code": "object_not_found"}, 404)
+            return
+
+        match = re.fullmatch(r"\s*wait=(\d+)\s*", self.headers.get("Prefer", ""))
+        if match and not self.server.options.no_long_poll:
+            wait = min(int(match.group(1)), 60)
+            known_etag = self.headers.get("If-None-Match")
+            deadline = time.monotonic() + wait
+            while f'"{job["status"]}"' == known_etag:
+                if time.monotonic() >= deadline:
+                    self.send_response(304)
+                    self.send_header("ETag", known_etag)
+                    self.send_header("Preference-Applied", f"wait={wait}")
+                    self.send_header("Content-Length", "0")
+                    self.end_headers()
+                    return
+                time.sleep(0.1)
+                job = self.job(job_id)
+
+            body = json.dumps(job).encode()
+            self.send_response(200)
+            self.send_header("ETag", f'"{job["status"]}"')
+            self.send_header("Preference-Applied", f"wait={wait}")
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+            return
+
+        self.send_json(job)
+
+    def do_GET(self):
+        self.delay()
+        path = self.path.split("?")[0]
+
+        if path == "/api/v1/auth/user/":
+            self.send_json(self.user())
+        elif path in ("/api/v1/projects/", "/api/v1/projects/public/"):
+            self.send_json([self.project()], conditional=True)
+        elif path == f"/api/v1/projects/{PROJECT_ID}/":
+            self.send_json(self.project())
+        elif re.fullmatch(r"/api/v1/jobs/[^/]+/", path):
+            self.send_job(path.split("/")[-2])
+        elif path == f"/api/v1/deltas/{PROJECT_ID}/":
+            self.send_json([])
+        elif path == f"/api/v1/packages/{PROJECT_ID}/latest/":
+            self.send_json(
+                {
+                    "package_id": "stub",
+                    "packaged_at": self.server.packaged_at,
+                    "files": self.server.files,
+                    "layers": {},
+                }
+            )
+        elif path.startswith(f"/api/v1/packages/{PROJECT_ID}/latest/files/"):
+            name = unquote(path[len(f"/api/v1/packages/{PROJECT_ID}/latest/files/") :])
+            self.send_file(name.rstrip("/"))
+        else:
+            self.send_json({"code": "object_not_found"}, 404)
+
+    def do_POST(self):
+        self.delay()
+        path = self.path.split("?")[0]
+        try:
+            body = self.read_body()
+        except OSError:
+            self.send_json({"code": "unsupported_media_type"}, 415)
+            return
+
+        if path == "/api/v1/auth/token/":
+            self.send_json(self.user())
+        elif path == "/api/v1/auth/logout/":
+            self.send_json({})
+        elif path == "/api/v1/jobs/":
+            job_id = str(uuid.uuid4())
+            with self.server.jobs_lock:
+                self.server.jobs[job_id] = time.monotonic()
+            self.send_json(self.job(job_id), 201)
+        elif path == f"/api/v1/deltas/{PROJECT_ID}/":
+            if self.server.options.verbose:
+                print(
+                    f"Received {self.headers.get('Content-Length', 0)} bytes deltas upload, "
+                    f"{len(body)} bytes once decoded"
+                )
+            self.send_json({}, 200)
+        else:
+            # among others, delta downloads are not supported by the stub
+            self.send_json({"code": "not_implemented"}, 501)
+
+    def send_file(self, name):
+        directory = os.path.abspath(self.server.options.directory)
+        path = os.path.abspath(os.path.join(directory, name))
+        if not path.startswith(directory + os.sep) or not os.path.isfile(path):
+            self.send_json({"code": "object_not_found"}, 404)
+            return
+
+        size = os.path.getsize(path)
+        start = 0
+        match = re.fullmatch(r"bytes=(\d+)-", self.headers.get("Range", ""))
+        if match and int(match.group(1)) < size:
+            start = int(match.group(1))
+            self.send_response(206)
+            self.send_header("Content-Range", f"bytes {start}-{size - 1}/{size}")
+        else:
+            self.send_response(200)
+        self.send_header("Content-Type", "application/octet-stream")
+        self.send_header("Content-Length", str(size - start))
+        self.end_headers()
+
+        options = self.server.options
+        connection_bucket = TokenBucket(options.connection_bandwidth)
+        interrupt_at = None
+        if random.random() < options.error_rate:
+            interrupt_at = start + random.randint(0, max(size - start - 1, 0))
+
+        with open(path, "rb") as f:
+            f.seek(start)
+            sent = start
+            while True:
+                chunk = f.read(CHUNK_SIZE)
+                if not chunk:
+                    break
+                self.server.bucket.consume(len(chunk))
+                connection_bucket.consume(len(chunk))
+                if interrupt_at is not None and sent + len(chunk) > interrupt_at:
+                    # simulate a dropped connection, the client is expected to resume
+                    self.close_connection = True
+                    return
+                self.wfile.write(chunk)
+                sent += len(chunk)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("directory", help="directory served as the project content")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8011)
+    parser.add_argument("--name", default="Download benchmark")
+    parser.add_argument(
+        "--bandwidth", type=int, default=0, help="total bytes per second, 0 for unlimited"
+    )
+    parser.add_argument(
+        "--connection-bandwidth",
+        type=int,
+        default=0,
+        help="bytes per second per connection, 0 for unlimited",
+    )
+    parser.add_argument(
+        "--latency", type=int, default=0, help="milliseconds added to each request"
+    )
+    parser.add_argument(
+        "--error-rate",
+        type=float,
+        default=0.0,
+        help="share of file downloads interrupted midway, between 0 and 1",
+    )
+    parser.add_argument(
+        "--job-duration",
+        type=float,
+        default=0.0,
+        help="seconds taken by packaging jobs to finish",
+    )
+    parser.add_argument(
+        "--no-long-poll",
+        action="store_true",
+        help="answer job status requests right away, as servers without long polling",
+    )
+    parser.add_argument(
+        "--reject-gzip",
+        action="store_true",
+        help="reject compressed request bodies with 415 while still advertising gzip support",
+    )
+    parser.add_argument("--verbose", action="store_true")
+    options = parser.parse_args()
+
+    server = ThreadingHTTPServer((options.host, options.port), StubHandler)
+    server.options = options
+    server.bucket = TokenBucket(options.bandwidth)
+    server.files = scan_files(options.directory)
+    server.packaged_at = datetime.now(timezone.utc).isoformat()
+    server.jobs = {}
+    server.jobs_lock = threading.Lock()
+
+    total = sum(f["size"] for f in server.files)
+    print(
+        f"Serving {len(server.files)} files ({total} bytes) from {options.directory} "
+        f"on http://{options.host}:{options.port}"
+    )
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -80,7 +80,7 @@ int main( int argc, char **argv )
     QCoreApplication::setApplicationName( qfield::appName );
 
 #if defined( Q_OS_ANDROID )
-    // For now the service only deals with background attachment uploads and will terminate once all uploads are done
+    // The service uploads pending attachments and, when enabled, synchronizes cloud projects, it terminates once done
     QFieldService app( argc, argv );
 #endif
     return 0;
@@ -84,6 +84,11 @@ bool AppInterface::printAtlasFeatures( const QString &layoutName, const QList<lo
   return mApp->printAtlasFeatures( layoutName, featureIds );
 }
 
+void AppInterface::cancelPrint()
+{
+  mApp->cancelPrint();
+}
+
 void AppInterface::openFeatureForm()
 {
   emit openFeatureFormRequested();
@@ -50,6 +50,7 @@ class AppInterface : public QObject
 
     Q_INVOKABLE bool print( const QString &layoutName );
     Q_INVOKABLE bool printAtlasFeatures( const QString &layoutName, const QList<long long> &featureIds );
+    Q_INVOKABLE void cancelPrint();
 
     Q_INVOKABLE void setScreenDimmerTimeout( int timeoutSeconds );
 
@@ -99,6 +100,12 @@ class AppInterface : public QObject
     //! Signal emitted requesting QField to open its local data picker screen to show the \a path content
     void openPath( const QString &path );
 
+    //! Signal emitted when the progress of the ongoing layout export changed, from 0 to 1
+    void printProgressChanged( double progress );
+
+    //! Signal emitted once the ongoing layout export is over, with \a error describing the failure if any
+    void printFinished( bool success, const QString &error );
+
   private:
     static AppInterface *sAppInterface;
 
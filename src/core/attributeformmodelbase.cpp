@@ -151,6 +151,10 @@ void AttributeFormModelBase::resetModel()
 
   mVisibilityExpressions.clear();
   mConstraints.clear();
+  mVisibilityDependents.clear();
+  mAllAttributesVisibilityDependents.clear();
+  mConstraintDependents.clear();
+  mAllAttributesConstraintDependents.clear();
 
   if ( !mFeatureModel )
     return;
@@ -214,6 +218,53 @@ void AttributeFormModelBase::resetModel()
     }
 
     mExpressionContext = mLayer->createExpressionContext();
+    buildDependencyGraph();
+  }
+}
+
+void AttributeFormModelBase::buildDependencyGraph()
+{
+  const QgsFields fields = mLayer->fields();
+  mExpressionContext.setFields( fields );
+
+  for ( int i = 0; i < mVisibilityExpressions.size(); i++ )
+  {
+    QgsExpression &expression = mVisibilityExpressions[i].first;
+    expression.prepare( &mExpressionContext );
+
+    if ( expression.referencedColumns().contains( QgsFeatureRequest::ALL_ATTRIBUTES ) )
+    {
+      mAllAttributesVisibilityDependents << i;
+      continue;
+    }
+
+    const QSet<int> referencedFieldIndexes = expression.referencedAttributeIndexes( fields );
+    for ( const int referencedFieldIndex : referencedFieldIndexes )
+      mVisibilityDependents[referencedFieldIndex] << i;
+  }
+
+  for ( auto it = mConstraints.constBegin(); it != mConstraints.constEnd(); ++it )
+  {
+    QStandardItem *item = it.key();
+    const int fieldIndex = item->data( AttributeFormModel::FieldIndex ).toInt();
+    mConstraintDependents[fieldIndex] << item;
+
+    if ( !( it.value().constraints() & QgsFieldConstraints::ConstraintExpression ) )
+      continue;
+
+    const QSet<QString> referencedColumns = QgsExpression( it.value().constraintExpression() ).referencedColumns();
+    if ( referencedColumns.contains( QgsFeatureRequest::ALL_ATTRIBUTES ) )
+    {
+      mAllAttributesConstraintDependents << item;
+      continue;
+    }
+
+    for ( const QString &referencedColumn : referencedColumns )
+    {
+      const int referencedFieldIndex = fields.lookupField( referencedColumn );
+      if ( referencedFieldIndex >= 0 && referencedFieldIndex != fieldIndex )
+        mConstraintDependents[referencedFieldIndex] << item;
+    }
   }
 }
 
@@ -495,10 +546,11 @@ void AttributeFormModelBase::updateDefaultValues( int fieldIndex, QVector<int> u
   const QgsFields fields = mFeatureModel->feature().fields();
   if ( fieldIndex < 0 || fieldIndex >= fields.size() )
     return;
-  const QString fieldName = fields.at( fieldIndex ).name();
 
-  mExpressionContext.setFields( fields );
-  mExpressionContext.setFeature( mFeatureModel->feature() );
+  // only default values referencing the field which triggered the update are evaluated again
+  const QList<int> dependents = mFeatureModel->defaultValueDependents( fieldIndex );
+  if ( dependents.isEmpty() )
+    return;
 
   QMap<QStandardItem *, QgsFieldConstraints>::ConstIterator constraintIterator( mConstraints.constBegin() );
   for ( ; constraintIterator != mConstraints.constEnd(); ++constraintIterator )
@@ -506,17 +558,10 @@ void AttributeFormModelBase::updateDefaultValues( int fieldIndex, QVector<int> u
     QStandardItem *item = constraintIterator.key();
     int fidx = item->data( AttributeFormModel::FieldIndex ).toInt();
     const bool isNewFeature = mFeatureModel->feature().id() == FID_NULL;
-    if ( fidx == fieldIndex || !fields.at( fidx ).defaultValueDefinition().isValid() || ( !isNewFeature && !fields.at( fidx ).defaultValueDefinition().applyOnUpdate() ) )
+    if ( fidx == fieldIndex || !dependents.contains( fidx ) || ( !isNewFeature && !fields.at( fidx ).defaultValueDefinition().applyOnUpdate() ) )
       continue;
 
-    QgsExpression exp( fields.at( fidx ).defaultValueDefinition().expression() );
-    exp.prepare( &mExpressionContext );
-
-    // avoid cost of value update if expression doesn't contain the field which triggered the default values update
-    if ( !exp.referencedColumns().contains( fieldName ) )
-      continue;
-
-    const QVariant defaultValue = exp.evaluate( &mExpressionContext );
+    const QVariant defaultValue = mFeatureModel->evaluateDefaultValue( fidx );
     const QVariant previousValue = mFeatureModel->data( mFeatureModel->index( fidx ), FeatureModel::AttributeValue );
     const bool success = mFeatureModel->setData( mFeatureModel->index( fidx ), defaultValue, FeatureModel::AttributeValue );
     const QVariant updatedValue = mFeatureModel->data( mFeatureModel->index( fidx ), FeatureModel::AttributeValue );
@@ -535,29 +580,50 @@ void AttributeFormModelBase::updateDefaultValues( int fieldIndex, QVector<int> u
 
 void AttributeFormModelBase::updateVisibilityAndConstraints( int fieldIndex )
 {
-  QgsFields fields = mFeatureModel->feature().fields();
-  mExpressionContext.setFields( fields );
-  mExpressionContext.setFeature( mFeatureModel->feature() );
+  const QgsFeature feature = mFeatureModel->feature();
+  mExpressionContext.setFields( feature.fields() );
+  mExpressionContext.setFeature( feature );
+
+  // only the expressions and constraints depending on the changed field are evaluated again
+  QList<int> visibilityExpressionIndexes;
+  QSet<QStandardItem *> constraintItems;
+  if ( fieldIndex == -1 )
+  {
+    for ( int i = 0; i < mVisibilityExpressions.size(); i++ )
+      visibilityExpressionIndexes << i;
+    constraintItems = qgis::listToSet( mConstraints.keys() );
+  }
+  else
+  {
+    visibilityExpressionIndexes = mVisibilityDependents.value( fieldIndex ) + mAllAttributesVisibilityDependents;
+    constraintItems = qgis::listToSet( mConstraintDependents.value( fieldIndex ) + mAllAttributesConstraintDependents );
+  }
 
-  for ( const VisibilityExpression &it : std::as_const( mVisibilityExpressions ) )
+  for ( const int visibilityExpressionIndex : std::as_const( visibilityExpressionIndexes ) )
   {
-    if ( fieldIndex == -1 || it.first.referencedAttributeIndexes( fields ).contains( fieldIndex ) )
+    VisibilityExpression &visibilityExpression = mVisibilityExpressions[visibilityExpressionIndex];
+    bool visible = visibilityExpression.first.evaluate( &mExpressionContext ).toInt();
+    for ( QStandardItem *item : std::as_const( visibilityExpression.second ) )
     {
-      QgsExpression exp = it.first;
-      exp.prepare( &mExpressionContext );
-
-      bool visible = exp.evaluate( &mExpressionContext ).toInt();
-      for ( QStandardItem *item : std::as_const( it.second ) )
+      if ( item->data( AttributeFormModel::CurrentlyVisible ).toBool() != visible )
       {
-        if ( item->data( AttributeFormModel::CurrentlyVisible ).toBool() != visible )
+        item->setData( visible, AttributeFormModel::CurrentlyVisible );
+        emit dataChanged( item->index(), item->index(), QVector<int>() << AttributeFormModel::CurrentlyVisible );
+
+        // constraints of hidden fields are not enforced
+        for ( int i = 0; i < item->rowCount(); i++ )
         {
-          item->setData( visible, AttributeFormModel::CurrentlyVisible );
-          emit dataChanged( item->index(), item->index(), QVector<int>() << AttributeFormModel::CurrentlyVisible );
+          QStandardItem *child = item->child( i );
+          if ( mConstraints.contains( child ) )
+            constraintItems << child;
         }
       }
     }
   }
 
+  for ( QStandardItem *item : std::as_const( constraintItems ) )
+    validateConstraints( item, feature );
+
   // reset contrainsts status of containers
   if ( mHasTabs )
   {
@@ -576,69 +642,28 @@ void AttributeFormModelBase::updateVisibilityAndConstraints( int fieldIndex )
   for ( ; constraintIterator != mConstraints.constEnd(); ++constraintIterator )
   {
     QStandardItem *item = constraintIterator.key();
-    const bool isVisible = item->parent() ? item->parent()->data( AttributeFormModel::CurrentlyVisible ).toBool()
-                                          : true;
-    int fidx = item->data( AttributeFormModel::FieldIndex ).toInt();
-    if ( isVisible && mFeatureModel->data( mFeatureModel->index( fidx ), FeatureModel::AttributeAllowEdit ) == true )
+    QStandardItem *tabItem = nullptr;
+    if ( mHasTabs && item->parent() )
     {
-      QStringList errors;
-
-      QgsFeature feature = mFeatureModel->feature();
-      QString defaultValueClause = mLayer->dataProvider()->defaultValueClause( fidx );
-      QString attrValue = feature.attribute( fidx ).toString();
-
-      // Providers will check for a literal "defaultValueClause" to autogenerate PKs.
-      // For example, the gpkg provider will generate a fid if it is set to "Autogenerate".
-      // On QField, if the user leaves the field empty, we will assume he wants to autogenerate it.
-      // This makes sure, the NOT NULL constraint is skipped in this case.
-      if ( attrValue.isEmpty() && !defaultValueClause.isEmpty() )
-      {
-        feature.setAttribute( fidx, defaultValueClause );
-      }
-
-      bool hardConstraintSatisfied = QgsVectorLayerUtils::validateAttribute( mLayer, feature, fidx, errors, QgsFieldConstraints::ConstraintStrengthHard );
-      if ( hardConstraintSatisfied != item->data( AttributeFormModel::ConstraintHardValid ).toBool() )
-      {
-        item->setData( hardConstraintSatisfied, AttributeFormModel::ConstraintHardValid );
-      }
-      if ( !item->data( AttributeFormModel::ConstraintHardValid ).toBool() )
+      tabItem = item->parent();
+      while ( tabItem->parent() )
       {
-        allConstraintsHardValid = false;
-        if ( mHasTabs && item->parent() )
-        {
-          QStandardItem *parentItem = item->parent();
-          while ( parentItem->parent() )
-          {
-            parentItem = parentItem->parent();
-          }
-          parentItem->setData( false, AttributeFormModel::ConstraintHardValid );
-        }
+        tabItem = tabItem->parent();
       }
+    }
 
-      QStringList softErrors;
-      bool softConstraintSatisfied = QgsVectorLayerUtils::validateAttribute( mLayer, mFeatureModel->feature(), fidx, softErrors, QgsFieldConstraints::ConstraintStrengthSoft );
-      if ( softConstraintSatisfied != item->data( AttributeFormModel::ConstraintSoftValid ).toBool() )
-      {
-        item->setData( softConstraintSatisfied, AttributeFormModel::ConstraintSoftValid );
-      }
-      if ( !item->data( AttributeFormModel::ConstraintSoftValid ).toBool() )
-      {
-        allConstraintsSoftValid = false;
-        if ( mHasTabs && item->parent() )
-        {
-          QStandardItem *parentItem = item->parent();
-          while ( parentItem->parent() )
-          {
-            parentItem = parentItem->parent();
-          }
-          parentItem->setData( false, AttributeFormModel::ConstraintSoftValid );
-        }
-      }
+    if ( !item->data( AttributeFormModel::ConstraintHardValid ).toBool() )
+    {
+      allConstraintsHardValid = false;
+      if ( tabItem )
+        tabItem->setData( false, AttributeFormModel::ConstraintHardValid );
     }
-    else
+
+    if ( !item->data( AttributeFormModel::ConstraintSoftValid ).toBool() )
     {
-      item->setData( true, AttributeFormModel::ConstraintHardValid );
-      item->setData( true, AttributeFormModel::ConstraintSoftValid );
+      allConstraintsSoftValid = false;
+      if ( tabItem )
+        tabItem->setData( false, AttributeFormModel::ConstraintSoftValid );
     }
   }
 
@@ -646,6 +671,50 @@ void AttributeFormModelBase::updateVisibilityAndConstraints( int fieldIndex )
   setConstraintsSoftValid( allConstraintsSoftValid );
 }
 
+void AttributeFormModelBase::validateConstraints( QStandardItem *item, const QgsFeature &feature )
+{
+  const bool wasHardValid = item->data( AttributeFormModel::ConstraintHardValid ).toBool();
+  const bool wasSoftValid = item->data( AttributeFormModel::ConstraintSoftValid ).toBool();
+
+  const bool isVisible = item->parent() ? item->parent()->data( AttributeFormModel::CurrentlyVisible ).toBool()
+                                        : true;
+  int fidx = item->data( AttributeFormModel::FieldIndex ).toInt();
+  if ( isVisible && mFeatureModel->data( mFeatureModel->index( fidx ), FeatureModel::AttributeAllowEdit ) == true )
+  {
+    QStringList errors;
+
+    // Providers will check for a literal "defaultValueClause" to autogenerate PKs.
+    // For example, the gpkg provider will generate a fid if it is set to "Autogenerate".
+    // On QField, if the user leaves the field empty, we will assume he wants to autogenerate it.
+    // This makes sure, the NOT NULL constraint is skipped in this case.
+    bool hardConstraintSatisfied = false;
+    const QString defaultValueClause = feature.attribute( fidx ).toString().isEmpty() ? mLayer->dataProvider()->defaultValueClause( fidx ) : QString();
+    if ( !defaultValueClause.isEmpty() )
+    {
+      QgsFeature clauseFeature = feature;
+      clauseFeature.setAttribute( fidx, defaultValueClause );
+      hardConstraintSatisfied = QgsVectorLayerUtils::validateAttribute( mLayer, clauseFeature, fidx, errors, QgsFieldConstraints::ConstraintStrengthHard );
+    }
+    else
+    {
+      hardConstraintSatisfied = QgsVectorLayerUtils::validateAttribute( mLayer, feature, fidx, errors, QgsFieldConstraints::ConstraintStrengthHard );
+    }
+
+    if ( hardConstraintSatisfied != wasHardValid )
+      item->setData( hardConstraintSatisfied, AttributeFormModel::ConstraintHardValid );
+
+    QStringList softErrors;
+    bool softConstraintSatisfied = QgsVectorLayerUtils::validateAttribute( mLayer, feature, fidx, softErrors, QgsFieldConstraints::ConstraintStrengthSoft );
+    if ( softConstraintSatisfied != wasSoftValid )
+      item->setData( softConstraintSatisfied, AttributeFormModel::ConstraintSoftValid );
+  }
+  else
+  {
+    item->setData( true, AttributeFormModel::ConstraintHardValid );
+    item->setData( true, AttributeFormModel::ConstraintSoftValid );
+  }
+}
+
 bool AttributeFormModelBase::constraintsHardValid() const
 {
   return mConstraintsHardValid;
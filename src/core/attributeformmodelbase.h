@@ -88,8 +88,18 @@ class AttributeFormModelBase : public QStandardItemModel
 
     void updateDefaultValues( int fieldIndex = -1, QVector<int> updatedFields = QVector<int>() );
 
+    /**
+     * Updates the visibility and constraints status of the items depending on field \a fieldIndex,
+     * or of all items if \a fieldIndex is -1.
+     */
     void updateVisibilityAndConstraints( int fieldIndex = -1 );
 
+    //! Validates the constraints of the field \a item against \a feature
+    void validateConstraints( QStandardItem *item, const QgsFeature &feature );
+
+    //! Prepares the visibility expressions and records which expressions and constraints depend on each field
+    void buildDependencyGraph();
+
     void setConstraintsHardValid( bool constraintsHardValid );
 
     void setConstraintsSoftValid( bool constraintsSoftValid );
@@ -115,6 +125,15 @@ class AttributeFormModelBase : public QStandardItemModel
     typedef QPair<QgsExpression, QVector<QStandardItem *>> VisibilityExpression;
     QList<VisibilityExpression> mVisibilityExpressions;
     QMap<QStandardItem *, QgsFieldConstraints> mConstraints;
+
+    //! Indexes of the visibility expressions referencing each field index
+    QHash<int, QList<int>> mVisibilityDependents;
+    //! Indexes of the visibility expressions referencing all attributes
+    QList<int> mAllAttributesVisibilityDependents;
+    //! Field items whose constraints reference each field index, including the field itself
+    QHash<int, QList<QStandardItem *>> mConstraintDependents;
+    //! Field items whose constraint expression references all attributes
+    QList<QStandardItem *> mAllAttributesConstraintDependents;
     QMap<QStandardItem *, QString> mEditorWidgetCodes;
 
     QgsExpressionContext mExpressionContext;
@@ -320,7 +320,7 @@ QString DeltaFileWrapper::toFileForUpload( const QString &outFileName ) const
   if ( !deltaFile.open( QIODevice::WriteOnly | QIODevice::Unbuffered ) )
     return QString();
 
-  if ( deltaFile.write( QJsonDocument( jsonRoot ).toJson( QJsonDocument::Indented ) ) == -1 )
+  if ( deltaFile.write( QJsonDocument( jsonRoot ).toJson( QJsonDocument::Compact ) ) == -1 )
     return QString();
 
   return fileName;
@@ -118,11 +118,16 @@ void FeatureModel::setCurrentLayer( QgsVectorLayer *layer )
   if ( layer == mLayer )
     return;
 
+  if ( mLayer )
+    disconnect( mLayer, &QgsVectorLayer::updatedFields, this, &FeatureModel::invalidateDefaultValues );
+
   mLayer = layer;
+  invalidateDefaultValues();
 
   if ( mLayer )
   {
     connect( mLayer, &QgsVectorLayer::destroyed, this, &FeatureModel::removeLayer, Qt::UniqueConnection );
+    connect( mLayer, &QgsVectorLayer::updatedFields, this, &FeatureModel::invalidateDefaultValues, Qt::UniqueConnection );
 
     //load remember values or create new entry
     if ( sRememberings->contains( mLayer ) )
@@ -196,6 +201,7 @@ void FeatureModel::setPositionLocked( bool positionLocked )
     return;
 
   mPositionLocked = positionLocked;
+  mPositionScopeDirty = true;
 
   emit positionLockedChanged();
 }
@@ -203,6 +209,7 @@ void FeatureModel::setPositionLocked( bool positionLocked )
 void FeatureModel::setCloudUserInformation( const CloudUserInformation &cloudUserInformation )
 {
   mCloudUserInformation = cloudUserInformation;
+  mCloudUserScopeDirty = true;
 
   emit cloudUserInformationChanged();
 }
@@ -365,35 +372,174 @@ void FeatureModel::updateDefaultValues()
   if ( !mLayer )
     return;
 
-  QgsExpressionContext expressionContext = mLayer->createExpressionContext();
-  if ( mPositionInformation.isValid() )
-  {
-    expressionContext << ExpressionContextUtils::positionScope( mPositionInformation, mPositionLocked );
-  }
-  if ( mTopSnappingResult.isValid() )
+  prepareDefaultValues();
+
+  const QgsFields fields = mLayer->fields();
+  for ( auto it = mDefaultValues.constBegin(); it != mDefaultValues.constEnd(); ++it )
   {
-    expressionContext << ExpressionContextUtils::mapToolCaptureScope( mTopSnappingResult );
+    if ( fields.at( it.key() ).defaultValueDefinition().applyOnUpdate() )
+      mFeature.setAttribute( it.key(), evaluateDefaultValue( it.key() ) );
   }
-  expressionContext << ExpressionContextUtils::cloudUserScope( mCloudUserInformation );
-  expressionContext.setFeature( mFeature );
+}
+
+void FeatureModel::invalidateDefaultValues()
+{
+  mDefaultValuesPrepared = false;
+  mDefaultValues.clear();
+  mDefaultValueDependents.clear();
+  mAllAttributesDefaultValueDependents.clear();
+}
+
+void FeatureModel::prepareDefaultValues()
+{
+  if ( mDefaultValuesPrepared || !mLayer )
+    return;
+
+  invalidateDefaultValues();
+  mDefaultValuesPrepared = true;
+
+  const QgsFields fields = mLayer->fields();
+
+  // the position, snapping and cloud user scopes are given fixed indexes to be refreshed in place when they change
+  mExpressionContext = mLayer->createExpressionContext();
+  mExpressionContext.setFields( fields );
+  mPositionScopeIndex = mExpressionContext.scopeCount();
+  mExpressionContext << new QgsExpressionContextScope();
+  mSnappingScopeIndex = mExpressionContext.scopeCount();
+  mExpressionContext << new QgsExpressionContextScope();
+  mCloudUserScopeIndex = mExpressionContext.scopeCount();
+  mExpressionContext << new QgsExpressionContextScope();
+  mPositionScopeDirty = true;
+  mSnappingScopeDirty = true;
+  mCloudUserScopeDirty = true;
+
+  // their variables are static, preparing expressions without them keeps their values from being folded in
+  QgsExpressionContext prepareContext = mLayer->createExpressionContext();
+  prepareContext.setFields( fields );
 
-  QgsFields fields = mLayer->fields();
   for ( int i = 0; i < fields.count(); ++i )
   {
-    if ( fields.at( i ).defaultValueDefinition().isValid() && fields.at( i ).defaultValueDefinition().applyOnUpdate() )
+    const QgsDefaultValue definition = fields.at( i ).defaultValueDefinition();
+    if ( !definition.isValid() )
+      continue;
+
+    DefaultValue defaultValue;
+    defaultValue.expression = QgsExpression( definition.expression() );
+    defaultValue.expression.prepare( &prepareContext );
+    if ( defaultValue.expression.hasParserError() )
+      QgsMessageLog::logMessage( tr( "Default value expression for %1:%2 has parser error: %3" ).arg( mLayer->name(), fields.at( i ).name(), defaultValue.expression.parserErrorString() ), QStringLiteral( "QField" ) );
+
+    const QSet<QString> variables = defaultValue.expression.referencedVariables();
+    for ( const QString &variable : variables )
     {
-      QgsExpression exp( fields.at( i ).defaultValueDefinition().expression() );
-      exp.prepare( &expressionContext );
-      if ( exp.hasParserError() )
-        QgsMessageLog::logMessage( tr( "Default value expression for %1:%2 has parser error: %3" ).arg( mLayer->name(), fields.at( i ).name(), exp.parserErrorString() ), QStringLiteral( "QField" ) );
+      if ( variable.isEmpty() )
+      {
+        // the variable name is only known once evaluated
+        defaultValue.usesPosition = true;
+        defaultValue.usesSnapping = true;
+        defaultValue.usesCloudUser = true;
+        break;
+      }
+      else if ( variable.startsWith( QLatin1String( "position_" ) ) || variable.startsWith( QLatin1String( "gnss_" ) ) )
+      {
+        defaultValue.usesPosition = true;
+      }
+      else if ( variable == QLatin1String( "snapping_results" ) )
+      {
+        defaultValue.usesSnapping = true;
+      }
+      else if ( variable.startsWith( QLatin1String( "cloud_" ) ) )
+      {
+        defaultValue.usesCloudUser = true;
+      }
+    }
+
+    const QSet<int> referencedIndexes = defaultValue.expression.referencedAttributeIndexes( fields );
+    if ( defaultValue.expression.referencedColumns().contains( QgsFeatureRequest::ALL_ATTRIBUTES ) )
+    {
+      mAllAttributesDefaultValueDependents << i;
+    }
+    else
+    {
+      for ( const int referencedIndex : referencedIndexes )
+        mDefaultValueDependents[referencedIndex] << i;
+    }
 
-      QVariant value = exp.evaluate( &expressionContext );
-      if ( exp.hasEvalError() )
-        QgsMessageLog::logMessage( tr( "Default value expression for %1:%2 has evaluation error: %3" ).arg( mLayer->name(), fields.at( i ).name(), exp.evalErrorString() ), QStringLiteral( "QField" ) );
+    mDefaultValues.insert( i, defaultValue );
+  }
+}
 
-      mFeature.setAttribute( i, value );
+void FeatureModel::updateExpressionContextScopes( const DefaultValue &defaultValue )
+{
+  if ( defaultValue.usesPosition && mPositionScopeDirty )
+  {
+    if ( mPositionInformation.isValid() )
+    {
+      std::unique_ptr<QgsExpressionContextScope> scope( ExpressionContextUtils::positionScope( mPositionInformation, mPositionLocked ) );
+      *mExpressionContext.scope( mPositionScopeIndex ) = *scope;
     }
+    else
+    {
+      *mExpressionContext.scope( mPositionScopeIndex ) = QgsExpressionContextScope();
+    }
+    mPositionScopeDirty = false;
+  }
+
+  if ( defaultValue.usesSnapping && mSnappingScopeDirty )
+  {
+    if ( mTopSnappingResult.isValid() )
+    {
+      std::unique_ptr<QgsExpressionContextScope> scope( ExpressionContextUtils::mapToolCaptureScope( mTopSnappingResult ) );
+      *mExpressionContext.scope( mSnappingScopeIndex ) = *scope;
+    }
+    else
+    {
+      *mExpressionContext.scope( mSnappingScopeIndex ) = QgsExpressionContextScope();
+    }
+    mSnappingScopeDirty = false;
+  }
+
+  if ( defaultValue.usesCloudUser && mCloudUserScopeDirty )
+  {
+    std::unique_ptr<QgsExpressionContextScope> scope( ExpressionContextUtils::cloudUserScope( mCloudUserInformation ) );
+    *mExpressionContext.scope( mCloudUserScopeIndex ) = *scope;
+    mCloudUserScopeDirty = false;
+  }
+}
+
+QList<int> FeatureModel::defaultValueDependents( int fieldIndex )
+{
+  prepareDefaultValues();
+
+  QList<int> dependents = mDefaultValueDependents.value( fieldIndex );
+  for ( const int dependent : std::as_const( mAllAttributesDefaultValueDependents ) )
+  {
+    if ( !dependents.contains( dependent ) )
+      dependents << dependent;
   }
+  return dependents;
+}
+
+QVariant FeatureModel::evaluateDefaultValue( int fieldIndex )
+{
+  if ( !mLayer )
+    return QVariant();
+
+  prepareDefaultValues();
+
+  auto it = mDefaultValues.find( fieldIndex );
+  if ( it == mDefaultValues.end() )
+    return QVariant();
+
+  updateExpressionContextScopes( it.value() );
+  mExpressionContext.setFeature( mFeature );
+
+  QgsExpression &expression = it.value().expression;
+  const QVariant value = expression.evaluate( &mExpressionContext );
+  if ( expression.hasEvalError() )
+    QgsMessageLog::logMessage( tr( "Default value expression for %1:%2 has evaluation error: %3" ).arg( mLayer->name(), mLayer->fields().at( fieldIndex ).name(), expression.evalErrorString() ), QStringLiteral( "QField" ) );
+
+  return value;
 }
 
 bool FeatureModel::save()
@@ -450,21 +596,30 @@ bool FeatureModel::save()
 
     case MultiFeatureModel:
     {
+      // all features are changed within a single edit command, letting listeners coalesce their updates
+      mLayer->beginEditCommand( tr( "Edit features" ) );
+      const QgsAttributes attributes = mFeature.attributes();
       for ( QgsFeature &feature : mFeatures )
       {
-        for ( int i = 0; i < mFeature.attributes().count(); i++ )
+        QgsAttributeMap newValues;
+        QgsAttributeMap oldValues;
+        for ( int i = 0; i < attributes.count(); i++ )
         {
-          if ( !mAttributesAllowEdit[i] )
+          if ( !mAttributesAllowEdit[i] || qgsVariantEqual( feature.attribute( i ), attributes.at( i ) ) )
             continue;
 
-          feature.setAttribute( i, mFeature.attributes().at( i ) );
+          newValues.insert( i, attributes.at( i ) );
+          oldValues.insert( i, feature.attribute( i ) );
+          feature.setAttribute( i, attributes.at( i ) );
         }
 
-        if ( !mLayer->updateFeature( feature ) )
+        // only the edited values are changed, leaving geometries and untouched attributes aside
+        if ( !newValues.isEmpty() && !mLayer->changeAttributeValues( feature.id(), newValues, oldValues ) )
         {
           QgsMessageLog::logMessage( tr( "Cannot update feature" ), QStringLiteral( "QField" ), Qgis::Warning );
         }
       }
+      mLayer->endEditCommand();
       rv &= commit();
     }
   }
@@ -535,18 +690,7 @@ void FeatureModel::resetAttributes( bool partialReset )
   if ( !mLayer )
     return;
 
-  QgsExpressionContext expressionContext = mLayer->createExpressionContext();
-  if ( mPositionInformation.isValid() )
-  {
-    expressionContext << ExpressionContextUtils::positionScope( mPositionInformation, mPositionLocked );
-  }
-
-  //set snapping_results to ExpressionScope...
-  if ( mTopSnappingResult.isValid() )
-    expressionContext << ExpressionContextUtils::mapToolCaptureScope( mTopSnappingResult );
-
-  expressionContext << ExpressionContextUtils::cloudUserScope( mCloudUserInformation );
-  expressionContext.setFeature( mFeature );
+  prepareDefaultValues();
 
   QgsFields fields = mLayer->fields();
 
@@ -556,20 +700,9 @@ void FeatureModel::resetAttributes( bool partialReset )
     //if the value does not need to be remembered and it's not prefilled by the linked parent feature
     if ( !sRememberings->value( mLayer ).rememberedAttributes.at( i ) && !mLinkedAttributeIndexes.contains( i ) )
     {
-      if ( fields.at( i ).defaultValueDefinition().isValid() )
+      if ( mDefaultValues.contains( i ) )
       {
-        QgsExpression exp( fields.at( i ).defaultValueDefinition().expression() );
-        exp.prepare( &expressionContext );
-        if ( exp.hasParserError() )
-          QgsMessageLog::logMessage( tr( "Default value expression for %1:%2 has parser error: %3" ).arg( mLayer->name(), fields.at( i ).name(), exp.parserErrorString() ), QStringLiteral( "QField" ) );
-
-        QVariant value = exp.evaluate( &expressionContext );
-
-        if ( exp.hasEvalError() )
-          QgsMessageLog::logMessage( tr( "Default value expression for %1:%2 has evaluation error: %3" ).arg( mLayer->name(), fields.at( i ).name(), exp.evalErrorString() ), QStringLiteral( "QField" ) );
-
-
-        mFeature.setAttribute( i, value );
+        mFeature.setAttribute( i, evaluateDefaultValue( i ) );
       }
       else if ( !partialReset )
       {
@@ -794,6 +927,7 @@ GnssPositionInformation FeatureModel::positionInformation() const
 void FeatureModel::setPositionInformation( const GnssPositionInformation &positionInformation )
 {
   mPositionInformation = positionInformation;
+  mPositionScopeDirty = true;
   emit positionInformationChanged();
 }
 
@@ -805,6 +939,7 @@ SnappingResult FeatureModel::topSnappingResult() const
 void FeatureModel::setTopSnappingResult( const SnappingResult &topSnappingResult )
 {
   mTopSnappingResult = topSnappingResult;
+  mSnappingScopeDirty = true;
 }
 
 void FeatureModel::applyVertexModelToGeometry()
@@ -940,6 +1075,7 @@ void FeatureModel::setProject( QgsProject *project )
     return;
 
   mProject = project;
+  invalidateDefaultValues();
 
   emit projectChanged();
 }
@@ -26,6 +26,8 @@
 
 #include <QAbstractListModel>
 #include <QtPositioning/QGeoPositionInfoSource>
+#include <qgsexpression.h>
+#include <qgsexpressioncontext.h>
 #include <qgsfeature.h>
 #include <qgsrelationmanager.h>
 
@@ -248,6 +250,18 @@ class FeatureModel : public QAbstractListModel
      */
     void setCloudUserInformation( const CloudUserInformation &cloudUserInformation );
 
+    /**
+     * Returns the indexes of the fields whose default value expression references the field at \a fieldIndex
+     */
+    QList<int> defaultValueDependents( int fieldIndex );
+
+    /**
+     * Evaluates the default value expression of the field at \a fieldIndex against the current feature,
+     * position information, top snapping result and cloud user information
+     * \returns an invalid variant if the field has no default value expression
+     */
+    QVariant evaluateDefaultValue( int fieldIndex );
+
     //! Returns the current project from which the digitizing logs will be sought
     QgsProject *project() const { return mProject; }
 
@@ -288,6 +302,19 @@ class FeatureModel : public QAbstractListModel
     void setLinkedFeatureValues();
     void updateDefaultValues();
 
+    //! A default value expression prepared once per layer, along with the context scopes it needs
+    struct DefaultValue
+    {
+        QgsExpression expression;
+        bool usesPosition = false;
+        bool usesSnapping = false;
+        bool usesCloudUser = false;
+    };
+
+    void prepareDefaultValues();
+    void invalidateDefaultValues();
+    void updateExpressionContextScopes( const DefaultValue &defaultValue );
+
     ModelModes mModelMode = SingleFeatureModel;
     QPointer<QgsVectorLayer> mLayer;
     QgsFeature mFeature;
@@ -305,6 +332,22 @@ class FeatureModel : public QAbstractListModel
     QgsProject *mProject = nullptr;
     QString mTempName;
     bool mPositionLocked = false;
+
+    bool mDefaultValuesPrepared = false;
+    //! Prepared default values per field index, in the fields order they are applied in
+    QMap<int, DefaultValue> mDefaultValues;
+    //! Fields whose default value references a given field, and those referencing all of them
+    QHash<int, QList<int>> mDefaultValueDependents;
+    QList<int> mAllAttributesDefaultValueDependents;
+
+    //! The layer context, followed by the position, snapping and cloud user scopes refreshed in place when needed
+    QgsExpressionContext mExpressionContext;
+    int mPositionScopeIndex = -1;
+    int mSnappingScopeIndex = -1;
+    int mCloudUserScopeIndex = -1;
+    bool mPositionScopeDirty = true;
+    bool mSnappingScopeDirty = true;
+    bool mCloudUserScopeDirty = true;
 };
 
 #endif // FEATUREMODEL_H
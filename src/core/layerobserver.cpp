@@ -165,29 +165,7 @@ void LayerObserver::onCommittedAttributeValuesChanges( const QString &localLayer
     return;
 
   QgsVectorLayer *vl = qobject_cast<QgsVectorLayer *>( sender() );
-  QgsFeatureIds patchedFids = mPatchedFids.value( localLayerId );
-  QgsChangedFeatures changedFeatures = mChangedFeatures.value( localLayerId );
-  const QgsFeatureIds changedAttributesValuesFids = qgis::listToSet( changedAttributesValues.keys() );
-  const QString sourceLayerId = DeltaFileWrapper::getSourceLayerId( vl );
-  const QPair<int, QString> localPkAttrPair = DeltaFileWrapper::getLocalPkAttribute( vl );
-  const QPair<int, QString> sourcePkAttrPair = DeltaFileWrapper::getSourcePkAttribute( vl );
-
-  for ( const QgsFeatureId &fid : changedAttributesValuesFids )
-  {
-    if ( patchedFids.contains( fid ) )
-      continue;
-
-    Q_ASSERT( changedFeatures.contains( fid ) );
-
-    patchedFids.insert( fid );
-
-    QgsFeature oldFeature = changedFeatures.take( fid );
-    QgsFeature newFeature = vl->getFeature( fid );
-    mDeltaFileWrapper->addPatch( localLayerId, sourceLayerId, localPkAttrPair.second, sourcePkAttrPair.second, oldFeature, newFeature );
-  }
-
-  mPatchedFids.insert( localLayerId, patchedFids );
-  mChangedFeatures.insert( localLayerId, changedFeatures );
+  addPatches( vl, localLayerId, qgis::listToSet( changedAttributesValues.keys() ) );
 }
 
 
@@ -197,14 +175,20 @@ void LayerObserver::onCommittedGeometriesChanges( const QString &localLayerId, c
     return;
 
   QgsVectorLayer *vl = qobject_cast<QgsVectorLayer *>( sender() );
+  addPatches( vl, localLayerId, qgis::listToSet( changedGeometries.keys() ) );
+}
+
+
+void LayerObserver::addPatches( QgsVectorLayer *vl, const QString &localLayerId, const QgsFeatureIds &changedFids )
+{
   QgsFeatureIds patchedFids = mPatchedFids.value( localLayerId );
   QgsChangedFeatures changedFeatures = mChangedFeatures.value( localLayerId );
-  const QgsFeatureIds changedGeometriesFids = qgis::listToSet( changedGeometries.keys() );
   const QString sourceLayerId = DeltaFileWrapper::getSourceLayerId( vl );
   const QPair<int, QString> localPkAttrPair = DeltaFileWrapper::getLocalPkAttribute( vl );
   const QPair<int, QString> sourcePkAttrPair = DeltaFileWrapper::getSourcePkAttribute( vl );
 
-  for ( const QgsFeatureId &fid : changedGeometriesFids )
+  QgsFeatureIds fidsToPatch;
+  for ( const QgsFeatureId &fid : changedFids )
   {
     if ( patchedFids.contains( fid ) )
       continue;
@@ -212,11 +196,19 @@ void LayerObserver::onCommittedGeometriesChanges( const QString &localLayerId, c
     Q_ASSERT( changedFeatures.contains( fid ) );
 
     patchedFids.insert( fid );
+    fidsToPatch.insert( fid );
+  }
 
-    QgsFeature oldFeature = changedFeatures.take( fid );
-    QgsFeature newFeature = vl->getFeature( fid );
-
-    mDeltaFileWrapper->addPatch( localLayerId, sourceLayerId, localPkAttrPair.second, sourcePkAttrPair.second, oldFeature, newFeature );
+  if ( !fidsToPatch.isEmpty() )
+  {
+    // NOTE a single request for all the patched features, large batch edits would otherwise issue one request per feature
+    QgsFeatureIterator featuresIt = vl->getFeatures( QgsFeatureRequest( fidsToPatch ) );
+    QgsFeature newFeature;
+    while ( featuresIt.nextFeature( newFeature ) )
+    {
+      QgsFeature oldFeature = changedFeatures.take( newFeature.id() );
+      mDeltaFileWrapper->addPatch( localLayerId, sourceLayerId, localPkAttrPair.second, sourcePkAttrPair.second, oldFeature, newFeature );
+    }
   }
 
   mPatchedFids.insert( localLayerId, patchedFids );
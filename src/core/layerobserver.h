@@ -131,6 +131,16 @@ class LayerObserver : public QObject
 
 
   private:
+    /**
+     * Writes the "patch" deltas of features \a changedFids not patched yet, their new version is fetched at once.
+     *
+     * @param vl
+     * @param localLayerId
+     * @param changedFids
+     */
+    void addPatches( QgsVectorLayer *vl, const QString &localLayerId, const QgsFeatureIds &changedFids );
+
+
     /**
      * The current Deltas File Wrapper object
      */
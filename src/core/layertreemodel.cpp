@@ -15,6 +15,7 @@
  ***************************************************************************/
 #include "layertreemodel.h"
 
+#include <qgsapplication.h>
 #include <qgslayertree.h>
 #include <qgslayertreemodel.h>
 #include <qgslayertreemodellegendnode.h>
@@ -23,6 +24,8 @@
 #include <qgsmapthemecollection.h>
 #include <qgsquickmapsettings.h>
 #include <qgsrasterlayer.h>
+#include <qgsrenderer.h>
+#include <qgstaskmanager.h>
 #include <qgsvectorlayer.h>
 #include <qgsvectorlayerfeaturecounter.h>
 
@@ -118,6 +121,11 @@ FlatLayerTreeModelBase::FlatLayerTreeModelBase( QgsLayerTree *layerTree, QgsProj
   connect( mLayerTreeModel, &QAbstractItemModel::dataChanged, this, &FlatLayerTreeModelBase::updateMap );
   connect( mLayerTreeModel, &QAbstractItemModel::rowsRemoved, this, &FlatLayerTreeModelBase::removeFromMap );
   connect( mLayerTreeModel, &QAbstractItemModel::rowsInserted, this, &FlatLayerTreeModelBase::insertInMap );
+
+  // coalesce the feature count changes of bulk edits into a single update per layer
+  mFeatureCountChangedTimer.setSingleShot( true );
+  mFeatureCountChangedTimer.setInterval( 100 );
+  connect( &mFeatureCountChangedTimer, &QTimer::timeout, this, &FlatLayerTreeModelBase::emitFeatureCountChanged );
 }
 
 void FlatLayerTreeModelBase::freeze()
@@ -150,180 +158,119 @@ void FlatLayerTreeModelBase::insertInMap( const QModelIndex &parent, int first,
   if ( mFrozen )
     return;
 
-  bool resetNeeded = false;
-  for ( int i = 0; first + i <= last; i++ )
+  int parentRow = -1;
+  if ( parent.isValid() )
   {
-    QModelIndex index = mLayerTreeModel->index( first + i, 0, parent );
-    if ( mLayerTreeModel->hasChildren( index ) )
+    auto parentIt = mRowMap.constFind( parent.internalPointer() );
+    if ( parentIt == mRowMap.constEnd() || isWmsLayerNode( mLayerTreeModel->index2node( parent ) ) )
     {
-      resetNeeded = true;
-      break;
+      // the children of hidden parents are not shown either
+      return;
     }
+    parentRow = parentIt.value();
   }
 
-  if ( resetNeeded )
+  // the inserted rows go after the descendants of the closest preceding sibling shown, or right after the parent
+  int insertedAt = parentRow + 1;
+  for ( int i = first - 1; i >= 0; i-- )
   {
-    // Added rows with pre-existing children can't be handled, model reset needed
-    buildMap( mLayerTreeModel );
-    return;
-  }
-
-  int insertedAt = -1;
-  if ( first == 0 )
-  {
-    if ( !parent.isValid() )
+    auto siblingIt = mRowMap.constFind( mLayerTreeModel->index( i, 0, parent ).internalPointer() );
+    if ( siblingIt != mRowMap.constEnd() )
     {
-      insertedAt = 0;
-    }
-    else if ( mRowMap.contains( parent ) )
-    {
-      insertedAt = mRowMap[parent] + 1;
-    }
-  }
-  else
-  {
-    QModelIndex index = mLayerTreeModel->index( first - 1, 0, parent );
-    if ( mRowMap.contains( index ) )
-    {
-      insertedAt = mRowMap[index] + 1;
+      insertedAt = lastDescendantRow( siblingIt.value() ) + 1;
+      break;
     }
   }
 
-  if ( insertedAt > -1 )
-  {
-    beginInsertRows( QModelIndex(), insertedAt, insertedAt + ( last - first ) );
-
-    QMap<int, int> treeLevelMap;
-    mIndexMap.clear();
-    const QList<QModelIndex> keys = mRowMap.keys();
-    for ( const auto &index : keys )
-    {
-      int row = mRowMap[index];
-      int treeLevel = mTreeLevelMap[row];
+  const int treeLevel = parentRow > -1 ? mRows.at( parentRow ).treeLevel + 1 : 0;
+  QVector<FlatRow> rows;
+  collectRows( parent, first, last, treeLevel, rows );
+  if ( rows.isEmpty() )
+    return;
 
-      if ( row >= insertedAt )
-      {
-        row = row + ( last - first ) + 1;
-        mRowMap[index] = row;
-      }
+  const int count = rows.size();
+  beginInsertRows( QModelIndex(), insertedAt, insertedAt + count - 1 );
 
-      mIndexMap.insert( row, index );
-      treeLevelMap.insert( row, treeLevel );
-    }
-    mTreeLevelMap = treeLevelMap;
+  // the rows below move down, their map entries only need shifting
+  for ( auto it = mRowMap.begin(); it != mRowMap.end(); ++it )
+  {
+    if ( it.value() >= insertedAt )
+      it.value() += count;
+  }
 
-    int treeLevel = 0;
-    QModelIndex checkParent = parent;
-    while ( checkParent.isValid() )
-    {
-      treeLevel++;
-      checkParent = checkParent.parent();
-    }
+  mRows.insert( insertedAt, count, FlatRow() );
+  for ( int i = 0; i < count; i++ )
+  {
+    mRows[insertedAt + i] = rows.at( i );
+    mRowMap.insert( rows.at( i ).index.internalPointer(), insertedAt + i );
+  }
 
-    for ( int i = 0; first + i <= last; i++ )
-    {
-      QModelIndex index = mLayerTreeModel->index( first + i, 0, parent );
-      mRowMap[index] = insertedAt + i;
-      mIndexMap[insertedAt + i] = index;
-      mTreeLevelMap[insertedAt + i] = treeLevel;
-    }
+  const bool isParentCollapsed = parentRow > -1 && ( mRows.at( parentRow ).isCollapsed || mRows.at( parentRow ).isParentCollapsed );
+  for ( int i = insertedAt; i < insertedAt + count; i++ )
+  {
+    if ( mRows.at( i ).treeLevel != treeLevel )
+      continue;
 
-    endInsertRows();
+    mRows[i].isParentCollapsed = isParentCollapsed;
+    updateParentCollapsed( i );
   }
+
+  endInsertRows();
 }
 
 void FlatLayerTreeModelBase::removeFromMap( const QModelIndex &parent, int first, int last )
 {
+  Q_UNUSED( parent )
+  Q_UNUSED( first )
+  Q_UNUSED( last )
+
   if ( mFrozen )
     return;
 
+  // the persistent indexes of removed rows, including their children, have been invalidated by the source model
   int removedAt = -1;
-  if ( first == 0 )
+  int removedCount = 0;
+  for ( int i = 0; i < mRows.size(); i++ )
   {
-    if ( !parent.isValid() )
-    {
-      removedAt = 0;
-    }
-    else
-    {
-      if ( mRowMap.contains( parent ) )
-      {
-        removedAt = mRowMap[parent] + 1;
-      }
-    }
-  }
-  else
-  {
-    QModelIndex index = mLayerTreeModel->index( first - 1, 0, parent );
-    if ( mRowMap.contains( index ) )
-    {
-      removedAt = mRowMap[index] + 1;
-    }
-  }
+    if ( mRows.at( i ).index.isValid() )
+      continue;
 
-  if ( removedAt > -1 )
-  {
-    bool resetNeeded = false;
-    int modifiedUntil = removedAt;
-    const int treeLevelRemovedAt = mTreeLevelMap[removedAt];
-    while ( modifiedUntil < mTreeLevelMap.size() && mTreeLevelMap[modifiedUntil] >= treeLevelRemovedAt )
+    if ( removedAt == -1 )
     {
-      if ( mTreeLevelMap[modifiedUntil] > treeLevelRemovedAt )
-      {
-        resetNeeded = true;
-        break;
-      }
-      modifiedUntil++;
+      removedAt = i;
     }
-    modifiedUntil--;
-
-    if ( resetNeeded )
+    else if ( i != removedAt + removedCount )
     {
-      // Removed rows can't be handled, model reset needed
+      // Removed rows are not contiguous, model reset needed
       buildMap( mLayerTreeModel );
       return;
     }
+    removedCount++;
+  }
 
-    beginRemoveRows( QModelIndex(), removedAt, removedAt + ( last - first ) );
+  if ( removedAt > -1 )
+  {
+    beginRemoveRows( QModelIndex(), removedAt, removedAt + removedCount - 1 );
+    mRows.remove( removedAt, removedCount );
 
-    QMap<int, int> treeLevelMap;
-    mIndexMap.clear();
-    const QList<QModelIndex> keys = mRowMap.keys();
-    for ( const auto &index : keys )
+    // the rows below move up, their map entries only need shifting
+    for ( auto it = mRowMap.begin(); it != mRowMap.end(); )
     {
-      int row = mRowMap[index];
-      int treeLevel = mTreeLevelMap[row];
-
-      if ( row >= removedAt && row <= removedAt + ( last - first ) )
+      if ( it.value() >= removedAt + removedCount )
       {
-        mRowMap.remove( index );
-        continue;
+        it.value() -= removedCount;
+        ++it;
       }
-      else if ( row > removedAt + ( last - first ) )
+      else if ( it.value() >= removedAt )
       {
-        int oldrow = row;
-        row = row - ( last - first + 1 );
-        if ( oldrow <= modifiedUntil && treeLevel == treeLevelRemovedAt )
-        {
-          mRowMap.remove( index );
-          QModelIndex movedIndex = mLayerTreeModel->index( index.row() - ( last - first + 1 ), 0, parent );
-          mRowMap.insert( movedIndex, row );
-          mIndexMap[row] = movedIndex;
-        }
-        else
-        {
-          mRowMap[index] = row;
-          mIndexMap[row] = index;
-        }
-        treeLevelMap[row] = treeLevel;
+        it = mRowMap.erase( it );
       }
       else
       {
-        mIndexMap[row] = index;
-        treeLevelMap[row] = treeLevel;
+        ++it;
       }
     }
-    mTreeLevelMap = treeLevelMap;
+
     endRemoveRows();
   }
 }
@@ -338,58 +285,99 @@ int FlatLayerTreeModelBase::buildMap( QgsLayerTreeModel *model, const QModelInde
   {
     reset = true;
     beginResetModel();
-    mRowMap.clear();
-    mIndexMap.clear();
-    mCollapsedItems.clear();
-    mTreeLevelMap.clear();
+    mRows.clear();
   }
 
   if ( model )
   {
-    int nbRows = model->rowCount( parent );
-    for ( int i = 0; i < nbRows; i++ )
-    {
-      QModelIndex index = model->index( i, 0, parent );
-      QgsLayerTreeNode *node = mLayerTreeModel->index2node( index );
-      if ( node && node->customProperty( QStringLiteral( "nodeHidden" ), QStringLiteral( "false" ) ).toString() == QStringLiteral( "true" ) )
-        continue;
+    const int previousRowCount = mRows.size();
+    collectRows( parent, 0, model->rowCount( parent ) - 1, treeLevel, mRows );
+    row += mRows.size() - previousRowCount;
+  }
 
-      const bool isLayer = QgsLayerTree::isLayer( node );
-      if ( isLayer )
-      {
-        QgsLayerTreeLayer *nodeLayer = QgsLayerTree::toLayer( node );
-        QgsMapLayer *layer = nodeLayer->layer();
-        if ( layer && layer->flags().testFlag( QgsMapLayer::Private ) )
-          continue;
-      }
+  if ( reset )
+  {
+    for ( int i = 0; i < mRows.size(); i++ )
+    {
+      if ( mRows.at( i ).treeLevel == 0 )
+        updateParentCollapsed( i );
+    }
+    rebuildRowMap();
+    endResetModel();
+  }
+  return row;
+}
 
-      if ( node && !node->isExpanded() )
-        mCollapsedItems << index;
+void FlatLayerTreeModelBase::collectRows( const QModelIndex &parent, int first, int last, int treeLevel, QVector<FlatRow> &rows ) const
+{
+  for ( int i = first; i <= last; i++ )
+  {
+    QModelIndex index = mLayerTreeModel->index( i, 0, parent );
+    QgsLayerTreeNode *node = mLayerTreeModel->index2node( index );
+    if ( node && node->customProperty( QStringLiteral( "nodeHidden" ), QStringLiteral( "false" ) ).toString() == QStringLiteral( "true" ) )
+      continue;
 
-      mRowMap[index] = row;
-      mIndexMap[row] = index;
-      mTreeLevelMap[row] = treeLevel;
-      row++;
-      if ( model->hasChildren( index ) )
-      {
-        if ( isLayer )
-        {
-          QgsLayerTreeLayer *nodeLayer = QgsLayerTree::toLayer( node );
-          QgsRasterLayer *rasterLayer = qobject_cast<QgsRasterLayer *>( nodeLayer->layer() );
-          if ( rasterLayer && rasterLayer->dataProvider() && rasterLayer->dataProvider()->name() == QStringLiteral( "wms" ) )
-          {
-            // WMS layers have no legend items, skip those.
-            continue;
-          }
-        }
-        row = buildMap( model, index, row, treeLevel + 1 );
-      }
+    if ( QgsLayerTree::isLayer( node ) )
+    {
+      QgsMapLayer *layer = QgsLayerTree::toLayer( node )->layer();
+      if ( layer && layer->flags().testFlag( QgsMapLayer::Private ) )
+        continue;
     }
+
+    FlatRow flatRow;
+    flatRow.index = index;
+    flatRow.treeLevel = treeLevel;
+    flatRow.isCollapsed = node && !node->isExpanded();
+    rows << flatRow;
+
+    if ( mLayerTreeModel->hasChildren( index ) && !isWmsLayerNode( node ) )
+      collectRows( index, 0, mLayerTreeModel->rowCount( index ) - 1, treeLevel + 1, rows );
   }
+}
 
-  if ( reset )
-    endResetModel();
-  return row;
+bool FlatLayerTreeModelBase::isWmsLayerNode( QgsLayerTreeNode *node )
+{
+  if ( !QgsLayerTree::isLayer( node ) )
+    return false;
+
+  // WMS layers have no legend items, their children are skipped
+  QgsRasterLayer *rasterLayer = qobject_cast<QgsRasterLayer *>( QgsLayerTree::toLayer( node )->layer() );
+  return rasterLayer && rasterLayer->dataProvider() && rasterLayer->dataProvider()->name() == QStringLiteral( "wms" );
+}
+
+void FlatLayerTreeModelBase::rebuildRowMap()
+{
+  mRowMap.clear();
+  mRowMap.reserve( mRows.size() );
+  for ( int i = 0; i < mRows.size(); i++ )
+    mRowMap.insert( mRows.at( i ).index.internalPointer(), i );
+}
+
+int FlatLayerTreeModelBase::lastDescendantRow( int row ) const
+{
+  const int treeLevel = mRows.at( row ).treeLevel;
+  int endRow = row;
+  while ( endRow + 1 < mRows.size() && mRows.at( endRow + 1 ).treeLevel > treeLevel )
+    endRow++;
+  return endRow;
+}
+
+void FlatLayerTreeModelBase::updateParentCollapsed( int row )
+{
+  // collapsed state of the ancestors of the visited rows, indexed by tree level relative to row
+  const int treeLevel = mRows.at( row ).treeLevel;
+  QVector<bool> collapsedAncestors;
+  collapsedAncestors << ( mRows.at( row ).isCollapsed || mRows.at( row ).isParentCollapsed );
+
+  const int endRow = lastDescendantRow( row );
+  for ( int i = row + 1; i <= endRow; i++ )
+  {
+    FlatRow &flatRow = mRows[i];
+    const int level = flatRow.treeLevel - treeLevel;
+    collapsedAncestors.resize( level + 1 );
+    flatRow.isParentCollapsed = collapsedAncestors.at( level - 1 );
+    collapsedAncestors[level] = flatRow.isParentCollapsed || flatRow.isCollapsed;
+  }
 }
 
 void FlatLayerTreeModelBase::setSourceModel( QAbstractItemModel *sourceModel )
@@ -400,16 +388,17 @@ void FlatLayerTreeModelBase::setSourceModel( QAbstractItemModel *sourceModel )
 
 QModelIndex FlatLayerTreeModelBase::mapToSource( const QModelIndex &proxyIndex ) const
 {
-  if ( !proxyIndex.isValid() || !mIndexMap.contains( proxyIndex.row() ) )
+  if ( !proxyIndex.isValid() || proxyIndex.row() >= mRows.size() )
     return QModelIndex();
-  return mIndexMap[proxyIndex.row()];
+  return mRows.at( proxyIndex.row() ).index;
 }
 
 QModelIndex FlatLayerTreeModelBase::mapFromSource( const QModelIndex &sourceIndex ) const
 {
-  if ( !mRowMap.contains( sourceIndex ) )
+  auto it = mRowMap.constFind( sourceIndex.internalPointer() );
+  if ( it == mRowMap.constEnd() )
     return QModelIndex();
-  return createIndex( mRowMap[sourceIndex], sourceIndex.column() );
+  return createIndex( it.value(), sourceIndex.column() );
 }
 
 QModelIndex FlatLayerTreeModelBase::parent( const QModelIndex &child ) const
@@ -423,7 +412,7 @@ int FlatLayerTreeModelBase::columnCount( const QModelIndex &parent ) const
 }
 int FlatLayerTreeModelBase::rowCount( const QModelIndex &parent ) const
 {
-  return !parent.isValid() ? mRowMap.size() : 0;
+  return !parent.isValid() ? mRows.size() : 0;
 }
 
 QModelIndex FlatLayerTreeModelBase::index( int row, int column, const QModelIndex &parent ) const
@@ -753,7 +742,7 @@ QVariant FlatLayerTreeModelBase::data( const QModelIndex &index, int role ) cons
 
     case FlatLayerTreeModel::TreeLevel:
     {
-      return mTreeLevelMap.contains( index.row() ) ? mTreeLevelMap[index.row()] : 0;
+      return mRows.at( index.row() ).treeLevel;
     }
 
     case FlatLayerTreeModel::IsValid:
@@ -804,39 +793,22 @@ QVariant FlatLayerTreeModelBase::data( const QModelIndex &index, int role ) cons
       if ( layer->dataProvider() && layer->dataProvider()->name() == QStringLiteral( "WFS" ) )
         return QVariant();
 
-      if ( layer->renderer() && layer->renderer()->type() == QStringLiteral( "singleSymbol" ) && layer->renderer()->legendSymbolItems().size() > 0 )
-      {
-        const long count = layer->featureCount( layer->renderer()->legendSymbolItems().at( 0 ).ruleKey() );
-        if ( count == -1 )
-        {
-          connect( layer, &QgsVectorLayer::symbolFeatureCountMapChanged, this, &FlatLayerTreeModelBase::featureCountChanged, Qt::UniqueConnection );
-          layer->countSymbolFeatures();
-        }
-        return QVariant::fromValue<long>( count );
-      }
-      return QVariant::fromValue<long>( layer->featureCount() );
+      return QVariant::fromValue<long>( layerFeatureCount( layer ) );
     }
 
     case FlatLayerTreeModel::IsCollapsed:
     {
-      return mCollapsedItems.contains( sourceIndex );
+      return mRows.at( index.row() ).isCollapsed;
     }
 
     case FlatLayerTreeModel::IsParentCollapsed:
     {
-      QModelIndex currentIndex = sourceIndex;
-      while ( currentIndex.isValid() )
-      {
-        currentIndex = currentIndex.parent();
-        if ( sourceIndex.isValid() && mCollapsedItems.contains( currentIndex ) )
-          return true;
-      }
-      return false;
+      return mRows.at( index.row() ).isParentCollapsed;
     }
 
     case FlatLayerTreeModel::HasChildren:
     {
-      return mTreeLevelMap.contains( index.row() + 1 ) && mTreeLevelMap[index.row() + 1] > mTreeLevelMap[index.row()];
+      return index.row() + 1 < mRows.size() && mRows.at( index.row() + 1 ).treeLevel > mRows.at( index.row() ).treeLevel;
     }
 
     case FlatLayerTreeModel::HasLabels:
@@ -928,10 +900,7 @@ bool FlatLayerTreeModelBase::setData( const QModelIndex &index, const QVariant &
       }
 
       //visibility of the node's children are also impacted, use the tree level value to identify those
-      int treeLevel = mTreeLevelMap[index.row()];
-      int endRow = index.row();
-      while ( mTreeLevelMap.contains( endRow + 1 ) && mTreeLevelMap[endRow + 1] > treeLevel )
-        endRow++;
+      const int endRow = lastDescendantRow( index.row() );
 
       emit dataChanged( index, createIndex( endRow, 0 ), QVector<int>() << FlatLayerTreeModel::Visible );
       return true;
@@ -961,24 +930,15 @@ bool FlatLayerTreeModelBase::setData( const QModelIndex &index, const QVariant &
     case FlatLayerTreeModel::IsCollapsed:
     {
       const bool collapsed = value.toBool();
-      if ( collapsed && !mCollapsedItems.contains( sourceIndex ) )
-      {
-        mCollapsedItems << sourceIndex;
-      }
-      else if ( !collapsed && mCollapsedItems.contains( sourceIndex ) )
-      {
-        mCollapsedItems.removeAll( sourceIndex );
-      }
+      mRows[index.row()].isCollapsed = collapsed;
+      updateParentCollapsed( index.row() );
 
       QgsLayerTreeNode *node = mLayerTreeModel->index2node( sourceIndex );
       if ( node )
         node->setExpanded( !collapsed );
 
       //the node's children are also impacted, use the tree level value to identify those
-      int treeLevel = mTreeLevelMap[index.row()];
-      int endRow = index.row();
-      while ( mTreeLevelMap.contains( endRow + 1 ) && mTreeLevelMap[endRow + 1] > treeLevel )
-        endRow++;
+      const int endRow = lastDescendantRow( index.row() );
 
       emit dataChanged( index, createIndex( endRow, 0 ), QVector<int>() << FlatLayerTreeModel::IsCollapsed << FlatLayerTreeModel::IsParentCollapsed );
       return true;
@@ -1010,9 +970,133 @@ bool FlatLayerTreeModelBase::setData( const QModelIndex &index, const QVariant &
   }
 }
 
-void FlatLayerTreeModelBase::featureCountChanged()
+long long FlatLayerTreeModelBase::layerFeatureCount( QgsVectorLayer *layer ) const
+{
+  auto it = mFeatureCounts.constFind( layer );
+  if ( it != mFeatureCounts.constEnd() )
+    return it.value();
+
+  // the cache is filled lazily as layers get shown
+  const_cast<FlatLayerTreeModelBase *>( this )->initLayerFeatureCount( layer );
+  return mFeatureCounts.value( layer, -1 );
+}
+
+void FlatLayerTreeModelBase::initLayerFeatureCount( QgsVectorLayer *layer )
 {
-  emit dataChanged( createIndex( 0, 0 ), createIndex( rowCount() - 1, 0 ), QVector<int>() << FlatLayerTreeModel::Name << FlatLayerTreeModel::FeatureCount );
+  connect( layer, &QgsVectorLayer::featureAdded, this, &FlatLayerTreeModelBase::layerFeatureAdded );
+  connect( layer, &QgsVectorLayer::featureDeleted, this, &FlatLayerTreeModelBase::layerFeatureDeleted );
+  connect( layer, &QgsVectorLayer::subsetStringChanged, this, &FlatLayerTreeModelBase::layerFeatureCountInvalidated );
+  connect( layer, &QgsVectorLayer::rendererChanged, this, &FlatLayerTreeModelBase::layerFeatureCountInvalidated );
+  connect( layer, &QgsVectorLayer::afterCommitChanges, this, &FlatLayerTreeModelBase::layerFeatureCountInvalidated );
+  connect( layer, &QgsMapLayer::willBeDeleted, this, &FlatLayerTreeModelBase::layerWillBeDeleted );
+
+  QgsFeatureRenderer *renderer = layer->renderer();
+  if ( renderer && renderer->type() == QStringLiteral( "singleSymbol" ) && !renderer->legendSymbolItems().isEmpty() )
+  {
+    // reuse symbol counts the layer may already have
+    const long long count = layer->featureCount( renderer->legendSymbolItems().at( 0 ).ruleKey() );
+    mFeatureCounts.insert( layer, count );
+    if ( count == -1 )
+      recountLayerFeatures( layer );
+  }
+  else
+  {
+    mFeatureCounts.insert( layer, layer->featureCount() );
+  }
+}
+
+void FlatLayerTreeModelBase::recountLayerFeatures( QgsVectorLayer *layer )
+{
+  if ( QgsVectorLayerFeatureCounter *counter = mFeatureCounters.take( layer ) )
+    counter->cancel();
+
+  QgsFeatureRenderer *renderer = layer->renderer();
+  if ( !renderer || renderer->type() != QStringLiteral( "singleSymbol" ) || renderer->legendSymbolItems().isEmpty() )
+  {
+    // the provider feature count, adjusted with the edit buffer, is cheap enough to be read right away
+    setLayerFeatureCount( layer, layer->featureCount() );
+    return;
+  }
+
+  const QString ruleKey = renderer->legendSymbolItems().at( 0 ).ruleKey();
+  QgsVectorLayerFeatureCounter *counter = new QgsVectorLayerFeatureCounter( layer );
+  mFeatureCounters.insert( layer, counter );
+  connect( counter, &QgsVectorLayerFeatureCounter::symbolsCounted, this, [=]() {
+    if ( mFeatureCounters.value( layer ) != counter )
+      return;
+
+    mFeatureCounters.remove( layer );
+    setLayerFeatureCount( layer, counter->featureCount( ruleKey ) );
+  },
+           Qt::QueuedConnection );
+  QgsApplication::taskManager()->addTask( counter );
+}
+
+void FlatLayerTreeModelBase::setLayerFeatureCount( QgsVectorLayer *layer, long long count )
+{
+  auto it = mFeatureCounts.find( layer );
+  if ( it == mFeatureCounts.end() || it.value() == count )
+    return;
+
+  it.value() = count;
+  mFeatureCountChangedLayers << layer;
+  mFeatureCountChangedTimer.start();
+}
+
+void FlatLayerTreeModelBase::layerFeatureAdded()
+{
+  QgsVectorLayer *layer = qobject_cast<QgsVectorLayer *>( sender() );
+  const long long count = mFeatureCounts.value( layer, -1 );
+  // ongoing counts will pick up the change
+  if ( count >= 0 )
+    setLayerFeatureCount( layer, count + 1 );
+}
+
+void FlatLayerTreeModelBase::layerFeatureDeleted()
+{
+  QgsVectorLayer *layer = qobject_cast<QgsVectorLayer *>( sender() );
+  const long long count = mFeatureCounts.value( layer, -1 );
+  if ( count > 0 )
+    setLayerFeatureCount( layer, count - 1 );
+}
+
+void FlatLayerTreeModelBase::layerFeatureCountInvalidated()
+{
+  QgsVectorLayer *layer = qobject_cast<QgsVectorLayer *>( sender() );
+  if ( layer && mFeatureCounts.contains( layer ) )
+    recountLayerFeatures( layer );
+}
+
+void FlatLayerTreeModelBase::layerWillBeDeleted()
+{
+  QgsVectorLayer *layer = qobject_cast<QgsVectorLayer *>( sender() );
+  if ( QgsVectorLayerFeatureCounter *counter = mFeatureCounters.take( layer ) )
+    counter->cancel();
+  mFeatureCounts.remove( layer );
+  mFeatureCountChangedLayers.remove( layer );
+}
+
+void FlatLayerTreeModelBase::emitFeatureCountChanged()
+{
+  const QSet<QgsVectorLayer *> layers = mFeatureCountChangedLayers;
+  mFeatureCountChangedLayers.clear();
+
+  const QList<QgsLayerTreeLayer *> nodeLayers = mLayerTreeModel->rootGroup()->findLayers();
+  for ( QgsLayerTreeLayer *nodeLayer : nodeLayers )
+  {
+    QgsVectorLayer *layer = qobject_cast<QgsVectorLayer *>( nodeLayer->layer() );
+    if ( !layer || !layers.contains( layer ) )
+      continue;
+
+    const QModelIndex index = mapFromSource( mLayerTreeModel->node2index( nodeLayer ) );
+    if ( !index.isValid() )
+      continue;
+
+    // legend items of the layer report its feature count too, use the tree level value to identify those
+    const int endRow = lastDescendantRow( index.row() );
+
+    emit dataChanged( index, createIndex( endRow, 0 ), QVector<int>() << FlatLayerTreeModel::Name << FlatLayerTreeModel::FeatureCount );
+  }
 }
 
 QHash<int, QByteArray> FlatLayerTreeModelBase::roleNames() const
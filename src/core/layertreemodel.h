@@ -17,13 +17,17 @@
 #ifndef LAYERTREEMODEL_H
 #define LAYERTREEMODEL_H
 
+#include <QPointer>
 #include <QSortFilterProxyModel>
+#include <QTimer>
 #include <qgslayertreelayer.h>
 
 class QgsLayerTree;
 class QgsLayerTreeModel;
 class QgsProject;
 class QgsQuickMapSettings;
+class QgsVectorLayer;
+class QgsVectorLayerFeatureCounter;
 
 class FlatLayerTreeModelBase : public QAbstractProxyModel
 {
@@ -85,14 +89,44 @@ class FlatLayerTreeModelBase : public QAbstractProxyModel
     void isTemporalChanged();
 
   private:
-    void featureCountChanged();
+    //! Returns the cached feature count of \a layer, -1 while it is being counted
+    long long layerFeatureCount( QgsVectorLayer *layer ) const;
+    void initLayerFeatureCount( QgsVectorLayer *layer );
+    void recountLayerFeatures( QgsVectorLayer *layer );
+    void setLayerFeatureCount( QgsVectorLayer *layer, long long count );
+    void layerFeatureAdded();
+    void layerFeatureDeleted();
+    void layerFeatureCountInvalidated();
+    void layerWillBeDeleted();
+    void emitFeatureCountChanged();
+
+    void rebuildRowMap();
+    //! Returns whether \a node is a WMS layer, whose legend items are not shown
+    static bool isWmsLayerNode( QgsLayerTreeNode *node );
+    //! Returns the last row holding a descendant of \a row, or \a row itself if it has none
+    int lastDescendantRow( int row ) const;
+    //! Updates the collapsed ancestor state of the descendants of \a row
+    void updateParentCollapsed( int row );
+
     void updateTemporalState();
     void adjustTemporalStateFromAddedLayers( const QList<QgsMapLayer *> &layers );
 
-    QMap<QModelIndex, int> mRowMap;
-    QMap<int, QModelIndex> mIndexMap;
-    QMap<int, int> mTreeLevelMap;
-    QList<QModelIndex> mCollapsedItems;
+    //! State of a flattened row, precomputed so data() does not have to walk the source tree
+    struct FlatRow
+    {
+        QPersistentModelIndex index;
+        int treeLevel = 0;
+        bool isCollapsed = false;
+        //! Whether any ancestor of the row is collapsed, i.e. the row is hidden
+        bool isParentCollapsed = false;
+    };
+
+    //! Appends the shown source rows from \a first to \a last under \a parent and their shown descendants to \a rows
+    void collectRows( const QModelIndex &parent, int first, int last, int treeLevel, QVector<FlatRow> &rows ) const;
+
+    QVector<FlatRow> mRows;
+    //! Flattened rows keyed by the internal pointer of their source index, which unlike the source row is kept as siblings get inserted or removed
+    QHash<const void *, int> mRowMap;
 
     QgsLayerTreeModel *mLayerTreeModel = nullptr;
     QString mMapTheme;
@@ -102,6 +136,12 @@ class FlatLayerTreeModelBase : public QAbstractProxyModel
     bool mIsTemporal = false;
 
     bool mFrozen = false;
+
+    //! Feature counts kept up to date with layer edits, recounted in the background when invalidated
+    QHash<QgsVectorLayer *, long long> mFeatureCounts;
+    QHash<QgsVectorLayer *, QPointer<QgsVectorLayerFeatureCounter>> mFeatureCounters;
+    QSet<QgsVectorLayer *> mFeatureCountChangedLayers;
+    QTimer mFeatureCountChangedTimer;
 };
 
 class FlatLayerTreeModel : public QSortFilterProxyModel
@@ -21,12 +21,120 @@
 #include <qgslayertreemodellegendnode.h>
 #include <qgsproject.h>
 
+#include <QGuiApplication>
+#include <functional>
+
 LegendImageProvider::LegendImageProvider( QgsLayerTreeModel *layerTreeModel )
   : QQuickImageProvider( Pixmap )
   , mLayerTreeModel( layerTreeModel )
   , mRootNode( layerTreeModel->rootGroup() )
 {
   mLayerTreeModel->setFlag( QgsLayerTreeModel::ShowLegendAsTree, true );
+
+  // Cost is expressed in pixels, allowing for a few thousand legend symbols
+  mPixmapCache.setMaxCost( 4096 * 32 * 32 );
+
+  // the provider is not a QObject with Qt5, the connections are broken when it gets deleted
+  mConnections << QObject::connect( mLayerTreeModel, &QAbstractItemModel::rowsInserted, mLayerTreeModel, [=]( const QModelIndex &parent, int, int ) { invalidate( parent ); } );
+  mConnections << QObject::connect( mLayerTreeModel, &QAbstractItemModel::rowsRemoved, mLayerTreeModel, [=]( const QModelIndex &parent, int, int ) { invalidate( parent ); } );
+  mConnections << QObject::connect( mLayerTreeModel, &QAbstractItemModel::dataChanged, mLayerTreeModel, [=]( const QModelIndex &topLeft, const QModelIndex &, const QVector<int> &roles ) {
+    if ( roles.isEmpty() || roles.contains( Qt::DecorationRole ) )
+      invalidate( topLeft );
+  } );
+  mConnections << QObject::connect( mLayerTreeModel, &QAbstractItemModel::modelReset, mLayerTreeModel, [=] {
+    mLegendIndexes.clear();
+    mPixmapCache.clear();
+  } );
+  mConnections << QObject::connect( mLayerTreeModel, &QAbstractItemModel::layoutChanged, mLayerTreeModel, [=] {
+    mLegendIndexes.clear();
+  } );
+}
+
+LegendImageProvider::~LegendImageProvider()
+{
+  for ( const QMetaObject::Connection &connection : std::as_const( mConnections ) )
+    QObject::disconnect( connection );
+}
+
+void LegendImageProvider::invalidate( const QModelIndex &parent )
+{
+  QString layerId;
+  if ( QgsLayerTreeModelLegendNode *legendNode = mLayerTreeModel->index2legendNode( parent ) )
+  {
+    layerId = legendNode->layerNode()->layerId();
+  }
+  else
+  {
+    QgsLayerTreeNode *node = mLayerTreeModel->index2node( parent );
+    if ( QgsLayerTree::isLayer( node ) )
+      layerId = QgsLayerTree::toLayer( node )->layerId();
+  }
+
+  if ( layerId.isEmpty() )
+  {
+    // Changes in groups can add or remove whole layers, id maps are rebuilt on demand
+    mLegendIndexes.clear();
+    return;
+  }
+
+  mLegendIndexes.remove( layerId );
+  invalidateLayerPixmaps( layerId );
+}
+
+void LegendImageProvider::invalidateLayerPixmaps( const QString &layerId )
+{
+  const QString prefix = layerId + '/';
+  const QList<QString> keys = mPixmapCache.keys();
+  for ( const QString &key : keys )
+  {
+    if ( key.startsWith( prefix ) )
+      mPixmapCache.remove( key );
+  }
+}
+
+QModelIndex LegendImageProvider::legendNodeIndex( const QString &layerId, const QString &legendKey )
+{
+  auto layerIndexesIt = mLegendIndexes.find( layerId );
+  if ( layerIndexesIt == mLegendIndexes.end() )
+  {
+    QHash<QString, QPersistentModelIndex> indexes;
+    if ( QgsLayerTreeLayer *layerNode = mRootNode->findLayer( layerId ) )
+    {
+      // Legend keys are the chain of legend node ids joined from the layer node down, see FlatLayerTreeModelBase::data
+      std::function<void( const QModelIndex &, const QString & )> collectIndexes = [&]( const QModelIndex &parent, const QString &parentKey ) {
+        const int rowCount = mLayerTreeModel->rowCount( parent );
+        for ( int row = 0; row < rowCount; row++ )
+        {
+          const QModelIndex index = mLayerTreeModel->index( row, 0, parent );
+          const QString key = parentKey.isEmpty() ? QString::number( index.internalId() ) : parentKey + QStringLiteral( "~__~" ) + QString::number( index.internalId() );
+          indexes.insert( key, index );
+          if ( mLayerTreeModel->hasChildren( index ) )
+            collectIndexes( index, key );
+        }
+      };
+      collectIndexes( mLayerTreeModel->node2index( layerNode ), QString() );
+    }
+    layerIndexesIt = mLegendIndexes.insert( layerId, indexes );
+  }
+
+  return layerIndexesIt.value().value( legendKey );
+}
+
+QPixmap LegendImageProvider::decorationPixmap( const QVariant &decoration, int iconSize ) const
+{
+  QPixmap pixmap = decoration.value<QPixmap>();
+  if ( pixmap.isNull() )
+  {
+    QIcon icon = decoration.value<QIcon>();
+    if ( !icon.isNull() )
+      pixmap = icon.pixmap( iconSize, iconSize );
+  }
+  if ( pixmap.isNull() )
+  {
+    pixmap = QPixmap( iconSize, iconSize );
+    pixmap.fill( QColor( 255, 255, 255 ) );
+  }
+  return pixmap;
 }
 
 QPixmap LegendImageProvider::requestPixmap( const QString &id, QSize *size, const QSize &requestedSize )
@@ -41,48 +149,21 @@ QPixmap LegendImageProvider::requestPixmap( const QString &id, QSize *size, cons
 
   if ( idParts.value( 0 ) == QStringLiteral( "legend" ) )
   {
-    QgsLayerTreeLayer *layerNode = mRootNode->findLayer( idParts.value( 1 ) );
-    QModelIndex layerIndex = mLayerTreeModel->node2index( layerNode );
-    QModelIndex index = mLayerTreeModel->index( 0, 0, layerIndex );
-    QStringList legendParts;
-    while ( index.isValid() )
+    const QModelIndex index = legendNodeIndex( idParts.value( 1 ), idParts.value( 2 ) );
+    if ( index.isValid() )
     {
-      legendParts << QString::number( index.internalId() );
-      if ( idParts.value( 2 ) == legendParts.join( QStringLiteral( "~__~" ) ) )
-      {
-        QPixmap pixmap = mLayerTreeModel->data( index, Qt::DecorationRole ).value<QPixmap>();
-        if ( pixmap.isNull() )
-        {
-          QIcon icon = mLayerTreeModel->data( index, Qt::DecorationRole ).value<QIcon>();
-          if ( !icon.isNull() )
-            pixmap = icon.pixmap( iconSize, iconSize );
-        }
-        if ( pixmap.isNull() )
-        {
-          pixmap = QPixmap( iconSize, iconSize );
-          pixmap.fill( QColor( 255, 255, 255 ) );
-        }
-        return pixmap;
-      }
-      else
-      {
-        if ( mLayerTreeModel->hasChildren( index ) )
-        {
-          index = mLayerTreeModel->index( 0, 0, index );
-        }
-        else
-        {
-          legendParts.removeLast();
-
-          QModelIndex nextIndex = mLayerTreeModel->sibling( index.row() + 1, 0, index );
-          if ( !nextIndex.isValid() && index.parent() != layerIndex )
-          {
-            legendParts.removeLast();
-            nextIndex = mLayerTreeModel->sibling( index.parent().row() + 1, 0, index.parent() );
-          }
-          index = nextIndex;
-        }
-      }
+      QgsLayerTreeModelLegendNode *legendNode = mLayerTreeModel->index2legendNode( index );
+      QString ruleKey = legendNode ? legendNode->data( QgsLayerTreeModelLegendNode::RuleKeyRole ).toString() : QString();
+      if ( ruleKey.isEmpty() )
+        ruleKey = idParts.value( 2 );
+
+      const QString cacheKey = QStringLiteral( "%1/%2/%3/%4" ).arg( idParts.value( 1 ), ruleKey, QString::number( iconSize ), QString::number( qApp->devicePixelRatio() ) );
+      if ( QPixmap *cachedPixmap = mPixmapCache.object( cacheKey ) )
+        return *cachedPixmap;
+
+      const QPixmap pixmap = decorationPixmap( mLayerTreeModel->data( index, Qt::DecorationRole ), iconSize );
+      mPixmapCache.insert( cacheKey, new QPixmap( pixmap ), std::max( 1, pixmap.width() * pixmap.height() ) );
+      return pixmap;
     }
   }
 
@@ -95,18 +176,12 @@ QPixmap LegendImageProvider::requestPixmap( const QString &id, QSize *size, cons
       QgsLayerTreeModelLegendNode *legendNode = mLayerTreeModel->legendNodeEmbeddedInParent( layerNode );
       if ( legendNode )
       {
-        QPixmap pixmap = legendNode->data( Qt::DecorationRole ).value<QPixmap>();
-        if ( pixmap.isNull() )
-        {
-          QIcon icon = legendNode->data( Qt::DecorationRole ).value<QIcon>();
-          if ( !icon.isNull() )
-            pixmap = icon.pixmap( iconSize, iconSize );
-        }
-        if ( pixmap.isNull() )
-        {
-          pixmap = QPixmap( iconSize, iconSize );
-          pixmap.fill( QColor( 255, 255, 255 ) );
-        }
+        const QString cacheKey = QStringLiteral( "%1/__embedded__/%2/%3" ).arg( idParts.value( 1 ), QString::number( iconSize ), QString::number( qApp->devicePixelRatio() ) );
+        if ( QPixmap *cachedPixmap = mPixmapCache.object( cacheKey ) )
+          return *cachedPixmap;
+
+        const QPixmap pixmap = decorationPixmap( legendNode->data( Qt::DecorationRole ), iconSize );
+        mPixmapCache.insert( cacheKey, new QPixmap( pixmap ), std::max( 1, pixmap.width() * pixmap.height() ) );
         return pixmap;
       }
       else
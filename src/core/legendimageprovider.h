@@ -16,21 +16,47 @@
 #ifndef LEGENDIMAGEPROVIDER_H
 #define LEGENDIMAGEPROVIDER_H
 
+#include <QCache>
+#include <QPersistentModelIndex>
 #include <QQuickImageProvider>
 
 class QgsLayerTreeModel;
 class QgsLayerTree;
 
+/**
+ * Provides legend symbol pixmaps for the layer tree.
+ *
+ * Legend node indexes are looked up through a per-layer id map built on first
+ * use, and rendered pixmaps are cached by layer, rule key, size and device pixel
+ * ratio. Both are invalidated when the layer tree model signals changes.
+ */
 class LegendImageProvider : public QQuickImageProvider
 {
   public:
     explicit LegendImageProvider( QgsLayerTreeModel *layerTreeModel );
+    ~LegendImageProvider() override;
 
     QPixmap requestPixmap( const QString &id, QSize *size, const QSize &requestedSize ) override;
 
   private:
+    //! Returns the legend node index matching the \a legendKey of a given \a layerId
+    QModelIndex legendNodeIndex( const QString &layerId, const QString &legendKey );
+
+    //! Forgets legend node indexes and cached pixmaps tied to the layer owning \a parent
+    void invalidate( const QModelIndex &parent );
+
+    //! Forgets cached pixmaps of a given \a layerId
+    void invalidateLayerPixmaps( const QString &layerId );
+
+    QPixmap decorationPixmap( const QVariant &decoration, int iconSize ) const;
+
     QgsLayerTreeModel *mLayerTreeModel = nullptr;
     QgsLayerTree *mRootNode = nullptr;
+
+    QHash<QString, QHash<QString, QPersistentModelIndex>> mLegendIndexes;
+    QCache<QString, QPixmap> mPixmapCache;
+    //! Connections to the layer tree model, whose lambdas refer to this provider
+    QList<QMetaObject::Connection> mConnections;
 };
 
 #endif // LEGENDIMAGEPROVIDER_H
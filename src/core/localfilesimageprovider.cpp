@@ -16,55 +16,224 @@
 
 #include "localfilesimageprovider.h"
 
-#include <QIcon>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QUrl>
 #include <qgsgdalutils.h>
 
 #include <gdal.h>
 
-LocalFilesImageProvider::LocalFilesImageProvider()
-  : QQuickImageProvider( Pixmap )
+#define THUMBNAIL_DEFAULT_WIDTH 92
+#define THUMBNAIL_CACHE_MAXIMUM_SIZE ( 50 * 1024 * 1024 )
+
+LocalFilesThumbnailCache::LocalFilesThumbnailCache( const QString &directory, qint64 maximumSize )
+  : mDirectory( directory )
+  , mMaximumSize( maximumSize )
+{
+}
+
+QString LocalFilesThumbnailCache::path( const QString &key ) const
+{
+  return QStringLiteral( "%1/%2.png" ).arg( mDirectory, QString( QCryptographicHash::hash( key.toUtf8(), QCryptographicHash::Sha1 ).toHex() ) );
+}
+
+bool LocalFilesThumbnailCache::read( const QString &path, QImage &image )
+{
+  QImageReader reader( path );
+  if ( !reader.canRead() || !reader.read( &image ) )
+    return false;
+
+  // the modification time tracks when a thumbnail was last used
+  QFile file( path );
+  if ( file.open( QIODevice::ReadWrite ) )
+    file.setFileTime( QDateTime::currentDateTime(), QFileDevice::FileModificationTime );
+
+  return true;
+}
+
+void LocalFilesThumbnailCache::write( const QString &path, const QImage &image )
+{
+  QSaveFile file( path );
+  if ( !file.open( QIODevice::WriteOnly ) || !image.save( &file, "PNG" ) || !file.commit() )
+    return;
+
+  QMutexLocker locker( &mMutex );
+  if ( mSize >= 0 )
+    mSize += QFileInfo( path ).size();
+
+  if ( mSize < 0 || mSize > mMaximumSize )
+    evict();
+}
+
+void LocalFilesThumbnailCache::evict()
+{
+  // least recently used thumbnails last
+  const QFileInfoList entries = QDir( mDirectory ).entryInfoList( QStringList() << QStringLiteral( "*.png" ), QDir::Files, QDir::Time );
+
+  mSize = 0;
+  for ( const QFileInfo &entry : entries )
+    mSize += entry.size();
+
+  if ( mSize <= mMaximumSize )
+    return;
+
+  // trim below the maximum size to avoid evicting on every write
+  const qint64 targetSize = mMaximumSize * 3 / 4;
+  for ( auto it = entries.crbegin(); it != entries.crend() && mSize > targetSize; ++it )
+  {
+    if ( QFile::remove( it->absoluteFilePath() ) )
+      mSize -= it->size();
+  }
+}
+
+LocalFilesImageResponse::LocalFilesImageResponse( const QString &path, const QSize &requestedSize, const std::shared_ptr<LocalFilesThumbnailCache> &cache )
+  : mPath( path )
+  , mRequestedSize( requestedSize )
+  , mCache( cache )
+{
+  setAutoDelete( false );
+}
+
+QQuickTextureFactory *LocalFilesImageResponse::textureFactory() const
+{
+  return QQuickTextureFactory::textureFactoryForImage( mImage );
+}
+
+void LocalFilesImageResponse::cancel()
+{
+  mCanceled.storeRelaxed( 1 );
+}
+
+void LocalFilesImageResponse::run()
 {
+  if ( mCanceled.loadRelaxed() )
+  {
+    emit finished();
+    return;
+  }
+
+  const QFileInfo fi( mPath );
+  QString cachePath;
+  if ( mCache && fi.exists() )
+  {
+    const QString key = QStringLiteral( "%1|%2|%3|%4" ).arg( fi.absoluteFilePath(), QString::number( fi.lastModified().toMSecsSinceEpoch() ), QString::number( fi.size() ), QString::number( mRequestedSize.width() ) );
+    cachePath = mCache->path( key );
+
+    if ( mCache->read( cachePath, mImage ) )
+    {
+      emit finished();
+      return;
+    }
+  }
+
+  mImage = LocalFilesImageProvider::decodeThumbnail( mPath, mRequestedSize );
+  if ( mImage.isNull() )
+  {
+    mImage = LocalFilesImageProvider::defaultImage( mRequestedSize );
+  }
+  else if ( !cachePath.isEmpty() && !mCanceled.loadRelaxed() )
+  {
+    mCache->write( cachePath, mImage );
+  }
+
+  emit finished();
 }
 
-QImage LocalFilesImageProvider::requestImage( const QString &id, QSize *size, const QSize &requestedSize )
+LocalFilesImageProvider::LocalFilesImageProvider()
+  : QQuickAsyncImageProvider()
 {
-  static const QIcon defaultIcon( QStringLiteral( ":/themes/qfield/nodpi/ic_file_green_48dp.svg" ) );
+  // Decoding large rasters is I/O and memory bound, keep the number of concurrent decodes low
+  mThreadPool.setMaxThreadCount( std::max( 1, std::min( 2, QThread::idealThreadCount() ) ) );
+
+  const QString cacheLocation = QStandardPaths::writableLocation( QStandardPaths::CacheLocation );
+  if ( !cacheLocation.isEmpty() )
+  {
+    const QString cacheDirectory = QStringLiteral( "%1/thumbnails" ).arg( cacheLocation );
+    if ( QDir().mkpath( cacheDirectory ) )
+    {
+      mCache = std::make_shared<LocalFilesThumbnailCache>( cacheDirectory, THUMBNAIL_CACHE_MAXIMUM_SIZE );
+    }
+  }
+}
 
+QQuickImageResponse *LocalFilesImageProvider::requestImageResponse( const QString &id, const QSize &requestedSize )
+{
   // the id is passed on as an encoded URL string which needs decoding
-  QString path = QUrl::fromPercentEncoding( id.toUtf8() );
-  if ( path.toLower().endsWith( QStringLiteral( ".zip" ) ) )
-    path = QStringLiteral( "/vsizip/%1" ).arg( path );
+  const QString path = QUrl::fromPercentEncoding( id.toUtf8() );
+  const QSize size = requestedSize.width() > 0 ? requestedSize : QSize( THUMBNAIL_DEFAULT_WIDTH, THUMBNAIL_DEFAULT_WIDTH );
+
+  LocalFilesImageResponse *response = new LocalFilesImageResponse( path, size, mCache );
+  mThreadPool.start( response );
+  return response;
+}
 
-  const gdal::dataset_unique_ptr dataset( GDALOpen( path.toLocal8Bit().data(), GA_ReadOnly ) );
+QImage LocalFilesImageProvider::defaultImage( const QSize &requestedSize )
+{
+  QImageReader reader( QStringLiteral( ":/themes/qfield/nodpi/ic_file_green_48dp.svg" ) );
+  reader.setScaledSize( requestedSize );
+  return reader.read();
+}
+
+QImage LocalFilesImageProvider::decodeThumbnail( const QString &path, const QSize &requestedSize )
+{
+  QString datasetPath = path;
+  if ( datasetPath.toLower().endsWith( QStringLiteral( ".zip" ) ) )
+    datasetPath = QStringLiteral( "/vsizip/%1" ).arg( datasetPath );
+
+  const gdal::dataset_unique_ptr dataset( GDALOpen( datasetPath.toLocal8Bit().data(), GA_ReadOnly ) );
   if ( !dataset )
-    return defaultIcon.pixmap( QSize( requestedSize ) ).toImage();
+    return QImage();
 
   const int cols = GDALGetRasterXSize( dataset.get() );
   const int rows = GDALGetRasterYSize( dataset.get() );
   int bands = std::min( 4, GDALGetRasterCount( dataset.get() ) );
+  if ( cols <= 0 || rows <= 0 || bands <= 0 )
+    return QImage();
+
   if ( bands == 2 )
   {
     // For 2-band raster, go for a 1-band grayscale representation
     bands = 1;
   }
 
-  const QSize outputSize( requestedSize.width(), rows * requestedSize.width() / cols );
+  const QSize outputSize( requestedSize.width(), std::max( 1, static_cast<int>( static_cast<qint64>( rows ) * requestedSize.width() / cols ) ) );
   QImage image( outputSize, bands == 4 ? QImage::Format_RGBA8888 : bands == 3 ? QImage::Format_RGB888
                                                                               : QImage::Format_Grayscale8 );
   if ( image.isNull() )
-    return defaultIcon.pixmap( QSize( requestedSize ) ).toImage();
+    return QImage();
 
   GByte *firstPixel = reinterpret_cast<GByte *>( image.bits() );
   for ( int i = 0; i < bands; i++ )
   {
-    CPLErr err = GDALRasterIOEx( GDALGetRasterBand( dataset.get(), i + 1 ),
-                                 GF_Read, 0, 0, cols, rows,
+    // Read from the smallest overview still covering the output size, avoiding full resolution reads
+    GDALRasterBandH band = GDALGetRasterBand( dataset.get(), i + 1 );
+    GDALRasterBandH sourceBand = band;
+    const int overviewCount = GDALGetOverviewCount( band );
+    for ( int j = 0; j < overviewCount; j++ )
+    {
+      GDALRasterBandH overview = GDALGetOverview( band, j );
+      if ( overview
+           && GDALGetRasterBandXSize( overview ) >= outputSize.width()
+           && GDALGetRasterBandXSize( overview ) < GDALGetRasterBandXSize( sourceBand ) )
+      {
+        sourceBand = overview;
+      }
+    }
+
+    CPLErr err = GDALRasterIOEx( sourceBand,
+                                 GF_Read, 0, 0, GDALGetRasterBandXSize( sourceBand ), GDALGetRasterBandYSize( sourceBand ),
                                  firstPixel + ( i ),
                                  outputSize.width(), outputSize.height(),
                                  GDT_Byte, bands, image.bytesPerLine(), nullptr );
     if ( err != CE_None )
     {
-      return defaultIcon.pixmap( QSize( requestedSize ) ).toImage();
+      return QImage();
     }
   }
   return image;
@@ -16,15 +16,99 @@
 #ifndef LOCALFILESIMAGEPROVIDER_H
 #define LOCALFILESIMAGEPROVIDER_H
 
-#include <QQuickImageProvider>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QQuickAsyncImageProvider>
+#include <QRunnable>
+#include <QThreadPool>
 
-class LocalFilesImageProvider : public QQuickImageProvider
+#include <memory>
+
+/**
+ * \class LocalFilesThumbnailCache
+ * A disk cache of decoded thumbnails, bounded in bytes.
+ * Least recently used thumbnails are evicted first once the cache grows past its maximum size.
+ * \note thread safe
+ */
+class LocalFilesThumbnailCache
+{
+  public:
+    /**
+     * Constructor
+     * \param directory the directory holding the cached thumbnails
+     * \param maximumSize the maximum size of the cache in bytes
+     */
+    LocalFilesThumbnailCache( const QString &directory, qint64 maximumSize );
+
+    //! Returns the path of the cached thumbnail matching \a key
+    QString path( const QString &key ) const;
+
+    //! Reads the cached thumbnail at \a path into \a image, marking it as recently used
+    bool read( const QString &path, QImage &image );
+
+    //! Writes \a image as the cached thumbnail at \a path, evicting least recently used thumbnails when needed
+    void write( const QString &path, const QImage &image );
+
+  private:
+    void evict();
+
+    QString mDirectory;
+    qint64 mMaximumSize = 0;
+    qint64 mSize = -1;
+    QMutex mMutex;
+};
+
+/**
+ * \class LocalFilesImageResponse
+ * Decodes a local dataset thumbnail on a worker thread, reusing a thumbnail
+ * stored on disk when the dataset is unchanged.
+ */
+class LocalFilesImageResponse : public QQuickImageResponse, public QRunnable
+{
+    Q_OBJECT
+
+  public:
+    explicit LocalFilesImageResponse( const QString &path, const QSize &requestedSize, const std::shared_ptr<LocalFilesThumbnailCache> &cache );
+
+    QQuickTextureFactory *textureFactory() const override;
+
+    void run() override;
+    void cancel() override;
+
+  private:
+    QString mPath;
+    QSize mRequestedSize;
+    std::shared_ptr<LocalFilesThumbnailCache> mCache;
+    QImage mImage;
+    QAtomicInt mCanceled = 0;
+};
+
+/**
+ * \class LocalFilesImageProvider
+ * An asynchronous image provider returning thumbnails of local datasets.
+ * Thumbnails are decoded on a bounded thread pool and cached on disk, keyed
+ * by the dataset path, modification time and size. The disk cache is capped
+ * in bytes, least recently used thumbnails being evicted first.
+ */
+class LocalFilesImageProvider : public QQuickAsyncImageProvider
 {
   public:
     explicit LocalFilesImageProvider();
 
-    QQmlImageProviderBase::ImageType imageType() const override { return QQmlImageProviderBase::Image; }
-    QImage requestImage( const QString &id, QSize *size, const QSize &requestedSize ) override;
+    QQuickImageResponse *requestImageResponse( const QString &id, const QSize &requestedSize ) override;
+
+    /**
+     * Decodes a thumbnail of the dataset at \a path with a width matching \a requestedSize.
+     * The smallest raster overview large enough for the thumbnail is read when available.
+     */
+    static QImage decodeThumbnail( const QString &path, const QSize &requestedSize );
+
+    //! Returns a default icon image used when a dataset cannot be decoded
+    static QImage defaultImage( const QSize &requestedSize );
+
+  private:
+    QThreadPool mThreadPool;
+    std::shared_ptr<LocalFilesThumbnailCache> mCache;
 };
 
 #endif // LOCALFILESIMAGEPROVIDER_H
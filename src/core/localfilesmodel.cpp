@@ -20,12 +20,20 @@
 #include "qgismobileapp.h"
 
 #include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QImageReader>
 
+#define GATHERER_FETCH_LIMIT 200
+#define GATHERER_BATCH_SIZE 50
+#define GATHERER_BATCH_INTERVAL 100
+
 LocalFilesModel::LocalFilesModel( QObject *parent )
   : QAbstractListModel( parent )
 {
+  mListingsCache.setMaxCost( 20 );
+
   QSettings settings;
   const bool favoritesInitialized = settings.value( QStringLiteral( "qfieldFavoritesInitialized" ), false ).toBool();
   if ( !favoritesInitialized )
@@ -44,6 +52,40 @@ LocalFilesModel::LocalFilesModel( QObject *parent )
   resetToRoot();
 }
 
+LocalFilesModel::~LocalFilesModel()
+{
+  if ( mGatherer )
+  {
+    disconnect( mGatherer, nullptr, this, nullptr );
+    mGatherer->stop();
+    mGatherer->wait();
+    delete mGatherer;
+  }
+}
+
+void LocalFilesModel::cleanupGatherer()
+{
+  if ( mGatherer )
+  {
+    disconnect( mGatherer, nullptr, this, nullptr );
+    connect( mGatherer, &QThread::finished, mGatherer, &QObject::deleteLater );
+    mGatherer->stop();
+
+    // the finished signal may have been emitted before being connected to deleteLater
+    if ( mGatherer->isFinished() )
+      mGatherer->deleteLater();
+
+    mGatherer = nullptr;
+
+    emit isLoadingChanged();
+  }
+}
+
+bool LocalFilesModel::isLoading() const
+{
+  return !mGatherer.isNull();
+}
+
 QHash<int, QByteArray> LocalFilesModel::roleNames() const
 {
   QHash<int, QByteArray> roles = QAbstractListModel::roleNames();
@@ -174,6 +216,8 @@ void LocalFilesModel::moveUp()
 
 void LocalFilesModel::reloadModel()
 {
+  cleanupGatherer();
+
   beginResetModel();
   mItems.clear();
 
@@ -214,44 +258,135 @@ void LocalFilesModel::reloadModel()
   }
   else
   {
-    QDir dir( path );
-    if ( dir.exists() )
+    QFileInfo dirInfo( path );
+    if ( dirInfo.isDir() )
     {
-      const QStringList items = dir.entryList( QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot, QDir::DirsFirst | QDir::IgnoreCase );
-      QList<Item> folders;
-      QList<Item> projects;
-      QList<Item> datasets;
-      for ( const QString &item : items )
+      DirectoryListing *listing = mListingsCache.object( path );
+      if ( listing && listing->lastModified == dirInfo.lastModified() )
       {
-        QFileInfo fi( path + QDir::separator() + item );
-        if ( fi.isDir() )
-        {
-          folders << Item( ItemMetaType::Folder, ItemType::SimpleFolder, fi.fileName(), QString(), fi.absoluteFilePath() );
-        }
-        else
-        {
-          const QString suffix = fi.suffix().toLower();
-          if ( SUPPORTED_PROJECT_EXTENSIONS.contains( suffix ) )
-          {
-            projects << Item( ItemMetaType::Project, ItemType::ProjectFile, fi.completeBaseName(), suffix, fi.absoluteFilePath(), fi.size() );
-          }
-          else if ( SUPPORTED_VECTOR_EXTENSIONS.contains( suffix ) && suffix != QStringLiteral( "pdf" ) )
-          {
-            datasets << Item( ItemMetaType::Dataset, ItemType::VectorDataset, fi.completeBaseName(), suffix, fi.absoluteFilePath(), fi.size() );
-          }
-          else if ( SUPPORTED_RASTER_EXTENSIONS.contains( suffix ) )
-          {
-            datasets << Item( ItemMetaType::Dataset, ItemType::RasterDataset, fi.completeBaseName(), suffix, fi.absoluteFilePath(), fi.size() );
-          }
-        }
+        mItems = listing->items;
+      }
+      else
+      {
+        mGatherer = new LocalFilesGatherer( path, GATHERER_FETCH_LIMIT );
+        connect( mGatherer, &LocalFilesGatherer::itemsAvailable, this, &LocalFilesModel::processGatheredItems );
+        connect( mGatherer, &QThread::finished, this, &LocalFilesModel::gathererFinished );
+        mGatherer->start();
+
+        emit isLoadingChanged();
       }
-      mItems << folders << projects << datasets;
     }
   }
 
   endResetModel();
 }
 
+bool LocalFilesModel::itemFromFileInfo( const QFileInfo &fi, Item &item )
+{
+  if ( fi.isDir() )
+  {
+    item = Item( ItemMetaType::Folder, ItemType::SimpleFolder, fi.fileName(), QString(), fi.absoluteFilePath() );
+    return true;
+  }
+
+  const QString suffix = fi.suffix().toLower();
+  if ( SUPPORTED_PROJECT_EXTENSIONS.contains( suffix ) )
+  {
+    item = Item( ItemMetaType::Project, ItemType::ProjectFile, fi.completeBaseName(), suffix, fi.absoluteFilePath(), fi.size() );
+    return true;
+  }
+  else if ( SUPPORTED_VECTOR_EXTENSIONS.contains( suffix ) && suffix != QStringLiteral( "pdf" ) )
+  {
+    item = Item( ItemMetaType::Dataset, ItemType::VectorDataset, fi.completeBaseName(), suffix, fi.absoluteFilePath(), fi.size() );
+    return true;
+  }
+  else if ( SUPPORTED_RASTER_EXTENSIONS.contains( suffix ) )
+  {
+    item = Item( ItemMetaType::Dataset, ItemType::RasterDataset, fi.completeBaseName(), suffix, fi.absoluteFilePath(), fi.size() );
+    return true;
+  }
+
+  return false;
+}
+
+bool LocalFilesModel::itemLessThan( const Item &item1, const Item &item2 )
+{
+  // Folders first, then projects, then datasets, each group sorted by file name (all items share the same parent path)
+  if ( item1.metaType != item2.metaType )
+    return item1.metaType < item2.metaType;
+  return QString::compare( item1.path, item2.path, Qt::CaseInsensitive ) < 0;
+}
+
+void LocalFilesModel::processGatheredItems()
+{
+  if ( !mGatherer || sender() != mGatherer )
+    return;
+
+  QList<Item> items = mGatherer->takeItems();
+  if ( items.isEmpty() )
+    return;
+
+  // Batch items are inserted at their sorted position, the listing stays sorted while the directory is being scanned
+  std::sort( items.begin(), items.end(), &LocalFilesModel::itemLessThan );
+
+  int row = 0;
+  int i = 0;
+  while ( i < items.size() )
+  {
+    row = std::upper_bound( mItems.begin() + row, mItems.end(), items.at( i ), &LocalFilesModel::itemLessThan ) - mItems.begin();
+
+    // consecutive batch items sorting before the same existing row are inserted together
+    int count = 1;
+    while ( i + count < items.size() && ( row == mItems.size() || itemLessThan( items.at( i + count ), mItems.at( row ) ) ) )
+      count++;
+
+    beginInsertRows( QModelIndex(), row, row + count - 1 );
+    for ( int j = 0; j < count; j++ )
+      mItems.insert( row + j, items.at( i + j ) );
+    endInsertRows();
+
+    row += count;
+    i += count;
+  }
+}
+
+void LocalFilesModel::gathererFinished()
+{
+  if ( !mGatherer || sender() != mGatherer )
+    return;
+
+  processGatheredItems();
+
+  if ( !mGatherer->wasCanceled() )
+  {
+    DirectoryListing *listing = new DirectoryListing();
+    listing->lastModified = mGatherer->lastModified();
+    listing->items = mItems;
+    mListingsCache.insert( mGatherer->path(), listing );
+  }
+
+  mGatherer->deleteLater();
+  mGatherer = nullptr;
+
+  emit isLoadingChanged();
+}
+
+bool LocalFilesModel::canFetchMore( const QModelIndex &parent ) const
+{
+  if ( parent.isValid() )
+    return false;
+
+  return mGatherer && mGatherer->hasReachedFetchLimit();
+}
+
+void LocalFilesModel::fetchMore( const QModelIndex &parent )
+{
+  if ( parent.isValid() || !mGatherer )
+    return;
+
+  mGatherer->fetchMore( GATHERER_FETCH_LIMIT );
+}
+
 int LocalFilesModel::rowCount( const QModelIndex &parent ) const
 {
   if ( !parent.isValid() )
@@ -292,3 +427,101 @@ QVariant LocalFilesModel::data( const QModelIndex &index, int role ) const
 
   return QVariant();
 }
+
+LocalFilesGatherer::LocalFilesGatherer( const QString &path, int fetchLimit )
+  : mPath( path )
+  , mLastModified( QFileInfo( path ).lastModified() )
+  , mFetchLimit( fetchLimit )
+{
+}
+
+void LocalFilesGatherer::run()
+{
+  QDirIterator it( mPath, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot );
+  QList<LocalFilesModel::Item> items;
+  QElapsedTimer timer;
+  timer.start();
+  while ( it.hasNext() )
+  {
+    it.next();
+
+    LocalFilesModel::Item item;
+    if ( LocalFilesModel::itemFromFileInfo( it.fileInfo(), item ) )
+    {
+      items << item;
+    }
+
+    if ( items.size() >= GATHERER_BATCH_SIZE || timer.elapsed() >= GATHERER_BATCH_INTERVAL )
+    {
+      publishItems( items );
+      timer.restart();
+    }
+
+    QMutexLocker locker( &mMutex );
+    if ( mFetchedCount >= mFetchLimit && !mWasCanceled )
+    {
+      locker.unlock();
+      publishItems( items );
+      locker.relock();
+
+      while ( mFetchedCount >= mFetchLimit && !mWasCanceled )
+      {
+        mFetchCondition.wait( &mMutex );
+      }
+    }
+
+    if ( mWasCanceled )
+      return;
+  }
+
+  publishItems( items );
+}
+
+void LocalFilesGatherer::publishItems( QList<LocalFilesModel::Item> &items )
+{
+  if ( items.isEmpty() )
+    return;
+
+  {
+    QMutexLocker locker( &mMutex );
+    mItems << items;
+    mFetchedCount += items.size();
+  }
+  items.clear();
+
+  emit itemsAvailable();
+}
+
+void LocalFilesGatherer::stop()
+{
+  QMutexLocker locker( &mMutex );
+  mWasCanceled = true;
+  mFetchCondition.wakeAll();
+}
+
+bool LocalFilesGatherer::wasCanceled() const
+{
+  QMutexLocker locker( &mMutex );
+  return mWasCanceled;
+}
+
+bool LocalFilesGatherer::hasReachedFetchLimit() const
+{
+  QMutexLocker locker( &mMutex );
+  return mFetchedCount >= mFetchLimit;
+}
+
+void LocalFilesGatherer::fetchMore( int count )
+{
+  QMutexLocker locker( &mMutex );
+  mFetchLimit += count;
+  mFetchCondition.wakeAll();
+}
+
+QList<LocalFilesModel::Item> LocalFilesGatherer::takeItems()
+{
+  QMutexLocker locker( &mMutex );
+  QList<LocalFilesModel::Item> items;
+  items.swap( mItems );
+  return items;
+}
@@ -17,9 +17,18 @@
 #define LOCALFILESMODEL_H
 
 #include <QAbstractListModel>
+#include <QCache>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutex>
+#include <QPointer>
+#include <QThread>
+#include <QWaitCondition>
 
 #define SUPPORTED_DATASET_THUMBNAIL QStringList( { QStringLiteral( "zip" ), QStringLiteral( "tif" ), QStringLiteral( "tiff" ), QStringLiteral( "pdf" ), QStringLiteral( "jpg" ), QStringLiteral( "jpeg" ), QStringLiteral( "png" ), QStringLiteral( "jp2" ), QStringLiteral( "webp" ) } )
 
+class LocalFilesGatherer;
+
 class LocalFilesModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -28,6 +37,7 @@ class LocalFilesModel : public QAbstractListModel
     Q_PROPERTY( QString currentPath READ currentPath WRITE setCurrentPath NOTIFY currentPathChanged )
     Q_PROPERTY( int currentDepth READ currentDepth NOTIFY currentPathChanged )
     Q_PROPERTY( bool isDeletedAllowedInCurrentPath READ isDeletedAllowedInCurrentPath NOTIFY currentPathChanged )
+    Q_PROPERTY( bool isLoading READ isLoading NOTIFY isLoadingChanged )
 
   public:
     enum ItemMetaType
@@ -85,12 +95,16 @@ class LocalFilesModel : public QAbstractListModel
 
 
     explicit LocalFilesModel( QObject *parent = nullptr );
+    ~LocalFilesModel();
 
     QHash<int, QByteArray> roleNames() const override;
 
     int rowCount( const QModelIndex &parent ) const override;
     QVariant data( const QModelIndex &index, int role ) const override;
 
+    bool canFetchMore( const QModelIndex &parent ) const override;
+    void fetchMore( const QModelIndex &parent ) override;
+
     //! Resets the model and sets the first navigation history item to root
     Q_INVOKABLE void resetToRoot();
 
@@ -118,16 +132,101 @@ class LocalFilesModel : public QAbstractListModel
     //! Walks the navigation history back up on step
     Q_INVOKABLE void moveUp();
 
+    //! Returns TRUE while the current path is being scanned
+    bool isLoading() const;
+
+    /**
+     * Returns a model item for the provided file info, or FALSE if the file is not
+     * a folder, project, or dataset supported by QField
+     */
+    static bool itemFromFileInfo( const QFileInfo &fi, Item &item );
+
   signals:
 
     void currentPathChanged();
+    void isLoadingChanged();
+
+  private slots:
+    void processGatheredItems();
+    void gathererFinished();
 
   private:
+    //! Listing of a directory, valid as long as the directory modification time is unchanged
+    struct DirectoryListing
+    {
+        QDateTime lastModified;
+        QList<Item> items;
+    };
+
     void reloadModel();
+    void cleanupGatherer();
+    static bool itemLessThan( const Item &item1, const Item &item2 );
     const QString getCurrentTitleFromPath( const QString &path ) const;
 
     QStringList mHistory;
     QList<Item> mItems;
+
+    QPointer<LocalFilesGatherer> mGatherer;
+    QCache<QString, DirectoryListing> mListingsCache;
+};
+
+/**
+ * \class LocalFilesGatherer
+ * Scans a directory for items supported by the local files model.
+ * Items are handed over in batches, and the scan pauses once a fetch limit is
+ * reached until more items are requested.
+ */
+class LocalFilesGatherer : public QThread
+{
+    Q_OBJECT
+
+  public:
+    /**
+     * Constructor
+     * \param path the directory to scan
+     * \param fetchLimit the number of items to gather before pausing the scan
+     */
+    explicit LocalFilesGatherer( const QString &path, int fetchLimit );
+
+    void run() override;
+
+    //! Informs the gatherer to immediately stop scanning
+    void stop();
+
+    //! Returns TRUE if the scan was canceled before completion
+    bool wasCanceled() const;
+
+    //! Returns TRUE if the scan has gathered as many items as its fetch limit and is pausing
+    bool hasReachedFetchLimit() const;
+
+    //! Raises the fetch limit by \a count items, resuming a paused scan
+    void fetchMore( int count );
+
+    //! Returns and clears items gathered since the last call
+    QList<LocalFilesModel::Item> takeItems();
+
+    //! Returns the scanned directory path
+    QString path() const { return mPath; }
+
+    //! Returns the modification time of the scanned directory at the time the scan started
+    QDateTime lastModified() const { return mLastModified; }
+
+  signals:
+    //! Emitted when a batch of gathered items is ready to be taken
+    void itemsAvailable();
+
+  private:
+    void publishItems( QList<LocalFilesModel::Item> &items );
+
+    QString mPath;
+    QDateTime mLastModified;
+
+    mutable QMutex mMutex;
+    QWaitCondition mFetchCondition;
+    QList<LocalFilesModel::Item> mItems;
+    int mFetchLimit = 0;
+    int mFetchedCount = 0;
+    bool mWasCanceled = false;
 };
 
 #endif // LOCALFILESMODEL_H
@@ -16,11 +16,15 @@
 
 #include "featurelistextentcontroller.h"
 #include "featureslocatorfilter.h"
+#include "featureslocatorindex.h"
 #include "locatormodelsuperbridge.h"
 #include "qgsgeometrywrapper.h"
 #include "qgsquickmapsettings.h"
+#include "stringutils.h"
 
 #include <QAction>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
 #include <qgsexpressioncontextutils.h>
 #include <qgsfeedback.h>
 #include <qgsmaplayermodel.h>
@@ -28,7 +32,11 @@
 #include <qgsvectorlayer.h>
 
 #include <math.h>
+#include <queue>
 
+#define FEATURES_LOCATOR_MAX_THREADS 4
+#define FEATURES_LOCATOR_MIN_SCORE 0.05
+#define FEATURES_LOCATOR_STABLE_SCORE 0.75
 
 FeaturesLocatorFilter::FeaturesLocatorFilter( LocatorModelSuperBridge *locatorBridge, QObject *parent )
   : QgsLocatorFilter( parent )
@@ -50,6 +58,7 @@ QStringList FeaturesLocatorFilter::prepare( const QString &string, const QgsLoca
     return QStringList();
 
   mPreparedLayers.clear();
+  FeaturesLocatorIndex *index = mLocatorBridge->featuresLocatorIndex();
   const QMap<QString, QgsMapLayer *> layers = QgsProject::instance()->mapLayers();
   for ( auto it = layers.constBegin(); it != layers.constEnd(); ++it )
   {
@@ -57,6 +66,20 @@ QStringList FeaturesLocatorFilter::prepare( const QString &string, const QgsLoca
     if ( !layer || !layer->dataProvider() || !layer->flags().testFlag( QgsMapLayer::Searchable ) )
       continue;
 
+    std::shared_ptr<PreparedLayer> preparedLayer( new PreparedLayer() );
+    preparedLayer->layerId = layer->id();
+    preparedLayer->layerName = layer->name();
+    preparedLayer->layerIcon = QgsMapLayerModel::iconForLayer( layer );
+    preparedLayer->layerGeometryType = layer->geometryType();
+
+    // indexed layers are searched without touching their provider
+    if ( index && index->isLayerIndexed( layer->id() ) )
+    {
+      preparedLayer->indexed = true;
+      mPreparedLayers.append( preparedLayer );
+      continue;
+    }
+
     QgsExpression expression( layer->displayExpression() );
     QgsExpressionContext expressionContext;
     expressionContext.appendScopes( QgsExpressionContextUtils::globalProjectLayerScopes( layer ) );
@@ -73,15 +96,10 @@ QStringList FeaturesLocatorFilter::prepare( const QString &string, const QgsLoca
                                .arg( enhancedSearch ) );
     req.setLimit( 30 );
 
-    std::shared_ptr<PreparedLayer> preparedLayer( new PreparedLayer() );
     preparedLayer->expression = expression;
     preparedLayer->context = expressionContext;
-    preparedLayer->layerId = layer->id();
-    preparedLayer->layerName = layer->name();
     preparedLayer->featureSource.reset( new QgsVectorLayerFeatureSource( layer ) );
     preparedLayer->request = req;
-    preparedLayer->layerIcon = QgsMapLayerModel::iconForLayer( layer );
-    preparedLayer->layerGeometryType = layer->geometryType();
 
     mPreparedLayers.append( preparedLayer );
   }
@@ -91,45 +109,121 @@ QStringList FeaturesLocatorFilter::prepare( const QString &string, const QgsLoca
 
 void FeaturesLocatorFilter::fetchResults( const QString &string, const QgsLocatorContext &, QgsFeedback *feedback )
 {
-  int foundInTotal = 0;
-  QgsFeature f;
+  // shared by the layer queries, canceled along with the search or once the top results are settled
+  QgsFeedback layersFeedback;
+  connect( feedback, &QgsFeedback::canceled, &layersFeedback, &QgsFeedback::cancel, Qt::DirectConnection );
+  if ( feedback->isCanceled() )
+    return;
 
-  // we cannot used const loop since iterator::nextFeature is not const
-  for ( auto preparedLayer : std::as_const( mPreparedLayers ) )
+  QStringList indexedLayerIds;
+  for ( const std::shared_ptr<PreparedLayer> &preparedLayer : std::as_const( mPreparedLayers ) )
   {
-    int foundInCurrentLayer = 0;
-    QgsFeatureIterator it = preparedLayer->featureSource->getFeatures( preparedLayer->request );
-    while ( it.nextFeature( f ) )
-    {
-      if ( feedback->isCanceled() )
-        return;
+    if ( preparedLayer->indexed )
+      indexedLayerIds << preparedLayer->layerId;
+  }
 
-      QgsLocatorResult result;
-      result.group = preparedLayer->layerName;
+  // the provider bound layers are queried concurrently, the slowest one no longer holds the others back
+  QThreadPool pool;
+  pool.setMaxThreadCount( std::min( FEATURES_LOCATOR_MAX_THREADS, std::max( 1, QThread::idealThreadCount() ) ) );
+  QHash<QString, QFuture<QList<QgsLocatorResult>>> layerFutures;
+  for ( const std::shared_ptr<PreparedLayer> &preparedLayer : std::as_const( mPreparedLayers ) )
+  {
+    if ( preparedLayer->indexed )
+      continue;
 
-      preparedLayer->context.setFeature( f );
+    PreparedLayer *layer = preparedLayer.get();
+    layerFutures.insert( layer->layerId, QtConcurrent::run( &pool, [this, layer, &string, &layersFeedback]() {
+                           return fetchLayerResults( layer, string, &layersFeedback );
+                         } ) );
+  }
+
+  QHash<QString, QList<FeaturesLocatorIndex::Match>> indexMatches;
+  if ( !indexedLayerIds.isEmpty() )
+    indexMatches = mLocatorBridge->featuresLocatorIndex()->search( string, indexedLayerIds, mMaxResultsPerLayer );
 
-      result.displayString = preparedLayer->expression.evaluate( &( preparedLayer->context ) ).toString();
+  // results are emitted in the layers order as soon as each layer is done, as long as they make it into the
+  // top results; the search stops once the top results are all prefix matches as they can hardly be outranked
+  std::priority_queue<double, std::vector<double>, std::greater<double>> topScores;
+  for ( const std::shared_ptr<PreparedLayer> &preparedLayer : std::as_const( mPreparedLayers ) )
+  {
+    if ( layersFeedback.isCanceled() )
+      break;
 
-      result.userData = QVariantList() << f.id() << preparedLayer->layerId;
-      result.icon = preparedLayer->layerIcon;
-      result.score = static_cast<double>( string.length() ) / result.displayString.size();
-      result.actions << QgsLocatorResult::ResultAction( OpenForm, tr( "Open form" ), QStringLiteral( "ic_baseline-list_alt-24px" ) );
-      if ( preparedLayer->layerGeometryType != QgsWkbTypes::NullGeometry && preparedLayer->layerGeometryType != QgsWkbTypes::UnknownGeometry )
+    QList<QgsLocatorResult> results;
+    if ( preparedLayer->indexed )
+    {
+      const QList<FeaturesLocatorIndex::Match> matches = indexMatches.value( preparedLayer->layerId );
+      for ( const FeaturesLocatorIndex::Match &match : matches )
+        results << layerResult( preparedLayer.get(), match.featureId, match.displayString, string );
+    }
+    else
+    {
+      results = layerFutures.value( preparedLayer->layerId ).result();
+    }
+
+    for ( const QgsLocatorResult &result : std::as_const( results ) )
+    {
+      if ( static_cast<int>( topScores.size() ) >= mMaxTotalResults )
       {
-        result.actions << QgsLocatorResult::ResultAction( Navigation, tr( "Set feature as destination" ), QStringLiteral( "ic_navigation_flag_purple_24dp" ) );
+        if ( result.score <= topScores.top() )
+          continue;
+        topScores.pop();
       }
 
+      topScores.push( result.score );
       emit resultFetched( result );
+    }
 
-      foundInCurrentLayer++;
-      foundInTotal++;
-      if ( foundInCurrentLayer >= mMaxResultsPerLayer )
-        break;
+    if ( static_cast<int>( topScores.size() ) >= mMaxTotalResults && topScores.top() >= FEATURES_LOCATOR_STABLE_SCORE )
+    {
+      layersFeedback.cancel();
+      break;
     }
-    if ( foundInTotal >= mMaxTotalResults )
+  }
+
+  pool.waitForDone();
+}
+
+QList<QgsLocatorResult> FeaturesLocatorFilter::fetchLayerResults( PreparedLayer *preparedLayer, const QString &string, QgsFeedback *feedback ) const
+{
+  QList<QgsLocatorResult> results;
+
+  QgsFeatureRequest request = preparedLayer->request;
+  request.setFeedback( feedback );
+
+  QgsFeature f;
+  QgsFeatureIterator it = preparedLayer->featureSource->getFeatures( request );
+  while ( it.nextFeature( f ) )
+  {
+    if ( feedback->isCanceled() )
+      break;
+
+    preparedLayer->context.setFeature( f );
+    const QString displayString = preparedLayer->expression.evaluate( &( preparedLayer->context ) ).toString();
+    results << layerResult( preparedLayer, f.id(), displayString, string );
+
+    if ( results.size() >= mMaxResultsPerLayer )
       break;
   }
+
+  return results;
+}
+
+QgsLocatorResult FeaturesLocatorFilter::layerResult( const PreparedLayer *preparedLayer, QgsFeatureId featureId, const QString &displayString, const QString &string ) const
+{
+  QgsLocatorResult result;
+  result.group = preparedLayer->layerName;
+  result.displayString = displayString;
+  result.userData = QVariantList() << featureId << preparedLayer->layerId;
+  result.icon = preparedLayer->layerIcon;
+  // features matched by the provider or the index beyond the fuzzy match, e.g. ignoring diacritics, come last
+  result.score = std::max( StringUtils::fuzzyMatchScore( displayString, string ), FEATURES_LOCATOR_MIN_SCORE );
+  result.actions << QgsLocatorResult::ResultAction( OpenForm, tr( "Open form" ), QStringLiteral( "ic_baseline-list_alt-24px" ) );
+  if ( preparedLayer->layerGeometryType != QgsWkbTypes::NullGeometry && preparedLayer->layerGeometryType != QgsWkbTypes::UnknownGeometry )
+  {
+    result.actions << QgsLocatorResult::ResultAction( Navigation, tr( "Set feature as destination" ), QStringLiteral( "ic_navigation_flag_purple_24dp" ) );
+  }
+  return result;
 }
 
 void FeaturesLocatorFilter::triggerResult( const QgsLocatorResult &result )
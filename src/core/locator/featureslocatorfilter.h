@@ -55,6 +55,8 @@ class FeaturesLocatorFilter : public QgsLocatorFilter
         QString layerId;
         QIcon layerIcon;
         QgsWkbTypes::GeometryType layerGeometryType;
+        //! Whether the layer is searched through the features index rather than through its provider
+        bool indexed = false;
     };
 
     explicit FeaturesLocatorFilter( LocatorModelSuperBridge *locatorBridge, QObject *parent = nullptr );
@@ -70,6 +72,9 @@ class FeaturesLocatorFilter : public QgsLocatorFilter
     void triggerResultFromAction( const QgsLocatorResult &result, const int actionId ) override;
 
   private:
+    QgsLocatorResult layerResult( const PreparedLayer *preparedLayer, QgsFeatureId featureId, const QString &displayString, const QString &string ) const;
+    QList<QgsLocatorResult> fetchLayerResults( PreparedLayer *preparedLayer, const QString &string, QgsFeedback *feedback ) const;
+
     int mMaxResultsPerLayer = 12;
     int mMaxTotalResults = 16;
     QList<std::shared_ptr<PreparedLayer>> mPreparedLayers;
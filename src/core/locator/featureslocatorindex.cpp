@@ -0,0 +1,614 @@
+/***************************************************************************
+  featureslocatorindex.cpp
+
+ ---------------------
+ begin                : October 2026
+ copyright            : (C) 2026 by OPENGIS.ch
+ email                : info at opengis dot ch
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "featureslocatorindex.h"
+#include "platformutilities.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <qgsexpressioncontextutils.h>
+#include <qgsmessagelog.h>
+#include <qgsproject.h>
+#include <qgsproviderregistry.h>
+#include <qgssqliteutils.h>
+#include <qgsvectorlayer.h>
+
+#include <sqlite3.h>
+
+#define FEATURES_LOCATOR_INDEX_BUSY_TIMEOUT 5000
+#define FEATURES_LOCATOR_INDEX_UPDATE_DELAY 500
+
+namespace
+{
+  const QString sIndexSchema = QStringLiteral( "PRAGMA journal_mode = WAL;"
+                                               "CREATE TABLE IF NOT EXISTS layers ( layer_id TEXT PRIMARY KEY, signature TEXT NOT NULL );"
+                                               "CREATE TABLE IF NOT EXISTS entries ( id INTEGER PRIMARY KEY, layer_id TEXT NOT NULL, fid INTEGER NOT NULL );"
+                                               "CREATE INDEX IF NOT EXISTS entries_layer_fid ON entries ( layer_id, fid );"
+                                               "CREATE VIRTUAL TABLE IF NOT EXISTS features USING fts5( display_text, tokenize = 'unicode61 remove_diacritics 2' );" );
+
+  void bindText( sqlite3_statement_unique_ptr &statement, int index, const QString &value )
+  {
+    const QByteArray utf8 = value.toUtf8();
+    sqlite3_bind_text( statement.get(), index, utf8.constData(), utf8.size(), SQLITE_TRANSIENT );
+  }
+
+  bool stepAndReset( sqlite3_statement_unique_ptr &statement )
+  {
+    const int result = statement.step();
+    sqlite3_reset( statement.get() );
+    sqlite3_clear_bindings( statement.get() );
+    return result == SQLITE_DONE || result == SQLITE_ROW;
+  }
+
+  //! Writes layers and their features to the index, each write has to be part of a transaction started by the caller
+  class IndexWriter
+  {
+    public:
+      explicit IndexWriter( sqlite3_database_unique_ptr &database )
+        : mDatabase( database )
+      {
+        int result = SQLITE_OK;
+        mRemoveLayerFeatures = mDatabase.prepare( QStringLiteral( "DELETE FROM features WHERE rowid IN ( SELECT id FROM entries WHERE layer_id = ?1 )" ), result );
+        mRemoveLayerEntries = mDatabase.prepare( QStringLiteral( "DELETE FROM entries WHERE layer_id = ?1" ), result );
+        mRemoveLayer = mDatabase.prepare( QStringLiteral( "DELETE FROM layers WHERE layer_id = ?1" ), result );
+        mRemoveFeature = mDatabase.prepare( QStringLiteral( "DELETE FROM features WHERE rowid IN ( SELECT id FROM entries WHERE layer_id = ?1 AND fid = ?2 )" ), result );
+        mRemoveEntry = mDatabase.prepare( QStringLiteral( "DELETE FROM entries WHERE layer_id = ?1 AND fid = ?2" ), result );
+        mAddEntry = mDatabase.prepare( QStringLiteral( "INSERT INTO entries ( layer_id, fid ) VALUES ( ?1, ?2 )" ), result );
+        mAddFeature = mDatabase.prepare( QStringLiteral( "INSERT INTO features ( rowid, display_text ) VALUES ( last_insert_rowid(), ?1 )" ), result );
+        mSetSignature = mDatabase.prepare( QStringLiteral( "INSERT OR REPLACE INTO layers ( layer_id, signature ) VALUES ( ?1, ?2 )" ), result );
+      }
+
+      bool removeLayer( const QString &layerId )
+      {
+        bindText( mRemoveLayerFeatures, 1, layerId );
+        bindText( mRemoveLayerEntries, 1, layerId );
+        bindText( mRemoveLayer, 1, layerId );
+        return stepAndReset( mRemoveLayerFeatures ) && stepAndReset( mRemoveLayerEntries ) && stepAndReset( mRemoveLayer );
+      }
+
+      bool removeFeature( const QString &layerId, QgsFeatureId featureId )
+      {
+        bindText( mRemoveFeature, 1, layerId );
+        sqlite3_bind_int64( mRemoveFeature.get(), 2, featureId );
+        bindText( mRemoveEntry, 1, layerId );
+        sqlite3_bind_int64( mRemoveEntry.get(), 2, featureId );
+        return stepAndReset( mRemoveFeature ) && stepAndReset( mRemoveEntry );
+      }
+
+      bool addFeature( const QString &layerId, QgsFeatureId featureId, const QString &displayString )
+      {
+        bindText( mAddEntry, 1, layerId );
+        sqlite3_bind_int64( mAddEntry.get(), 2, featureId );
+        bindText( mAddFeature, 1, displayString );
+        return stepAndReset( mAddEntry ) && stepAndReset( mAddFeature );
+      }
+
+      bool setSignature( const QString &layerId, const QString &signature )
+      {
+        bindText( mSetSignature, 1, layerId );
+        bindText( mSetSignature, 2, signature );
+        return stepAndReset( mSetSignature );
+      }
+
+      bool begin()
+      {
+        QString error;
+        return mDatabase.exec( QStringLiteral( "BEGIN IMMEDIATE" ), error ) == SQLITE_OK;
+      }
+
+      bool commit()
+      {
+        QString error;
+        if ( mDatabase.exec( QStringLiteral( "COMMIT" ), error ) == SQLITE_OK )
+          return true;
+
+        QgsMessageLog::logMessage( QObject::tr( "Failed to write to the features search index: %1" ).arg( error ), QStringLiteral( "QField" ) );
+        rollback();
+        return false;
+      }
+
+      void rollback()
+      {
+        QString error;
+        mDatabase.exec( QStringLiteral( "ROLLBACK" ), error );
+      }
+
+    private:
+      sqlite3_database_unique_ptr &mDatabase;
+      sqlite3_statement_unique_ptr mRemoveLayerFeatures;
+      sqlite3_statement_unique_ptr mRemoveLayerEntries;
+      sqlite3_statement_unique_ptr mRemoveLayer;
+      sqlite3_statement_unique_ptr mRemoveFeature;
+      sqlite3_statement_unique_ptr mRemoveEntry;
+      sqlite3_statement_unique_ptr mAddEntry;
+      sqlite3_statement_unique_ptr mAddFeature;
+      sqlite3_statement_unique_ptr mSetSignature;
+  };
+} // namespace
+
+
+FeaturesLocatorIndexBuilder::FeaturesLocatorIndexBuilder( const QString &databasePath, std::vector<std::unique_ptr<LayerSource>> &&layerSources, const QSet<QString> &projectLayerIds )
+  : mDatabasePath( databasePath )
+  , mLayerSources( std::move( layerSources ) )
+  , mProjectLayerIds( projectLayerIds )
+{
+}
+
+FeaturesLocatorIndexBuilder::~FeaturesLocatorIndexBuilder()
+{
+  requestInterruption();
+  wait();
+}
+
+void FeaturesLocatorIndexBuilder::run()
+{
+  sqlite3_database_unique_ptr database;
+  if ( database.open( mDatabasePath ) != SQLITE_OK )
+  {
+    QgsMessageLog::logMessage( tr( "Failed to open the features search index `%1`: %2" ).arg( mDatabasePath, database.errorMessage() ), QStringLiteral( "QField" ) );
+    return;
+  }
+  sqlite3_busy_timeout( database.get(), FEATURES_LOCATOR_INDEX_BUSY_TIMEOUT );
+
+  // drop the layers which are no longer part of the project
+  QStringList staleLayerIds;
+  int result = SQLITE_OK;
+  sqlite3_statement_unique_ptr statement = database.prepare( QStringLiteral( "SELECT layer_id FROM layers" ), result );
+  while ( result == SQLITE_OK && statement.step() == SQLITE_ROW )
+  {
+    const QString layerId = statement.columnAsText( 0 );
+    if ( !mProjectLayerIds.contains( layerId ) )
+      staleLayerIds << layerId;
+  }
+  statement.reset();
+
+  if ( !staleLayerIds.isEmpty() )
+  {
+    IndexWriter writer( database );
+    if ( writer.begin() )
+    {
+      for ( const QString &layerId : std::as_const( staleLayerIds ) )
+        writer.removeLayer( layerId );
+      writer.commit();
+    }
+  }
+
+  for ( const std::unique_ptr<LayerSource> &layerSource : mLayerSources )
+  {
+    if ( isInterruptionRequested() )
+      break;
+
+    if ( indexLayer( layerSource.get(), database ) )
+      emit layerIndexed( layerSource->layerId );
+  }
+}
+
+bool FeaturesLocatorIndexBuilder::indexLayer( LayerSource *layerSource, sqlite3_database_unique_ptr &database )
+{
+  IndexWriter writer( database );
+  if ( !writer.begin() )
+    return false;
+
+  if ( !writer.removeLayer( layerSource->layerId ) )
+  {
+    writer.rollback();
+    return false;
+  }
+
+  QgsFeature feature;
+  QgsFeatureIterator it = layerSource->featureSource->getFeatures( layerSource->request );
+  while ( it.nextFeature( feature ) )
+  {
+    if ( isInterruptionRequested() )
+    {
+      writer.rollback();
+      return false;
+    }
+
+    layerSource->context.setFeature( feature );
+    const QString displayString = layerSource->expression.evaluate( &layerSource->context ).toString();
+    if ( displayString.isEmpty() )
+      continue;
+
+    if ( !writer.addFeature( layerSource->layerId, feature.id(), displayString ) )
+    {
+      writer.rollback();
+      return false;
+    }
+  }
+
+  writer.setSignature( layerSource->layerId, layerSource->signature );
+  return writer.commit();
+}
+
+
+FeaturesLocatorIndex::FeaturesLocatorIndex( QObject *parent )
+  : QObject( parent )
+{
+  mUpdateTimer.setSingleShot( true );
+  mUpdateTimer.setInterval( FEATURES_LOCATOR_INDEX_UPDATE_DELAY );
+  connect( &mUpdateTimer, &QTimer::timeout, this, &FeaturesLocatorIndex::applyUpdates );
+
+  connect( QgsProject::instance(), &QgsProject::readProject, this, &FeaturesLocatorIndex::projectRead );
+  connect( QgsProject::instance(), &QgsProject::cleared, this, &FeaturesLocatorIndex::projectCleared );
+  connect( QgsProject::instance(), &QgsProject::layersAdded, this, &FeaturesLocatorIndex::layersAdded );
+  connect( QgsProject::instance(), qOverload<const QString &>( &QgsProject::layerWillBeRemoved ), this, &FeaturesLocatorIndex::layerWillBeRemoved );
+}
+
+FeaturesLocatorIndex::~FeaturesLocatorIndex()
+{
+  stopBuilder();
+}
+
+bool FeaturesLocatorIndex::isEnabled() const
+{
+  return mEnabled;
+}
+
+void FeaturesLocatorIndex::setEnabled( bool enabled )
+{
+  if ( mEnabled == enabled )
+    return;
+
+  mEnabled = enabled;
+
+  if ( mEnabled )
+    projectRead();
+  else
+    projectCleared();
+}
+
+bool FeaturesLocatorIndex::isLayerIndexed( const QString &layerId ) const
+{
+  QMutexLocker locker( &mMutex );
+  return mIndexedLayers.contains( layerId );
+}
+
+QHash<QString, QList<FeaturesLocatorIndex::Match>> FeaturesLocatorIndex::search( const QString &string, const QStringList &layerIds, int limitPerLayer ) const
+{
+  QHash<QString, QList<Match>> matches;
+
+  QString databasePath;
+  {
+    QMutexLocker locker( &mMutex );
+    databasePath = mDatabasePath;
+  }
+
+  // every word has to prefix a token of the display string
+  QStringList terms;
+  const QStringList words = string.split( QRegularExpression( QStringLiteral( "\\s+" ) ), Qt::SkipEmptyParts );
+  for ( QString word : words )
+    terms << QStringLiteral( "\"%1\"*" ).arg( word.replace( '"', QStringLiteral( "\"\"" ) ) );
+
+  if ( databasePath.isEmpty() || terms.isEmpty() || layerIds.isEmpty() )
+    return matches;
+
+  sqlite3_database_unique_ptr database;
+  if ( database.open_v2( databasePath, SQLITE_OPEN_READONLY, nullptr ) != SQLITE_OK )
+    return matches;
+  sqlite3_busy_timeout( database.get(), FEATURES_LOCATOR_INDEX_BUSY_TIMEOUT );
+
+  int result = SQLITE_OK;
+  sqlite3_statement_unique_ptr statement = database.prepare( QStringLiteral( "SELECT entries.fid, features.display_text FROM features "
+                                                                             "JOIN entries ON entries.id = features.rowid "
+                                                                             "WHERE features MATCH ?1 AND entries.layer_id = ?2 "
+                                                                             "ORDER BY features.rank LIMIT ?3" ),
+                                                             result );
+  if ( result != SQLITE_OK )
+    return matches;
+
+  const QString query = terms.join( ' ' );
+  for ( const QString &layerId : layerIds )
+  {
+    bindText( statement, 1, query );
+    bindText( statement, 2, layerId );
+    sqlite3_bind_int( statement.get(), 3, limitPerLayer );
+
+    QList<Match> &layerMatches = matches[layerId];
+    while ( statement.step() == SQLITE_ROW )
+    {
+      Match match;
+      match.featureId = statement.columnAsInt64( 0 );
+      match.displayString = statement.columnAsText( 1 );
+      layerMatches << match;
+    }
+
+    sqlite3_reset( statement.get() );
+  }
+
+  return matches;
+}
+
+void FeaturesLocatorIndex::projectRead()
+{
+  projectCleared();
+
+  const QString projectFilePath = QgsProject::instance()->fileName();
+  if ( !mEnabled || projectFilePath.isEmpty() )
+    return;
+
+  const QString databaseDirectory = PlatformUtilities::instance()->systemLocalDataLocation( QStringLiteral( "locator_index" ) );
+  const QString databasePath = QStringLiteral( "%1/%2.db" ).arg( databaseDirectory, QCryptographicHash::hash( QFileInfo( projectFilePath ).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1 ).toHex() );
+  QDir().mkpath( databaseDirectory );
+
+  sqlite3_database_unique_ptr database;
+  if ( database.open( databasePath ) != SQLITE_OK )
+  {
+    QgsMessageLog::logMessage( tr( "Failed to open the features search index `%1`: %2" ).arg( databasePath, database.errorMessage() ), QStringLiteral( "QField" ) );
+    return;
+  }
+
+  // fails if SQLite was built without FTS5, searches then go through the layers
+  QString error;
+  if ( database.exec( sIndexSchema, error ) != SQLITE_OK )
+  {
+    QgsMessageLog::logMessage( tr( "The features search index is not available: %1" ).arg( error ), QStringLiteral( "QField" ) );
+    return;
+  }
+
+  int result = SQLITE_OK;
+  sqlite3_statement_unique_ptr statement = database.prepare( QStringLiteral( "SELECT layer_id, signature FROM layers" ), result );
+  while ( result == SQLITE_OK && statement.step() == SQLITE_ROW )
+    mIndexedSignatures.insert( statement.columnAsText( 0 ), statement.columnAsText( 1 ) );
+
+  {
+    QMutexLocker locker( &mMutex );
+    mDatabasePath = databasePath;
+  }
+
+  layersAdded( QgsProject::instance()->mapLayers().values() );
+}
+
+void FeaturesLocatorIndex::projectCleared()
+{
+  stopBuilder();
+  mUpdateTimer.stop();
+
+  {
+    QMutexLocker locker( &mMutex );
+    mDatabasePath.clear();
+    mIndexedLayers.clear();
+  }
+
+  mIndexedSignatures.clear();
+  mLayersToIndex.clear();
+  mPendingUpdates.clear();
+}
+
+void FeaturesLocatorIndex::layersAdded( const QList<QgsMapLayer *> &layers )
+{
+  // layers added while reading the project are handled once it is read
+  if ( mDatabasePath.isEmpty() )
+    return;
+
+  for ( QgsMapLayer *mapLayer : layers )
+  {
+    QgsVectorLayer *layer = qobject_cast<QgsVectorLayer *>( mapLayer );
+    if ( !isIndexable( layer ) )
+      continue;
+
+    watchLayer( layer );
+
+    if ( mIndexedSignatures.value( layer->id() ) == layerSignature( layer ) )
+    {
+      QMutexLocker locker( &mMutex );
+      mIndexedLayers << layer->id();
+    }
+    else
+    {
+      mLayersToIndex << layer->id();
+    }
+  }
+
+  startBuilder();
+}
+
+void FeaturesLocatorIndex::layerWillBeRemoved( const QString &layerId )
+{
+  {
+    QMutexLocker locker( &mMutex );
+    mIndexedLayers.remove( layerId );
+  }
+
+  mLayersToIndex.remove( layerId );
+  mPendingUpdates.remove( layerId );
+}
+
+void FeaturesLocatorIndex::watchLayer( QgsVectorLayer *layer )
+{
+  disconnect( layer, nullptr, this, nullptr );
+
+  connect( layer, &QgsVectorLayer::committedFeaturesAdded, this, [=]( const QString &layerId, const QgsFeatureList &features ) {
+    QgsFeatureIds featureIds;
+    for ( const QgsFeature &feature : features )
+      featureIds << feature.id();
+    scheduleUpdate( layerId, featureIds );
+  } );
+  connect( layer, &QgsVectorLayer::committedFeaturesRemoved, this, &FeaturesLocatorIndex::scheduleUpdate );
+  connect( layer, &QgsVectorLayer::committedAttributeValuesChanges, this, [=]( const QString &layerId, const QgsChangedAttributesMap &changedAttributesValues ) {
+    scheduleUpdate( layerId, qgis::listToSet( changedAttributesValues.keys() ) );
+  } );
+  connect( layer, &QgsVectorLayer::committedGeometriesChanges, this, [=]( const QString &layerId, const QgsGeometryMap &changedGeometries ) {
+    if ( QgsExpression( layer->displayExpression() ).needsGeometry() )
+      scheduleUpdate( layerId, qgis::listToSet( changedGeometries.keys() ) );
+  } );
+  connect( layer, &QgsVectorLayer::displayExpressionChanged, this, [=]() {
+    {
+      QMutexLocker locker( &mMutex );
+      mIndexedLayers.remove( layer->id() );
+    }
+    mPendingUpdates.remove( layer->id() );
+    mLayersToIndex << layer->id();
+    startBuilder();
+  } );
+}
+
+void FeaturesLocatorIndex::scheduleUpdate( const QString &layerId, const QgsFeatureIds &featureIds )
+{
+  if ( featureIds.isEmpty() )
+    return;
+
+  mPendingUpdates[layerId].unite( featureIds );
+  mUpdateTimer.start();
+}
+
+void FeaturesLocatorIndex::applyUpdates()
+{
+  // the builder has the database locked for writing, updates are applied once it is done
+  if ( mBuilder || mPendingUpdates.isEmpty() || mDatabasePath.isEmpty() )
+    return;
+
+  sqlite3_database_unique_ptr database;
+  if ( database.open( mDatabasePath ) != SQLITE_OK )
+    return;
+  sqlite3_busy_timeout( database.get(), FEATURES_LOCATOR_INDEX_BUSY_TIMEOUT );
+
+  IndexWriter writer( database );
+  if ( !writer.begin() )
+    return;
+
+  for ( auto it = mPendingUpdates.constBegin(); it != mPendingUpdates.constEnd(); ++it )
+  {
+    QgsVectorLayer *layer = qobject_cast<QgsVectorLayer *>( QgsProject::instance()->mapLayer( it.key() ) );
+    if ( !layer || !isLayerIndexed( it.key() ) )
+      continue;
+
+    for ( const QgsFeatureId featureId : it.value() )
+      writer.removeFeature( layer->id(), featureId );
+
+    QgsExpression expression( layer->displayExpression() );
+    QgsExpressionContext context = layer->createExpressionContext();
+    expression.prepare( &context );
+
+    QgsFeatureRequest request( it.value() );
+    request.setSubsetOfAttributes( expression.referencedAttributeIndexes( layer->fields() ).values() );
+    if ( !expression.needsGeometry() )
+      request.setFlags( QgsFeatureRequest::NoGeometry );
+
+    // features deleted in the meantime are not returned and stay out of the index
+    QgsFeature feature;
+    QgsFeatureIterator featureIt = layer->getFeatures( request );
+    while ( featureIt.nextFeature( feature ) )
+    {
+      context.setFeature( feature );
+      const QString displayString = expression.evaluate( &context ).toString();
+      if ( !displayString.isEmpty() )
+        writer.addFeature( layer->id(), feature.id(), displayString );
+    }
+
+    // the data file changed along with the committed features, which are now indexed
+    writer.setSignature( layer->id(), layerSignature( layer ) );
+  }
+
+  mPendingUpdates.clear();
+  writer.commit();
+}
+
+void FeaturesLocatorIndex::startBuilder()
+{
+  if ( mBuilder || mLayersToIndex.isEmpty() || mDatabasePath.isEmpty() )
+    return;
+
+  std::vector<std::unique_ptr<FeaturesLocatorIndexBuilder::LayerSource>> layerSources;
+  for ( const QString &layerId : std::as_const( mLayersToIndex ) )
+  {
+    QgsVectorLayer *layer = qobject_cast<QgsVectorLayer *>( QgsProject::instance()->mapLayer( layerId ) );
+    if ( !isIndexable( layer ) )
+      continue;
+
+    std::unique_ptr<FeaturesLocatorIndexBuilder::LayerSource> layerSource = std::make_unique<FeaturesLocatorIndexBuilder::LayerSource>();
+    layerSource->layerId = layer->id();
+    layerSource->signature = layerSignature( layer );
+    layerSource->expression = QgsExpression( layer->displayExpression() );
+    layerSource->context.appendScopes( QgsExpressionContextUtils::globalProjectLayerScopes( layer ) );
+    layerSource->expression.prepare( &layerSource->context );
+    layerSource->request.setSubsetOfAttributes( layerSource->expression.referencedAttributeIndexes( layer->fields() ).values() );
+    if ( !layerSource->expression.needsGeometry() )
+      layerSource->request.setFlags( QgsFeatureRequest::NoGeometry );
+    layerSource->featureSource = std::make_unique<QgsVectorLayerFeatureSource>( layer );
+    layerSources.push_back( std::move( layerSource ) );
+  }
+  mLayersToIndex.clear();
+
+  if ( layerSources.empty() )
+    return;
+
+  QSet<QString> projectLayerIds;
+  const QMap<QString, QgsMapLayer *> layers = QgsProject::instance()->mapLayers();
+  for ( auto it = layers.constBegin(); it != layers.constEnd(); ++it )
+  {
+    if ( isIndexable( qobject_cast<QgsVectorLayer *>( it.value() ) ) )
+      projectLayerIds << it.key();
+  }
+
+  mBuilder = std::make_unique<FeaturesLocatorIndexBuilder>( mDatabasePath, std::move( layerSources ), projectLayerIds );
+  connect( mBuilder.get(), &FeaturesLocatorIndexBuilder::layerIndexed, this, &FeaturesLocatorIndex::layerIndexed );
+  connect( mBuilder.get(), &QThread::finished, this, &FeaturesLocatorIndex::builderFinished );
+  mBuilder->start( QThread::LowPriority );
+}
+
+void FeaturesLocatorIndex::stopBuilder()
+{
+  if ( !mBuilder )
+    return;
+
+  disconnect( mBuilder.get(), nullptr, this, nullptr );
+  mBuilder.reset();
+}
+
+void FeaturesLocatorIndex::builderFinished()
+{
+  if ( sender() != mBuilder.get() )
+    return;
+
+  mBuilder.reset();
+
+  // layers added or changed while building
+  startBuilder();
+  if ( !mBuilder )
+    applyUpdates();
+}
+
+void FeaturesLocatorIndex::layerIndexed( const QString &layerId )
+{
+  // the layer might have been removed or queued to be indexed again meanwhile
+  if ( !QgsProject::instance()->mapLayer( layerId ) || mLayersToIndex.contains( layerId ) )
+    return;
+
+  QMutexLocker locker( &mMutex );
+  mIndexedLayers << layerId;
+}
+
+bool FeaturesLocatorIndex::isIndexable( QgsVectorLayer *layer )
+{
+  return layer && layer->dataProvider() && layer->flags().testFlag( QgsMapLayer::Searchable );
+}
+
+QString FeaturesLocatorIndex::layerSignature( QgsVectorLayer *layer )
+{
+  QString signature = QStringLiteral( "%1|%2|%3" ).arg( layer->providerType(), layer->source(), layer->displayExpression() );
+
+  // file based layers are indexed again whenever their file gets replaced or modified elsewhere
+  const QVariantMap uriParts = QgsProviderRegistry::instance()->decodeUri( layer->providerType(), layer->source() );
+  const QFileInfo fileInfo( uriParts.value( QStringLiteral( "path" ) ).toString() );
+  if ( fileInfo.isFile() )
+    signature += QStringLiteral( "|%1|%2" ).arg( fileInfo.size() ).arg( fileInfo.lastModified().toMSecsSinceEpoch() );
+
+  return signature;
+}
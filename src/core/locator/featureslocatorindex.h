@@ -0,0 +1,150 @@
+/***************************************************************************
+  featureslocatorindex.h
+
+ ---------------------
+ begin                : October 2026
+ copyright            : (C) 2026 by OPENGIS.ch
+ email                : info at opengis dot ch
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef FEATURESLOCATORINDEX_H
+#define FEATURESLOCATORINDEX_H
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QThread>
+#include <QTimer>
+#include <memory>
+#include <qgsexpression.h>
+#include <qgsexpressioncontext.h>
+#include <qgsfeature.h>
+#include <qgsvectorlayerfeatureiterator.h>
+
+class QgsVectorLayer;
+class sqlite3_database_unique_ptr;
+
+/**
+ * \class FeaturesLocatorIndexBuilder
+ * Fills the features locator index with the display strings of a set of layers, off the GUI thread.
+ */
+class FeaturesLocatorIndexBuilder : public QThread
+{
+    Q_OBJECT
+
+  public:
+    struct LayerSource
+    {
+        QString layerId;
+        QString signature;
+        QgsExpression expression;
+        QgsExpressionContext context;
+        QgsFeatureRequest request;
+        std::unique_ptr<QgsVectorLayerFeatureSource> featureSource;
+    };
+
+    /**
+     * Constructor
+     * \param databasePath the index database
+     * \param layerSources the layers to (re)index
+     * \param projectLayerIds the searchable layers of the project, entries of any other layer are dropped
+     */
+    FeaturesLocatorIndexBuilder( const QString &databasePath, std::vector<std::unique_ptr<LayerSource>> &&layerSources, const QSet<QString> &projectLayerIds );
+    ~FeaturesLocatorIndexBuilder() override;
+
+  signals:
+    //! Emitted once the features of layer \a layerId are indexed
+    void layerIndexed( const QString &layerId );
+
+  protected:
+    void run() override;
+
+  private:
+    bool indexLayer( LayerSource *layerSource, sqlite3_database_unique_ptr &database );
+
+    QString mDatabasePath;
+    std::vector<std::unique_ptr<LayerSource>> mLayerSources;
+    QSet<QString> mProjectLayerIds;
+};
+
+/**
+ * \class FeaturesLocatorIndex
+ * A persistent full text index of the display strings of the searchable layers of the current project.
+ *
+ * The index is an SQLite FTS5 database kept per project in the local data location. Layers whose source,
+ * data file or display expression changed since they were indexed are indexed again in the background when
+ * the project is opened, and changes committed to layers are written to the index as they happen.
+ * Display strings are normalized by the FTS5 tokenizer, ignoring case and diacritics.
+ *
+ * Searching is thread safe, it is meant to be done by locator filters running on their own thread.
+ */
+class FeaturesLocatorIndex : public QObject
+{
+    Q_OBJECT
+
+  public:
+    struct Match
+    {
+        QgsFeatureId featureId = FID_NULL;
+        QString displayString;
+    };
+
+    explicit FeaturesLocatorIndex( QObject *parent = nullptr );
+    ~FeaturesLocatorIndex() override;
+
+    //! Returns whether the index is enabled
+    bool isEnabled() const;
+
+    //! Sets whether the index is enabled, the index is built for the current project when enabled
+    void setEnabled( bool enabled );
+
+    //! Returns whether layer \a layerId is fully indexed and can be searched through the index
+    bool isLayerIndexed( const QString &layerId ) const;
+
+    /**
+     * Searches the display strings of layers \a layerIds starting with each word of \a string.
+     * At most \a limitPerLayer matches, ranked by relevance, are returned per layer.
+     * \note thread safe
+     */
+    QHash<QString, QList<Match>> search( const QString &string, const QStringList &layerIds, int limitPerLayer ) const;
+
+  private:
+    void projectRead();
+    void projectCleared();
+    void layersAdded( const QList<QgsMapLayer *> &layers );
+    void layerWillBeRemoved( const QString &layerId );
+    void builderFinished();
+    void layerIndexed( const QString &layerId );
+
+    void watchLayer( QgsVectorLayer *layer );
+    void scheduleUpdate( const QString &layerId, const QgsFeatureIds &featureIds );
+    void applyUpdates();
+    void startBuilder();
+    void stopBuilder();
+
+    static bool isIndexable( QgsVectorLayer *layer );
+    static QString layerSignature( QgsVectorLayer *layer );
+
+    bool mEnabled = false;
+    QString mDatabasePath;
+    QHash<QString, QString> mIndexedSignatures;
+    QSet<QString> mIndexedLayers;
+    QSet<QString> mLayersToIndex;
+    mutable QMutex mMutex;
+
+    std::unique_ptr<FeaturesLocatorIndexBuilder> mBuilder;
+
+    //! Committed changes waiting to be written to the index, features missing from layers are removed
+    QHash<QString, QgsFeatureIds> mPendingUpdates;
+    QTimer mUpdateTimer;
+};
+
+#endif // FEATURESLOCATORINDEX_H
@@ -18,22 +18,33 @@
 #include "bookmarklocatorfilter.h"
 #include "featurelistextentcontroller.h"
 #include "featureslocatorfilter.h"
+#include "featureslocatorindex.h"
 #include "finlandlocatorfilter.h"
 #include "gnsspositioninformation.h"
 #include "gotolocatorfilter.h"
 #include "locatormodelsuperbridge.h"
 #include "peliasgeocoder.h"
 #include "qgsquickmapsettings.h"
+#include "stringutils.h"
 
 #include <QStandardItem>
 #include <qgslocator.h>
 #include <qgslocatormodel.h>
 #include <qgssettings.h>
 
+#include <algorithm>
+
+#define LOCATOR_TOP_RESULTS 16
+#define LOCATOR_MAX_CACHED_RESULTS 64
+#define LOCATOR_FLUSH_INTERVAL 50
 
 LocatorModelSuperBridge::LocatorModelSuperBridge( QObject *parent )
   : QgsLocatorModelBridge( parent )
 {
+  // the features search index is opt-in, it takes storage space and is built in the background on project load
+  mFeaturesLocatorIndex = new FeaturesLocatorIndex( this );
+  mFeaturesLocatorIndex->setEnabled( QgsSettings().value( QStringLiteral( "locator_filters/index_allfeatures" ), false, QgsSettings::Section::Gui ).toBool() );
+
   locator()->registerFilter( new FeaturesLocatorFilter( this ) );
   locator()->registerFilter( new GotoLocatorFilter( this ) );
   locator()->registerFilter( new BookmarkLocatorFilter( this ) );
@@ -41,6 +52,17 @@ LocatorModelSuperBridge::LocatorModelSuperBridge( QObject *parent )
   // Finnish's Digitransit geocoder
   mFinlandGeocoder = new PeliasGeocoder( QStringLiteral( "https://api.digitransit.fi/geocoding/v1/search" ) );
   locator()->registerFilter( new FinlandLocatorFilter( mFinlandGeocoder, this ) );
+
+  // results go through the ranking before reaching the model
+  mResultsModel = qobject_cast<QgsLocatorModel *>( proxyModel()->sourceModel() );
+  disconnect( locator(), &QgsLocator::foundResult, this, nullptr );
+  connect( locator(), &QgsLocator::foundResult, this, &LocatorModelSuperBridge::addRankedResult );
+  connect( locator(), &QgsLocator::finished, this, &LocatorModelSuperBridge::rankedSearchFinished );
+  connect( mResultsModel, &QAbstractItemModel::modelReset, this, &LocatorModelSuperBridge::resultsModelReset );
+
+  mFlushTimer.setSingleShot( true );
+  mFlushTimer.setInterval( LOCATOR_FLUSH_INTERVAL );
+  connect( &mFlushTimer, &QTimer::timeout, this, &LocatorModelSuperBridge::flushRankedResults );
 }
 
 Navigation *LocatorModelSuperBridge::navigation() const
@@ -73,6 +95,11 @@ void LocatorModelSuperBridge::setBookmarks( BookmarkModel *bookmarks )
   emit bookmarksChanged();
 }
 
+FeaturesLocatorIndex *LocatorModelSuperBridge::featuresLocatorIndex() const
+{
+  return mFeaturesLocatorIndex;
+}
+
 QgsQuickMapSettings *LocatorModelSuperBridge::mapSettings() const
 {
   return mMapSettings;
@@ -136,6 +163,21 @@ void LocatorModelSuperBridge::setKeepScale( bool keepScale )
   emit keepScaleChanged();
 }
 
+bool LocatorModelSuperBridge::indexAllFeatures() const
+{
+  return mFeaturesLocatorIndex->isEnabled();
+}
+
+void LocatorModelSuperBridge::setIndexAllFeatures( bool indexAllFeatures )
+{
+  if ( indexAllFeatures == mFeaturesLocatorIndex->isEnabled() )
+    return;
+
+  mFeaturesLocatorIndex->setEnabled( indexAllFeatures );
+  QgsSettings().setValue( QStringLiteral( "locator_filters/index_allfeatures" ), indexAllFeatures, QgsSettings::Section::Gui );
+  emit indexAllFeaturesChanged();
+}
+
 LocatorActionsModel *LocatorModelSuperBridge::contextMenuActionsModel( const int row )
 {
   const QModelIndex index = proxyModel()->index( row, 0 );
@@ -169,6 +211,221 @@ void LocatorModelSuperBridge::triggerResultAtRow( const int row, const int id )
     triggerResult( index, id );
 }
 
+void LocatorModelSuperBridge::performSearch( const QString &text )
+{
+  const QString searchString = searchedString( text );
+
+  QList<QgsLocatorResult> refinedResults;
+  if ( !mSearchText.isEmpty() && text.startsWith( mSearchText, Qt::CaseInsensitive ) && searchString.startsWith( mSearchString, Qt::CaseInsensitive ) )
+  {
+    for ( auto it = mReceivedResults.constBegin(); it != mReceivedResults.constEnd(); ++it )
+    {
+      for ( const QgsLocatorResult &result : it.value() )
+      {
+        if ( StringUtils::fuzzyMatch( result.displayString, searchString ) )
+          refinedResults << result;
+      }
+    }
+  }
+
+  mSearchText = text;
+  mSearchString = searchString;
+  mRankedResults.clear();
+  mReceivedResults.clear();
+  mNeedsReranking = false;
+  mFlushTimer.stop();
+
+  QgsLocatorModelBridge::performSearch( text );
+
+  if ( !refinedResults.isEmpty() )
+  {
+    mResultsModel->clear();
+    for ( const QgsLocatorResult &result : std::as_const( refinedResults ) )
+      insertRankedResult( result, true );
+    flushRankedResults();
+  }
+}
+
+void LocatorModelSuperBridge::addRankedResult( const QgsLocatorResult &result )
+{
+  insertRankedResult( result, false );
+}
+
+void LocatorModelSuperBridge::insertRankedResult( const QgsLocatorResult &locatorResult, bool refined )
+{
+  QgsLocatorResult result = locatorResult;
+  const double matchScore = StringUtils::fuzzyMatchScore( result.displayString, mSearchString );
+  if ( matchScore > 0 )
+    result.score = matchScore;
+
+  const QString filterName = result.filter ? result.filter->name() : QString();
+  const QString key = resultKey( result );
+  QList<RankedResult> &rankedResults = mRankedResults[filterName];
+  QList<QgsLocatorResult> &receivedResults = mReceivedResults[filterName];
+  for ( RankedResult &rankedResult : rankedResults )
+  {
+    if ( resultKey( rankedResult.result ) == key )
+    {
+      // a refined result found again by the search is confirmed
+      if ( !refined && rankedResult.refined )
+      {
+        rankedResult.refined = false;
+        if ( receivedResults.size() < LOCATOR_MAX_CACHED_RESULTS )
+          receivedResults << result;
+      }
+      return;
+    }
+  }
+
+  // refined results are only kept once the search confirms them
+  const bool isReceived = !refined && receivedResults.size() < LOCATOR_MAX_CACHED_RESULTS;
+  if ( isReceived )
+    receivedResults << result;
+
+  if ( rankedResults.size() >= LOCATOR_TOP_RESULTS )
+  {
+    // only results not added yet can make room, the locator model cannot drop a single result
+    int lowestPendingIndex = -1;
+    for ( int i = rankedResults.size() - 1; i >= 0; i-- )
+    {
+      if ( !rankedResults.at( i ).added )
+      {
+        lowestPendingIndex = i;
+        break;
+      }
+    }
+
+    if ( lowestPendingIndex == -1 || rankedResults.at( lowestPendingIndex ).result.score >= result.score )
+    {
+      // a late result outscoring one already shown takes its place once the search is over
+      if ( !refined && rankedResults.constLast().result.score < result.score )
+      {
+        if ( !isReceived )
+          receivedResults << result;
+        mNeedsReranking = true;
+      }
+      return;
+    }
+
+    rankedResults.removeAt( lowestPendingIndex );
+  }
+
+  RankedResult rankedResult;
+  rankedResult.result = result;
+  rankedResult.refined = refined;
+  auto it = std::upper_bound( rankedResults.begin(), rankedResults.end(), result.score, []( double score, const RankedResult &other ) {
+    return score > other.result.score;
+  } );
+  rankedResults.insert( it, rankedResult );
+
+  if ( !mFlushTimer.isActive() )
+    mFlushTimer.start();
+}
+
+void LocatorModelSuperBridge::rankedSearchFinished()
+{
+  // a canceled search is followed right away by the queued one, which has yet to confirm the refined results
+  if ( locator()->isRunning() )
+  {
+    flushRankedResults();
+    return;
+  }
+
+  bool hasUnconfirmedResults = false;
+  for ( auto it = mRankedResults.constBegin(); it != mRankedResults.constEnd() && !hasUnconfirmedResults; ++it )
+  {
+    for ( const RankedResult &rankedResult : it.value() )
+    {
+      if ( rankedResult.refined )
+      {
+        hasUnconfirmedResults = true;
+        break;
+      }
+    }
+  }
+
+  if ( hasUnconfirmedResults || mNeedsReranking )
+  {
+    // the locator model cannot drop a single result, rank the results found by the search again from scratch
+    mNeedsReranking = false;
+    const QHash<QString, QList<QgsLocatorResult>> receivedResults = mReceivedResults;
+    mRankedResults.clear();
+    mReceivedResults.clear();
+    mResultsModel->clear();
+    for ( auto it = receivedResults.constBegin(); it != receivedResults.constEnd(); ++it )
+    {
+      for ( const QgsLocatorResult &result : it.value() )
+        insertRankedResult( result, false );
+    }
+  }
+
+  flushRankedResults();
+}
+
+void LocatorModelSuperBridge::flushRankedResults()
+{
+  mFlushTimer.stop();
+
+  bool hasAddedResults = false;
+  for ( auto it = mRankedResults.begin(); it != mRankedResults.end(); ++it )
+  {
+    for ( RankedResult &rankedResult : it.value() )
+    {
+      if ( rankedResult.added )
+        continue;
+
+      // adding might trigger the deferred clear of the model, flag the result as added only afterwards
+      mResultsModel->addResult( rankedResult.result );
+      rankedResult.added = true;
+      hasAddedResults = true;
+    }
+  }
+
+  if ( hasAddedResults )
+    emit resultAdded();
+}
+
+void LocatorModelSuperBridge::resultsModelReset()
+{
+  bool hasAddedResults = false;
+  for ( auto it = mRankedResults.begin(); it != mRankedResults.end(); ++it )
+  {
+    for ( RankedResult &rankedResult : it.value() )
+    {
+      hasAddedResults |= rankedResult.added;
+      rankedResult.added = false;
+    }
+  }
+
+  // the results of the current search got cleared along with stale ones, add them back
+  if ( hasAddedResults )
+    QTimer::singleShot( 0, this, &LocatorModelSuperBridge::flushRankedResults );
+}
+
+QString LocatorModelSuperBridge::searchedString( const QString &text ) const
+{
+  // same as QgsLocator, a prefix matching a filter restricts the search to that filter and is not searched for
+  const int prefixLength = std::max( text.indexOf( ' ' ), 0 );
+  const QString prefix = text.left( prefixLength );
+  if ( prefix.isEmpty() )
+    return text;
+
+  const QList<QgsLocatorFilter *> filters = locator()->filters();
+  for ( QgsLocatorFilter *filter : filters )
+  {
+    if ( filter->enabled() && filter->activePrefix().compare( prefix, Qt::CaseInsensitive ) == 0 )
+      return text.mid( prefixLength + 1 );
+  }
+
+  return text;
+}
+
+QString LocatorModelSuperBridge::resultKey( const QgsLocatorResult &result )
+{
+  const QStringList userData = result.userData.toStringList();
+  return QStringLiteral( "%1|%2|%3" ).arg( result.group, result.displayString, userData.isEmpty() ? result.userData.toString() : userData.join( '|' ) );
+}
+
 //
 // LocatorActionsModel
 //
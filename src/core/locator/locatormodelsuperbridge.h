@@ -21,14 +21,17 @@
 #include "navigation.h"
 
 #include <QStandardItemModel>
+#include <QTimer>
 #include <qgslocatorfilter.h>
 #include <qgslocatormodelbridge.h>
 
 class QgsQuickMapSettings;
 class FeatureListExtentController;
+class FeaturesLocatorIndex;
 class PeliasGeocoder;
 class GnssPositionInformation;
 class QgsLocator;
+class QgsLocatorModel;
 
 /**
  * LocatorActionsModel is a model used to dislay
@@ -54,6 +57,11 @@ class LocatorActionsModel : public QStandardItemModel
 /**
  * LocatorModelSuperBridge reimplements QgsLocatorModelBridge
  *  for specific needs of QField / QML implementation.
+ *
+ * Results streamed by the filters are ranked by how well their display string
+ * matches the searched text and only the best ones of each filter are kept.
+ * When the searched text extends the previous one, the previous results still
+ * matching are shown right away while the filters search again.
  */
 class LocatorModelSuperBridge : public QgsLocatorModelBridge
 {
@@ -65,6 +73,16 @@ class LocatorModelSuperBridge : public QgsLocatorModelBridge
     Q_PROPERTY( Navigation *navigation READ navigation WRITE setNavigation NOTIFY navigationChanged )
     Q_PROPERTY( bool keepScale READ keepScale WRITE setKeepScale NOTIFY keepScaleChanged )
 
+    /**
+     * Whether the display strings of the searchable layers are kept in a full text index, stored in the
+     * locator_filters/index_allfeatures setting and disabled by default.
+     *
+     * Indexed layers are searched without going through their provider, each searched word matching the start
+     * of a word of the display string, ignoring case and diacritics. The index takes storage space and is built
+     * in the background when a project is opened, layers not indexed yet are searched through their provider.
+     */
+    Q_PROPERTY( bool indexAllFeatures READ indexAllFeatures WRITE setIndexAllFeatures NOTIFY indexAllFeaturesChanged )
+
   public:
     explicit LocatorModelSuperBridge( QObject *parent = nullptr );
     ~LocatorModelSuperBridge() = default;
@@ -87,6 +105,12 @@ class LocatorModelSuperBridge : public QgsLocatorModelBridge
     bool keepScale() const;
     void setKeepScale( bool keepScale );
 
+    bool indexAllFeatures() const;
+    void setIndexAllFeatures( bool indexAllFeatures );
+
+    //! Returns the full text index of the searchable layers of the current project
+    FeaturesLocatorIndex *featuresLocatorIndex() const;
+
     Q_INVOKABLE LocatorActionsModel *contextMenuActionsModel( const int row );
 
     void emitMessage( const QString &text );
@@ -99,17 +123,52 @@ class LocatorModelSuperBridge : public QgsLocatorModelBridge
     void featureListControllerChanged();
     void messageEmitted( const QString &text );
     void keepScaleChanged();
+    void indexAllFeaturesChanged();
 
   public slots:
     Q_INVOKABLE void triggerResultAtRow( const int row, const int id = -1 );
 
+    //! Searches \a text, refining the results of the previous search right away when \a text extends it
+    Q_INVOKABLE void performSearch( const QString &text );
+
   private:
+    struct RankedResult
+    {
+        QgsLocatorResult result;
+        //! Whether the result has been added to the locator model
+        bool added = false;
+        //! Whether the result comes from the previous search and has yet to be found again
+        bool refined = false;
+    };
+
+    void addRankedResult( const QgsLocatorResult &result );
+    void insertRankedResult( const QgsLocatorResult &result, bool refined );
+    void rankedSearchFinished();
+    void flushRankedResults();
+    void resultsModelReset();
+    //! Returns \a text without the prefix of the filter it is restricted to, if any
+    QString searchedString( const QString &text ) const;
+    static QString resultKey( const QgsLocatorResult &result );
+
+    QgsLocatorModel *mResultsModel = nullptr;
+    QString mSearchText;
+    //! Searched text without the filter prefix, the results are scored against it
+    QString mSearchString;
+    //! Best results of the current search per filter name, best first
+    QHash<QString, QList<RankedResult>> mRankedResults;
+    //! Results received for the current search per filter name, refined when the search text is extended
+    QHash<QString, QList<QgsLocatorResult>> mReceivedResults;
+    //! Whether a result outscoring one already added was rejected, the results are ranked again once the search is over
+    bool mNeedsReranking = false;
+    QTimer mFlushTimer;
+
     QgsQuickMapSettings *mMapSettings = nullptr;
     QObject *mLocatorHighlightGeometry = nullptr;
     FeatureListExtentController *mFeatureListController = nullptr;
     bool mKeepScale = false;
 
     PeliasGeocoder *mFinlandGeocoder = nullptr;
+    FeaturesLocatorIndex *mFeaturesLocatorIndex = nullptr;
     BookmarkModel *mBookmarks = nullptr;
     Navigation *mNavigation = nullptr;
 };
@@ -15,13 +15,18 @@
  ***************************************************************************/
 #include "messagelogmodel.h"
 
-#include <QDebug>
 #include <qgsapplication.h>
 
 MessageLogModel::MessageLogModel( QObject *parent )
   : QAbstractListModel( parent )
   , mMessageLog( QgsApplication::messageLog() )
 {
+  mMessages.resize( mMaximumMessages );
+
+  mFlushTimer.setInterval( 250 );
+  mFlushTimer.setSingleShot( true );
+  connect( &mFlushTimer, &QTimer::timeout, this, &MessageLogModel::flushPendingMessages );
+
   connect( mMessageLog, static_cast<void ( QgsMessageLog::* )( const QString &message, const QString &tag, Qgis::MessageLevel level )>( &QgsMessageLog::messageReceived ), this, &MessageLogModel::onMessageReceived );
 }
 
@@ -32,6 +37,7 @@ QHash<int, QByteArray> MessageLogModel::roleNames() const
   roles[MessageTagRole] = "MessageTag";
   roles[MessageLevelRole] = "MessageLevel";
   roles[MessageDateTimeRole] = "MessageDateTime";
+  roles[MessageCountRole] = "MessageCount";
 
   return roles;
 }
@@ -39,32 +45,39 @@ QHash<int, QByteArray> MessageLogModel::roleNames() const
 int MessageLogModel::rowCount( const QModelIndex &parent ) const
 {
   Q_UNUSED( parent )
-  return mMessages.size();
+  return mMessageCount;
 }
 
 QVariant MessageLogModel::data( const QModelIndex &index, int role ) const
 {
-  if ( index.row() >= mMessages.size() )
+  if ( index.row() < 0 || index.row() >= mMessageCount )
     return QVariant();
 
+  const LogMessage &message = messageAt( index.row() );
   if ( role == MessageRole )
-    return mMessages.at( index.row() ).message;
+    return message.message;
   else if ( role == MessageTagRole )
-    return mMessages.at( index.row() ).tag;
+    return message.tag;
   else if ( role == MessageLevelRole )
-    return mMessages.at( index.row() ).level;
+    return message.level;
   else if ( role == MessageDateTimeRole )
-    return mMessages.at( index.row() ).datetime;
+    return message.datetime.toString( QStringLiteral( "yyyy-MM-dd hh:mm:ss:zzz" ) );
+  else if ( role == MessageCountRole )
+    return message.count;
 
   return QVariant();
 }
 
+const MessageLogModel::LogMessage &MessageLogModel::messageAt( int row ) const
+{
+  return mMessages.at( ( mFirstMessage + mMessageCount - 1 - row ) % mMaximumMessages );
+}
+
 void MessageLogModel::suppressTags( const QList<QString> &tags )
 {
   for ( const QString &tag : tags )
   {
-    if ( !mSuppressedTags.contains( tag ) )
-      mSuppressedTags.append( tag );
+    mSuppressedTags.insert( tag );
   }
 }
 
@@ -72,25 +85,106 @@ void MessageLogModel::unsuppressTags( const QList<QString> &tags )
 {
   for ( const QString &tag : tags )
   {
-    if ( mSuppressedTags.contains( tag ) )
-      mSuppressedTags.removeAll( tag );
+    mSuppressedTags.remove( tag );
   }
 }
 
 void MessageLogModel::clear()
 {
   beginResetModel();
-  mMessages.clear();
+  mPendingMessages.clear();
+  mMessages.fill( LogMessage() );
+  mFirstMessage = 0;
+  mMessageCount = 0;
+  endResetModel();
+}
+
+void MessageLogModel::setMaximumMessages( int maximumMessages )
+{
+  maximumMessages = std::max( 1, maximumMessages );
+  if ( mMaximumMessages == maximumMessages )
+    return;
+
+  flushPendingMessages();
+
+  beginResetModel();
+  const int keptCount = std::min( mMessageCount, maximumMessages );
+  QVector<LogMessage> messages( maximumMessages );
+  for ( int i = 0; i < keptCount; i++ )
+  {
+    // Copy from the oldest kept message to the most recent one
+    messages[i] = messageAt( keptCount - 1 - i );
+  }
+  mMessages = messages;
+  mMaximumMessages = maximumMessages;
+  mFirstMessage = 0;
+  mMessageCount = keptCount;
   endResetModel();
+
+  emit maximumMessagesChanged();
 }
 
 void MessageLogModel::onMessageReceived( const QString &message, const QString &tag, Qgis::MessageLevel level )
 {
-  if ( mSuppressedTags.contains( tag ) || tag == QLatin1String( "3D" ) )
+  if ( tag == QLatin1String( "3D" ) || mSuppressedTags.contains( tag ) )
     return;
 
-  beginInsertRows( QModelIndex(), 0, 0 );
-  mMessages.prepend( LogMessage( tag, message, level ) );
-  qDebug() << "Nes message " << tag << " : " << message;
+  if ( !mPendingMessages.isEmpty() )
+  {
+    LogMessage &lastPendingMessage = mPendingMessages.last();
+    if ( lastPendingMessage.isDuplicateOf( tag, message, level ) )
+    {
+      lastPendingMessage.count++;
+      lastPendingMessage.datetime = QDateTime::currentDateTime();
+      return;
+    }
+  }
+  else if ( mMessageCount > 0 )
+  {
+    LogMessage &lastMessage = mMessages[( mFirstMessage + mMessageCount - 1 ) % mMaximumMessages];
+    if ( lastMessage.isDuplicateOf( tag, message, level ) )
+    {
+      lastMessage.count++;
+      lastMessage.datetime = QDateTime::currentDateTime();
+      emit dataChanged( index( 0, 0 ), index( 0, 0 ), QVector<int>() << MessageDateTimeRole << MessageCountRole );
+      return;
+    }
+  }
+
+  mPendingMessages << LogMessage( tag, message, level );
+  if ( !mFlushTimer.isActive() )
+    mFlushTimer.start();
+}
+
+void MessageLogModel::flushPendingMessages()
+{
+  mFlushTimer.stop();
+  if ( mPendingMessages.isEmpty() )
+    return;
+
+  if ( mPendingMessages.size() > mMaximumMessages )
+  {
+    // Only the most recent messages would survive the insertion
+    mPendingMessages.remove( 0, mPendingMessages.size() - mMaximumMessages );
+  }
+
+  const int pendingCount = mPendingMessages.size();
+  const int overflowCount = mMessageCount + pendingCount - mMaximumMessages;
+  if ( overflowCount > 0 )
+  {
+    beginRemoveRows( QModelIndex(), mMessageCount - overflowCount, mMessageCount - 1 );
+    mFirstMessage = ( mFirstMessage + overflowCount ) % mMaximumMessages;
+    mMessageCount -= overflowCount;
+    endRemoveRows();
+  }
+
+  beginInsertRows( QModelIndex(), 0, pendingCount - 1 );
+  for ( LogMessage &message : mPendingMessages )
+  {
+    mMessages[( mFirstMessage + mMessageCount ) % mMaximumMessages] = std::move( message );
+    mMessageCount++;
+  }
   endInsertRows();
+
+  mPendingMessages.clear();
 }
@@ -18,16 +18,25 @@
 
 #include <QAbstractListModel>
 #include <QDateTime>
+#include <QSet>
+#include <QTimer>
 #include <qgsmessagelog.h>
 
 /**
  * This model will connect to the message log and publish any
  * messages received from there.
+ *
+ * Messages are kept in a ring buffer capped to maximumMessages, the oldest
+ * messages being dropped once the cap is reached. Incoming messages are
+ * batched and inserted into the model at a fixed interval, and identical
+ * consecutive messages are folded into a single entry with a counter.
  */
 class MessageLogModel : public QAbstractListModel
 {
     Q_OBJECT
 
+    Q_PROPERTY( int maximumMessages READ maximumMessages WRITE setMaximumMessages NOTIFY maximumMessagesChanged )
+
     struct LogMessage
     {
         LogMessage()
@@ -37,14 +46,20 @@ class MessageLogModel : public QAbstractListModel
           : tag( tag )
           , message( message )
           , level( level )
-          , datetime( QDateTime::currentDateTime().toString( QStringLiteral( "yyyy-MM-dd hh:mm:ss:zzz" ) ) )
+          , datetime( QDateTime::currentDateTime() )
+        {
+        }
+
+        bool isDuplicateOf( const QString &otherTag, const QString &otherMessage, Qgis::MessageLevel otherLevel ) const
         {
+          return level == otherLevel && tag == otherTag && message == otherMessage;
         }
 
         QString tag;
         QString message;
-        Qgis::MessageLevel level;
-        QString datetime;
+        Qgis::MessageLevel level = Qgis::Info;
+        QDateTime datetime;
+        int count = 1;
     };
 
     enum Roles
@@ -52,7 +67,8 @@ class MessageLogModel : public QAbstractListModel
       MessageRole = Qt::UserRole,
       MessageTagRole,
       MessageLevelRole,
-      MessageDateTimeRole
+      MessageDateTimeRole,
+      MessageCountRole
     };
 
   public:
@@ -71,13 +87,39 @@ class MessageLogModel : public QAbstractListModel
     //! Clears any messages from the log
     Q_INVOKABLE void clear();
 
+    //! Returns the maximum number of messages kept in the log
+    int maximumMessages() const { return mMaximumMessages; }
+
+    /**
+     * Sets the maximum number of messages kept in the log. When the cap is
+     * lowered below the current message count, the oldest messages are dropped.
+     */
+    void setMaximumMessages( int maximumMessages );
+
+  signals:
+    void maximumMessagesChanged();
+
   private slots:
     void onMessageReceived( const QString &message, const QString &tag, Qgis::MessageLevel level );
 
+    //! Inserts pending messages into the model in a single batch
+    void flushPendingMessages();
+
   private:
+    //! Returns the ring buffer message for a given model \a row, row 0 being the most recent message
+    const LogMessage &messageAt( int row ) const;
+
     QgsMessageLog *mMessageLog = nullptr;
+
     QVector<LogMessage> mMessages;
-    QList<QString> mSuppressedTags;
+    int mMaximumMessages = 500;
+    int mFirstMessage = 0;
+    int mMessageCount = 0;
+
+    QVector<LogMessage> mPendingMessages;
+    QTimer mFlushTimer;
+
+    QSet<QString> mSuppressedTags;
 };
 
 #endif // MESSAGELOGMODEL_H
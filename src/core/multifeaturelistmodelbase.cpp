@@ -28,6 +28,8 @@
 #include <qgsvectordataprovider.h>
 #include <qgsvectorlayer.h>
 
+#include <algorithm>
+
 MultiFeatureListModelBase::MultiFeatureListModelBase( QObject *parent )
   : QAbstractItemModel( parent )
 {
@@ -53,10 +55,7 @@ void MultiFeatureListModelBase::setFeatures( const QMap<QgsVectorLayer *, QgsFea
     while ( fit.nextFeature( feat ) )
     {
       mFeatures.append( QPair<QgsVectorLayer *, QgsFeature>( vl, feat ) );
-      connect( vl, &QgsVectorLayer::destroyed, this, &MultiFeatureListModelBase::layerDeleted, Qt::UniqueConnection );
-      connect( vl, &QgsVectorLayer::featureDeleted, this, &MultiFeatureListModelBase::featureDeleted, Qt::UniqueConnection );
-      connect( vl, &QgsVectorLayer::attributeValueChanged, this, &MultiFeatureListModelBase::attributeValueChanged, Qt::UniqueConnection );
-      connect( vl, &QgsVectorLayer::geometryChanged, this, &MultiFeatureListModelBase::geometryChanged, Qt::UniqueConnection );
+      connectLayer( vl );
     }
   }
 
@@ -74,10 +73,7 @@ void MultiFeatureListModelBase::appendFeatures( const QList<IdentifyTool::Identi
     if ( !mFeatures.contains( item ) )
     {
       mFeatures.append( item );
-      connect( layer, &QObject::destroyed, this, &MultiFeatureListModelBase::layerDeleted, Qt::UniqueConnection );
-      connect( layer, &QgsVectorLayer::featureDeleted, this, &MultiFeatureListModelBase::featureDeleted, Qt::UniqueConnection );
-      connect( layer, &QgsVectorLayer::attributeValueChanged, this, &MultiFeatureListModelBase::attributeValueChanged, Qt::UniqueConnection );
-      connect( layer, &QgsVectorLayer::geometryChanged, this, &MultiFeatureListModelBase::geometryChanged, Qt::UniqueConnection );
+      connectLayer( layer );
 
       if ( !mSelectedFeatures.isEmpty() )
       {
@@ -101,6 +97,17 @@ void MultiFeatureListModelBase::appendFeatures( const QList<IdentifyTool::Identi
   }
 }
 
+void MultiFeatureListModelBase::connectLayer( QgsVectorLayer *layer )
+{
+  connect( layer, &QObject::destroyed, this, &MultiFeatureListModelBase::layerDeleted, Qt::UniqueConnection );
+  connect( layer, &QgsVectorLayer::featureDeleted, this, &MultiFeatureListModelBase::featureDeleted, Qt::UniqueConnection );
+  connect( layer, &QgsVectorLayer::attributeValueChanged, this, &MultiFeatureListModelBase::attributeValueChanged, Qt::UniqueConnection );
+  connect( layer, &QgsVectorLayer::geometryChanged, this, &MultiFeatureListModelBase::geometryChanged, Qt::UniqueConnection );
+  connect( layer, &QgsVectorLayer::editCommandStarted, this, &MultiFeatureListModelBase::editCommandStarted, Qt::UniqueConnection );
+  connect( layer, &QgsVectorLayer::editCommandEnded, this, &MultiFeatureListModelBase::editCommandEnded, Qt::UniqueConnection );
+  connect( layer, &QgsVectorLayer::editCommandDestroyed, this, &MultiFeatureListModelBase::editCommandDestroyed, Qt::UniqueConnection );
+}
+
 void MultiFeatureListModelBase::clear( const bool keepSelected )
 {
   // the model is already empty, no need to trigger "resetModel"
@@ -163,6 +170,16 @@ QgsVectorLayer *MultiFeatureListModelBase::selectedLayer() const
   return mSelectedFeatures.size() > 0 ? mSelectedFeatures[0].first : nullptr;
 }
 
+QMap<QgsVectorLayer *, QgsFeatureList> MultiFeatureListModelBase::selectedFeaturesPerLayer() const
+{
+  QMap<QgsVectorLayer *, QgsFeatureList> features;
+  for ( const QPair<QgsVectorLayer *, QgsFeature> &pair : mSelectedFeatures )
+  {
+    features[pair.first] << pair.second;
+  }
+  return features;
+}
+
 QHash<int, QByteArray> MultiFeatureListModelBase::roleNames() const
 {
   QHash<int, QByteArray> roleNames;
@@ -390,21 +407,27 @@ bool MultiFeatureListModelBase::mergeSelection()
 
     QgsFeature mergedFeature = selectedFeatures[0].second;
     mergedFeature.setGeometry( combinedGeometry );
+
+    // the merged feature is updated and the others deleted within a single edit command
+    vlayer->beginEditCommand( tr( "Merge features" ) );
     isSuccess = vlayer->updateFeature( mergedFeature );
 
     if ( isSuccess )
     {
       selectedFeatures.removeFirst();
+      QgsFeatureIds fids;
       for ( const auto &pair : std::as_const( selectedFeatures ) )
       {
-        isSuccess = deleteFeature( pair.first, pair.second.id(), true );
-        if ( !isSuccess )
-        {
-          break;
-        }
+        fids << pair.second.id();
       }
+      isSuccess = LayerUtils::deleteFeatures( QgsProject::instance(), vlayer, fids, true );
     }
 
+    if ( isSuccess )
+      vlayer->endEditCommand();
+    else
+      vlayer->destroyEditCommand();
+
     if ( isSuccess )
     {
       // commit changes
@@ -434,34 +457,22 @@ bool MultiFeatureListModelBase::deleteSelection()
   if ( !canDeleteSelection() )
     return false;
 
-  QgsVectorLayer *vlayer = selectedLayer();
-  if ( !vlayer->startEditing() )
-  {
-    QgsMessageLog::logMessage( tr( "Cannot start editing" ), "QField", Qgis::Warning );
-    return false;
-  }
-
-  const QList<QPair<QgsVectorLayer *, QgsFeature>> selectedFeatures = mSelectedFeatures;
+  const QMap<QgsVectorLayer *, QgsFeatureList> selectedFeatures = selectedFeaturesPerLayer();
   bool isSuccess = false;
-  for ( const auto &pair : selectedFeatures )
+  for ( auto it = selectedFeatures.constBegin(); it != selectedFeatures.constEnd(); ++it )
   {
-    isSuccess = deleteFeature( pair.first, pair.second.id(), true );
+    QgsFeatureIds fids;
+    for ( const QgsFeature &feature : it.value() )
+    {
+      fids << feature.id();
+    }
+
+    // features of a layer are deleted within a single edit command and commit
+    isSuccess = LayerUtils::deleteFeatures( QgsProject::instance(), it.key(), fids, false );
     if ( !isSuccess )
       break;
   }
 
-  if ( isSuccess )
-  {
-    // commit changes
-    isSuccess = vlayer->commitChanges();
-  }
-
-  if ( !isSuccess )
-  {
-    if ( !vlayer->rollBack() )
-      QgsMessageLog::logMessage( tr( "Cannot rollback layer changes in layer %1" ).arg( vlayer->name() ), "QField", Qgis::Critical );
-  }
-
   return isSuccess;
 }
 
@@ -489,18 +500,21 @@ bool MultiFeatureListModelBase::duplicateSelection()
   if ( !canDuplicateSelection() )
     return false;
 
-  QgsVectorLayer *vlayer = selectedLayer();
-
-  const QList<QPair<QgsVectorLayer *, QgsFeature>> selectedFeatures = mSelectedFeatures;
+  const QMap<QgsVectorLayer *, QgsFeatureList> selectedFeatures = selectedFeaturesPerLayer();
   QList<QPair<QgsVectorLayer *, QgsFeature>> duplicatedFeatures;
   bool isSuccess = false;
-  for ( const auto &pair : selectedFeatures )
+  for ( auto it = selectedFeatures.constBegin(); it != selectedFeatures.constEnd(); ++it )
   {
-    QgsFeature duplicatedFeature = LayerUtils::duplicateFeature( vlayer, pair.second );
-    duplicatedFeatures << QPair<QgsVectorLayer *, QgsFeature>( vlayer, duplicatedFeature );
-    isSuccess = duplicatedFeature.isValid();
+    // features of a layer are duplicated within a single edit command and commit
+    const QgsFeatureList layerDuplicatedFeatures = LayerUtils::duplicateFeatures( it.key(), it.value() );
+    isSuccess = !layerDuplicatedFeatures.isEmpty();
     if ( !isSuccess )
       break;
+
+    for ( const QgsFeature &duplicatedFeature : layerDuplicatedFeatures )
+    {
+      duplicatedFeatures << QPair<QgsVectorLayer *, QgsFeature>( it.key(), duplicatedFeature );
+    }
   }
 
   if ( isSuccess )
@@ -528,6 +542,9 @@ bool MultiFeatureListModelBase::moveSelection( const double x, const double y )
   }
 
   bool isSuccess = false;
+
+  // geometries are changed within a single edit command, the model being updated once it is over
+  vlayer->beginEditCommand( tr( "Move features" ) );
   for ( auto &pair : mSelectedFeatures )
   {
     QgsGeometry geom = pair.second.geometry();
@@ -541,6 +558,11 @@ bool MultiFeatureListModelBase::moveSelection( const double x, const double y )
     }
   }
 
+  if ( isSuccess )
+    vlayer->endEditCommand();
+  else
+    vlayer->destroyEditCommand();
+
   if ( isSuccess )
   {
     // commit changes
@@ -587,6 +609,7 @@ void MultiFeatureListModelBase::layerDeleted( QObject *object )
 
   removeRows( firstRowToRemove, count );
 
+  mPendingChanges.remove( static_cast<QgsVectorLayer *>( object ) );
   mSelectedFeatures.clear();
   emit selectedCountChanged();
 }
@@ -596,6 +619,12 @@ void MultiFeatureListModelBase::featureDeleted( QgsFeatureId fid )
   QgsVectorLayer *l = qobject_cast<QgsVectorLayer *>( sender() );
   Q_ASSERT( l );
 
+  if ( PendingChanges *changes = pendingChanges( l ) )
+  {
+    changes->deletedFeatureIds.last() << fid;
+    return;
+  }
+
   mSelectedFeatures.clear();
   emit selectedCountChanged();
 
@@ -616,6 +645,12 @@ void MultiFeatureListModelBase::attributeValueChanged( QgsFeatureId fid, int idx
   QgsVectorLayer *l = qobject_cast<QgsVectorLayer *>( sender() );
   Q_ASSERT( l );
 
+  if ( PendingChanges *changes = pendingChanges( l ) )
+  {
+    changes->changedAttributeValues[fid][idx] = value;
+    return;
+  }
+
   int i = 0;
   for ( auto &pair : mFeatures )
   {
@@ -645,6 +680,12 @@ void MultiFeatureListModelBase::geometryChanged( QgsFeatureId fid, const QgsGeom
   QgsVectorLayer *l = qobject_cast<QgsVectorLayer *>( sender() );
   Q_ASSERT( l );
 
+  if ( PendingChanges *changes = pendingChanges( l ) )
+  {
+    changes->changedGeometries[fid] = geometry;
+    return;
+  }
+
   int i = 0;
   for ( auto &pair : mFeatures )
   {
@@ -668,3 +709,139 @@ void MultiFeatureListModelBase::geometryChanged( QgsFeatureId fid, const QgsGeom
     }
   }
 }
+
+void MultiFeatureListModelBase::editCommandStarted( const QString &text )
+{
+  Q_UNUSED( text )
+  QgsVectorLayer *l = qobject_cast<QgsVectorLayer *>( sender() );
+  Q_ASSERT( l );
+
+  mPendingChanges[l].deletedFeatureIds << QgsFeatureIds();
+}
+
+void MultiFeatureListModelBase::editCommandEnded()
+{
+  QgsVectorLayer *l = qobject_cast<QgsVectorLayer *>( sender() );
+  Q_ASSERT( l );
+
+  auto it = mPendingChanges.find( l );
+  if ( it == mPendingChanges.end() || it->deletedFeatureIds.isEmpty() )
+    return;
+
+  // deletions of a nested command become part of its parent command
+  const QgsFeatureIds deletedFeatureIds = it->deletedFeatureIds.takeLast();
+  if ( !it->deletedFeatureIds.isEmpty() )
+  {
+    it->deletedFeatureIds.last().unite( deletedFeatureIds );
+    return;
+  }
+
+  applyPendingChanges( l, deletedFeatureIds );
+}
+
+void MultiFeatureListModelBase::editCommandDestroyed()
+{
+  QgsVectorLayer *l = qobject_cast<QgsVectorLayer *>( sender() );
+  Q_ASSERT( l );
+
+  auto it = mPendingChanges.find( l );
+  if ( it == mPendingChanges.end() || it->deletedFeatureIds.isEmpty() )
+    return;
+
+  // features deleted within the destroyed command are restored, reverted values come through change signals
+  it->deletedFeatureIds.removeLast();
+  if ( !it->deletedFeatureIds.isEmpty() )
+    return;
+
+  applyPendingChanges( l, QgsFeatureIds() );
+}
+
+MultiFeatureListModelBase::PendingChanges *MultiFeatureListModelBase::pendingChanges( QgsVectorLayer *layer )
+{
+  auto it = mPendingChanges.find( layer );
+  return it != mPendingChanges.end() && !it->deletedFeatureIds.isEmpty() ? &it.value() : nullptr;
+}
+
+void MultiFeatureListModelBase::applyPendingChanges( QgsVectorLayer *layer, const QgsFeatureIds &deletedFeatureIds )
+{
+  const PendingChanges changes = mPendingChanges.take( layer );
+
+  auto applyChanges = [&changes]( QgsFeature &feature ) -> bool {
+    bool isChanged = false;
+    const auto attributesIt = changes.changedAttributeValues.constFind( feature.id() );
+    if ( attributesIt != changes.changedAttributeValues.constEnd() )
+    {
+      for ( auto it = attributesIt->constBegin(); it != attributesIt->constEnd(); ++it )
+        feature.setAttribute( it.key(), it.value() );
+      isChanged = true;
+    }
+
+    const auto geometryIt = changes.changedGeometries.constFind( feature.id() );
+    if ( geometryIt != changes.changedGeometries.constEnd() )
+    {
+      feature.setGeometry( geometryIt.value() );
+      isChanged = true;
+    }
+    return isChanged;
+  };
+
+  int firstChangedRow = -1;
+  int lastChangedRow = -1;
+  for ( int row = 0; row < mFeatures.size(); row++ )
+  {
+    QPair<QgsVectorLayer *, QgsFeature> &pair = mFeatures[row];
+    if ( pair.first != layer || deletedFeatureIds.contains( pair.second.id() ) )
+      continue;
+
+    if ( applyChanges( pair.second ) )
+    {
+      if ( firstChangedRow == -1 )
+        firstChangedRow = row;
+      lastChangedRow = row;
+    }
+  }
+
+  for ( auto &pair : mSelectedFeatures )
+  {
+    if ( pair.first == layer )
+      applyChanges( pair.second );
+  }
+
+  if ( firstChangedRow != -1 )
+  {
+    emit dataChanged( index( firstChangedRow, 0 ), index( lastChangedRow, 0 ) );
+  }
+
+  if ( deletedFeatureIds.isEmpty() )
+    return;
+
+  mSelectedFeatures.clear();
+  emit selectedCountChanged();
+
+  // rows are removed from the end, one removal per range of contiguous deleted features
+  bool hasRemovedRows = false;
+  int row = mFeatures.size() - 1;
+  while ( row >= 0 )
+  {
+    const QPair<QgsVectorLayer *, QgsFeature> &pair = mFeatures.at( row );
+    if ( pair.first != layer || !deletedFeatureIds.contains( pair.second.id() ) )
+    {
+      row--;
+      continue;
+    }
+
+    int firstRow = row;
+    while ( firstRow > 0 && mFeatures.at( firstRow - 1 ).first == layer && deletedFeatureIds.contains( mFeatures.at( firstRow - 1 ).second.id() ) )
+      firstRow--;
+
+    beginRemoveRows( QModelIndex(), firstRow, row );
+    mFeatures.erase( mFeatures.begin() + firstRow, mFeatures.begin() + row + 1 );
+    endRemoveRows();
+    hasRemovedRows = true;
+
+    row = firstRow - 1;
+  }
+
+  if ( hasRemovedRows )
+    emit countChanged();
+}
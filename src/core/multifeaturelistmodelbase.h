@@ -21,6 +21,7 @@
 #include "identifytool.h"
 
 #include <QAbstractItemModel>
+#include <qgsfeature.h>
 #include <qgsfeaturerequest.h>
 
 class MultiFeatureListModelBase : public QAbstractItemModel
@@ -160,7 +161,33 @@ class MultiFeatureListModelBase : public QAbstractItemModel
 
     void geometryChanged( QgsFeatureId fid, const QgsGeometry &geometry );
 
+    void editCommandStarted( const QString &text );
+
+    void editCommandEnded();
+
+    void editCommandDestroyed();
+
   private:
+    //! Changes made to a layer within edit commands, applied to the model at once when the outermost command is over
+    struct PendingChanges
+    {
+        //! Features deleted within each nested edit command, the last item matching the innermost command
+        QList<QgsFeatureIds> deletedFeatureIds;
+        QgsChangedAttributesMap changedAttributeValues;
+        QgsGeometryMap changedGeometries;
+    };
+
+    void connectLayer( QgsVectorLayer *layer );
+
+    //! Returns the selected features grouped by layer
+    QMap<QgsVectorLayer *, QgsFeatureList> selectedFeaturesPerLayer() const;
+
+    //! Applies the changes of \a layer made within edit commands along with the \a deletedFeatureIds, removing contiguous rows at once
+    void applyPendingChanges( QgsVectorLayer *layer, const QgsFeatureIds &deletedFeatureIds );
+
+    //! Returns the pending changes of a layer within an edit command, or NULLPTR when changes are applied right away
+    PendingChanges *pendingChanges( QgsVectorLayer *layer );
+
     inline QPair<QgsVectorLayer *, QgsFeature> *toFeature( const QModelIndex &index ) const
     {
       return static_cast<QPair<QgsVectorLayer *, QgsFeature> *>( index.internalPointer() );
@@ -168,6 +195,7 @@ class MultiFeatureListModelBase : public QAbstractItemModel
 
     QList<QPair<QgsVectorLayer *, QgsFeature>> mFeatures;
     QList<QPair<QgsVectorLayer *, QgsFeature>> mSelectedFeatures;
+    QHash<QgsVectorLayer *, PendingChanges> mPendingChanges;
 };
 
 #endif // MULTIFEATURELISTMODELBASE_H
@@ -54,12 +54,24 @@ void NetworkReply::ignoreSslErrors( const QList<QSslError> &errors )
 }
 
 
+QNetworkReply *NetworkReply::currentReply() const
+{
+  return mReply;
+}
+
+
 bool NetworkReply::isFinished() const
 {
   return mIsFinished;
 }
 
 
+void NetworkReply::setUnencodedPayload( const QByteArray &payload )
+{
+  mUnencodedPayloadByteArray = payload;
+}
+
+
 void NetworkReply::initiateRequest()
 {
   switch ( mOperation )
@@ -95,6 +107,7 @@ void NetworkReply::initiateRequest()
 
   connect( mReply, &QNetworkReply::finished, this, &NetworkReply::onFinished );
   connect( mReply, &QNetworkReply::encrypted, this, &NetworkReply::encrypted );
+  connect( mReply, &QNetworkReply::readyRead, this, &NetworkReply::readyRead );
   connect( mReply, &QNetworkReply::downloadProgress, this, &NetworkReply::downloadProgress );
   connect( mReply, &QNetworkReply::uploadProgress, this, &NetworkReply::uploadProgress );
   connect( mReply, &QNetworkReply::redirected, this, &NetworkReply::onRedirected );
@@ -121,6 +134,20 @@ void NetworkReply::onFinished()
   if ( mIsRedirected )
     return;
 
+  if ( !mUnencodedPayloadByteArray.isNull() && mReply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt() == 415 )
+  {
+    emit contentEncodingRejected();
+
+    // a null value removes the header
+    mRequest.setRawHeader( "Content-Encoding", QByteArray() );
+    mPayloadByteArray = mUnencodedPayloadByteArray;
+    mUnencodedPayloadByteArray = QByteArray();
+
+    mReply->deleteLater();
+    initiateRequest();
+    return;
+  }
+
   bool canRetry = false;
   QNetworkReply::NetworkError error = mReply->error();
 
@@ -65,6 +65,13 @@ class NetworkReply : public QObject
     QNetworkReply *reply() const;
 
 
+    /**
+     * Get the QNetworkReply object of the ongoing request attempt, allowing to consume the response as it arrives. Do not delete it manually.
+     * @return network reply of the current attempt
+     */
+    QNetworkReply *currentReply() const;
+
+
     /**
      * Reimplements QNetworkReply::ignoreSslErrors.
      * @param error a list of error to be ignored.
@@ -79,6 +86,13 @@ class NetworkReply : public QObject
     bool isFinished() const;
 
 
+    /**
+     * Sets the payload to send again without content encoding when the server rejects the encoded one with a 415 status.
+     * @param payload the request payload without content encoding
+     */
+    void setUnencodedPayload( const QByteArray &payload );
+
+
   signals:
 
     /**
@@ -87,7 +101,7 @@ class NetworkReply : public QObject
      * @param bytesSent
      * @param bytesTotal
      */
-    void downloadProgress( int bytesReceived, int bytesTotal );
+    void downloadProgress( qint64 bytesReceived, qint64 bytesTotal );
 
 
     /**
@@ -96,7 +110,14 @@ class NetworkReply : public QObject
      * @param bytesSent
      * @param bytesTotal
      */
-    void uploadProgress( int bytesSent, int bytesTotal );
+    void uploadProgress( qint64 bytesSent, qint64 bytesTotal );
+
+
+    /**
+     * Replicates `QNetworkReply::readyRead` signal. The data is available through currentReply().
+     * @note Because download may fail mid request and then retried, the data may be received again from the start.
+     */
+    void readyRead();
 
 
     /**
@@ -140,6 +161,12 @@ class NetworkReply : public QObject
     void errorOccurred( QNetworkReply::NetworkError code );
 
 
+    /**
+     * Emitted when the server rejected the content encoding of the request, which is then sent again without it.
+     */
+    void contentEncodingRejected();
+
+
     /**
      * Emitted when a new temporary error has occured. This is basically emitting the error that has occured during a retry.
      * @param code
@@ -208,7 +235,13 @@ class NetworkReply : public QObject
     /**
      * Request payload
      */
-    const QByteArray mPayloadByteArray;
+    QByteArray mPayloadByteArray;
+
+
+    /**
+     * Request payload without content encoding, sent if the encoded payload is rejected
+     */
+    QByteArray mUnencodedPayloadByteArray;
 
 
     /**
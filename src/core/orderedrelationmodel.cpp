@@ -122,7 +122,7 @@ void OrderedRelationModel::onViewCurrentFeatureChanged( int index )
   if ( index < 0 || index >= rowCount( QModelIndex() ) )
     return;
 
-  emit currentFeatureChanged( mEntries[index].referencingFeature );
+  emit currentFeatureChanged( mRelation.referencingLayer()->getFeature( mEntries[index].referencingFeature.id() ) );
 }
 
 bool OrderedRelationModel::moveItems( const int fromIdx, const int toIdx )
@@ -130,6 +130,75 @@ bool OrderedRelationModel::moveItems( const int fromIdx, const int toIdx )
   if ( fromIdx == toIdx )
     return false;
 
+  if ( fromIdx < 0 || fromIdx >= mEntries.count() || toIdx < 0 || toIdx >= mEntries.count() )
+    return false;
+
+  QList<int> rows;
+  rows.reserve( mEntries.count() );
+  for ( int i = 0; i < mEntries.count(); i++ )
+    rows << i;
+  rows.move( fromIdx, toIdx );
+
+  if ( !writeOrdering( rows ) )
+    return false;
+
+  beginMoveRows( QModelIndex(), fromIdx, fromIdx, QModelIndex(), fromIdx < toIdx ? toIdx + 1 : toIdx );
+  mEntries.move( fromIdx, toIdx );
+  endMoveRows();
+
+  emit dataChanged( index( std::min( fromIdx, toIdx ), 0 ), index( std::max( fromIdx, toIdx ), 0 ) );
+
+  return true;
+}
+
+bool OrderedRelationModel::reorderItems( const QList<int> &rows )
+{
+  if ( rows.count() != mEntries.count() )
+    return false;
+
+  QVector<bool> listedRows( rows.count(), false );
+  for ( const int row : rows )
+  {
+    if ( row < 0 || row >= rows.count() || listedRows.at( row ) )
+      return false;
+    listedRows[row] = true;
+  }
+
+  if ( !writeOrdering( rows ) )
+    return false;
+
+  // move the entries in place, filling positions from the top with the entries meant for them
+  QList<int> currentRows;
+  currentRows.reserve( rows.count() );
+  for ( int i = 0; i < rows.count(); i++ )
+    currentRows << i;
+
+  int firstMovedRow = -1;
+  int lastMovedRow = -1;
+  for ( int i = 0; i < rows.count(); i++ )
+  {
+    const int currentRow = currentRows.indexOf( rows.at( i ), i );
+    if ( currentRow == i )
+      continue;
+
+    beginMoveRows( QModelIndex(), currentRow, currentRow, QModelIndex(), i );
+    mEntries.move( currentRow, i );
+    currentRows.move( currentRow, i );
+    endMoveRows();
+
+    if ( firstMovedRow == -1 )
+      firstMovedRow = i;
+    lastMovedRow = std::max( lastMovedRow, currentRow );
+  }
+
+  if ( firstMovedRow != -1 )
+    emit dataChanged( index( firstMovedRow, 0 ), index( lastMovedRow, 0 ) );
+
+  return true;
+}
+
+bool OrderedRelationModel::writeOrdering( const QList<int> &rows )
+{
   if ( !mRelation.isValid() )
     return false;
 
@@ -139,12 +208,24 @@ bool OrderedRelationModel::moveItems( const int fromIdx, const int toIdx )
   if ( orderingFieldIdx == -1 )
     return false;
 
-  int startIdx = std::min( fromIdx, toIdx );
-  int endIdx = std::max( fromIdx, toIdx );
-  int delta = fromIdx > toIdx ? 1 : -1;
+  // only the span of moved entries gets renumbered, skipping entries already holding the right ordering
+  int startIdx = 0;
+  while ( startIdx < rows.count() && rows.at( startIdx ) == startIdx )
+    startIdx++;
+  int endIdx = rows.count() - 1;
+  while ( endIdx > startIdx && rows.at( endIdx ) == endIdx )
+    endIdx--;
 
-  if ( startIdx < 0 || endIdx >= mEntries.count() )
-    return false;
+  QMap<int, int> orderings;
+  for ( int i = startIdx; i <= endIdx; i++ )
+  {
+    const QVariant ordering = mEntries.at( rows.at( i ) ).referencingFeature.attribute( orderingFieldIdx );
+    if ( ordering.isNull() || ordering.toInt() != i + 1 )
+      orderings.insert( rows.at( i ), i + 1 );
+  }
+
+  if ( orderings.isEmpty() )
+    return true;
 
   if ( !referencingLayer->startEditing() )
   {
@@ -152,22 +233,24 @@ bool OrderedRelationModel::moveItems( const int fromIdx, const int toIdx )
     return false;
   }
 
-  for ( int i = startIdx; i <= endIdx; i++ )
+  // a single edit command and commit for the whole reordering
+  referencingLayer->beginEditCommand( tr( "Reorder related features" ) );
+  for ( auto it = orderings.constBegin(); it != orderings.constEnd(); ++it )
   {
-    int newIdx = ( i == fromIdx )
-                   ? toIdx + 1
-                   : mEntries[i].referencingFeature.attribute( orderingFieldIdx ).toInt() + delta;
-    bool isSuccess = referencingLayer->changeAttributeValue( mEntries[i].referencingFeature.id(), orderingFieldIdx, newIdx );
-
-    if ( !isSuccess )
+    const QgsFeature &feature = mEntries.at( it.key() ).referencingFeature;
+    const QgsAttributeMap newValues { { orderingFieldIdx, it.value() } };
+    const QgsAttributeMap oldValues { { orderingFieldIdx, feature.attribute( orderingFieldIdx ) } };
+    if ( !referencingLayer->changeAttributeValues( feature.id(), newValues, oldValues ) )
     {
-      if ( referencingLayer->rollBack() )
+      referencingLayer->destroyEditCommand();
+      if ( !referencingLayer->rollBack() )
         QgsMessageLog::logMessage( tr( "Cannot rollback layer changes in layer %1" ).arg( referencingLayer->name() ), "QField", Qgis::Critical );
 
       emit failedReorder();
       return false;
     }
   }
+  referencingLayer->endEditCommand();
 
   if ( !referencingLayer->commitChanges() )
   {
@@ -179,7 +262,19 @@ bool OrderedRelationModel::moveItems( const int fromIdx, const int toIdx )
     return false;
   }
 
-  reload();
+  // refresh the affected entries instead of gathering them all again
+  QList<QgsFeatureId> featureIds;
+  QHash<QgsFeatureId, int> featureRows;
+  for ( auto it = orderings.constBegin(); it != orderings.constEnd(); ++it )
+  {
+    const QgsFeatureId featureId = mEntries.at( it.key() ).referencingFeature.id();
+    featureIds << featureId;
+    featureRows.insert( featureId, it.key() );
+  }
+
+  const QList<Entry> entries = collectEntries( mRelation, mNmRelation, featureIds, entryAttributes(), entryNeedsGeometry() );
+  for ( const Entry &entry : entries )
+    mEntries[featureRows.value( entry.referencingFeature.id() )] = entry;
 
   return true;
 }
@@ -191,26 +286,31 @@ bool OrderedRelationModel::beforeDeleteFeature( QgsVectorLayer *referencingLayer
   if ( orderingFieldIdx == -1 )
     return false;
 
-  // first try to update the ordering the of the related features
-  bool isSuccess = false;
-  int ordering = -1;
-  for ( const Entry &entry : std::as_const( mEntries ) )
+  const QVariant deletedOrdering = referencingLayer->getFeature( referencingFeatureId ).attribute( orderingFieldIdx );
+  if ( deletedOrdering.isNull() )
+    return true;
+
+  // the following features may not all be loaded in the model, fetch them from the layer
+  QgsFeatureRequest request = mRelation.getRelatedFeaturesRequest( mFeature );
+  request.combineFilterExpression( QStringLiteral( "%1 > %2" ).arg( QgsExpression::quotedColumnRef( mOrderingField ) ).arg( deletedOrdering.toInt() ) );
+  request.setOrderBy( orderBy() );
+  request.setFlags( QgsFeatureRequest::NoGeometry );
+  request.setSubsetOfAttributes( QgsAttributeList() << orderingFieldIdx );
+
+  QList<QPair<QgsFeatureId, QVariant>> followingOrderings;
+  QgsFeatureIterator it = referencingLayer->getFeatures( request );
+  QgsFeature feature;
+  while ( it.nextFeature( feature ) )
   {
-    // find the deleted feature
-    if ( entry.referencingFeature.id() == referencingFeatureId )
-    {
-      ordering = entry.referencingFeature.attribute( mOrderingField ).toInt();
-      continue;
-    }
-
-    // skip until the deleted feature is looped and the ordering has an absolute value
-    if ( ordering == -1 )
-      continue;
-
-    Q_ASSERT( ordering <= entry.referencingFeature.attribute( orderingFieldIdx ).toInt() );
+    if ( feature.id() != referencingFeatureId )
+      followingOrderings << qMakePair( feature.id(), feature.attribute( orderingFieldIdx ) );
+  }
 
-    int newOrdering = ordering;
-    isSuccess = referencingLayer->changeAttributeValue( entry.referencingFeature.id(), orderingFieldIdx, newOrdering );
+  // first try to update the ordering the of the related features
+  int ordering = deletedOrdering.toInt();
+  for ( const QPair<QgsFeatureId, QVariant> &followingOrdering : std::as_const( followingOrderings ) )
+  {
+    bool isSuccess = referencingLayer->changeAttributeValue( followingOrdering.first, orderingFieldIdx, ordering, followingOrdering.second );
 
     if ( !isSuccess )
     {
@@ -229,9 +329,27 @@ bool OrderedRelationModel::beforeDeleteFeature( QgsVectorLayer *referencingLayer
   return true;
 }
 
-void OrderedRelationModel::sortEntries()
+QgsFeatureRequest::OrderBy OrderedRelationModel::orderBy() const
+{
+  if ( mOrderingField.isEmpty() )
+    return ReferencingFeatureListModel::orderBy();
+
+  // features lacking an ordering come first
+  return QgsFeatureRequest::OrderBy( { QgsFeatureRequest::OrderByClause( QgsExpression::quotedColumnRef( mOrderingField ), true, true ) } );
+}
+
+QSet<QString> OrderedRelationModel::entryAttributes() const
+{
+  // the ordering and the attributes needed by the image path and description expressions
+  QSet<QString> attributes;
+  attributes << mOrderingField;
+  attributes.unite( QgsExpression( mImagePath ).referencedColumns() );
+  attributes.unite( QgsExpression( mDescription ).referencedColumns() );
+  return attributes;
+}
+
+bool OrderedRelationModel::entryNeedsGeometry() const
 {
-  std::sort( mEntries.begin(), mEntries.end(), [=]( const Entry &e1, const Entry &e2 ) {
-    return e1.referencingFeature.attribute( mOrderingField ).toInt() < e2.referencingFeature.attribute( mOrderingField ).toInt();
-  } );
+  // e.g. a description showing the length or area of the child feature
+  return QgsExpression( mImagePath ).needsGeometry() || QgsExpression( mDescription ).needsGeometry();
 }
@@ -50,7 +50,20 @@ class OrderedRelationModel : public ReferencingFeatureListModel
     QString description() const;
     void setDescription( const QString &description );
     QVariant data( const QModelIndex &index, int role = Qt::DisplayRole ) const override;
+
+    /**
+     * Moves the item at \a fromIdx to \a toIdx, writing the resulting ordering to the referencing layer
+     * \returns TRUE on success
+     */
     Q_INVOKABLE bool moveItems( const int fromIdx, const int toIdx );
+
+    /**
+     * Reorders all items at once, the item currently at row \a rows[i] ends up at row i.
+     * Only the changed orderings are written to the referencing layer, within a single edit command and commit.
+     * \returns TRUE on success
+     */
+    Q_INVOKABLE bool reorderItems( const QList<int> &rows );
+
     QHash<int, QByteArray> roleNames() const override;
 
   signals:
@@ -65,7 +78,11 @@ class OrderedRelationModel : public ReferencingFeatureListModel
 
   private:
     bool beforeDeleteFeature( QgsVectorLayer *referencingLayer, QgsFeatureId referencingFeatureId ) override;
-    void sortEntries() override;
+    QgsFeatureRequest::OrderBy orderBy() const override;
+    QSet<QString> entryAttributes() const override;
+    bool entryNeedsGeometry() const override;
+    //! Writes the ordering resulting from \a rows to the referencing layer and the affected entries, without moving them
+    bool writeOrdering( const QList<int> &rows );
 
     QString mOrderingField;
     QString mImagePath;
@@ -0,0 +1,211 @@
+/***************************************************************************
+  printlayoutexportjob.cpp - PrintLayoutExportJob
+
+ ---------------------
+ begin                : October 2026
+ copyright            : (C) 2026 by OPENGIS.ch
+ email                : info at opengis dot ch
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "printlayoutexportjob.h"
+
+#include <QTimer>
+#include <qgslayoutatlas.h>
+#include <qgslogger.h>
+#include <qgsprintlayout.h>
+
+PrintLayoutExportJob::PrintLayoutExportJob( QgsPrintLayout *layout, const QString &destination, QObject *parent )
+  : QObject( parent )
+  , mLayout( layout->clone() )
+  , mDestination( destination )
+{
+}
+
+PrintLayoutExportJob::~PrintLayoutExportJob()
+{
+  mFeedback.cancel();
+  mExporter.reset();
+  if ( mIsAtlasRendering )
+    mLayout->atlas()->endRender();
+}
+
+bool PrintLayoutExportJob::start()
+{
+  if ( mIsRunning || !mLayout )
+    return false;
+
+  QgsLayoutAtlas *atlas = mLayout->atlas();
+  const bool hasAtlas = atlas && atlas->enabled();
+
+  mPageCount = 1;
+  if ( hasAtlas )
+  {
+    mPageCount = atlas->updateFeatures();
+    if ( mPageCount == 0 )
+      return false;
+  }
+
+  mExportedPages = 0;
+  mError.clear();
+  mIsRunning = true;
+  setProgress( 0.0 );
+
+  // leave the caller a chance to show the export progress before the first page gets rendered
+  QTimer::singleShot( 0, this, [=]() {
+    if ( !hasAtlas )
+      exportLayout();
+    else if ( exportToPdf && singleFile )
+      exportAtlasToPdf();
+    else
+      exportNextAtlasPage();
+  } );
+
+  return true;
+}
+
+void PrintLayoutExportJob::cancel()
+{
+  mFeedback.cancel();
+}
+
+void PrintLayoutExportJob::exportLayout()
+{
+  if ( !mFeedback.isCanceled() )
+  {
+    QgsLayoutExporter exporter( mLayout.get() );
+    mIsExporting = true;
+    const QgsLayoutExporter::ExportResult result = exportToPdf
+                                                     ? exporter.exportToPdf( mDestination, pdfSettings )
+                                                     : exporter.exportToImage( mDestination, imageSettings );
+    mIsExporting = false;
+
+    if ( result != QgsLayoutExporter::Success )
+    {
+      mError = tr( "Failed to export the layout to `%1`" ).arg( exporter.errorFile().isEmpty() ? mDestination : exporter.errorFile() );
+    }
+    else
+    {
+      mExportedPages = 1;
+      setProgress( 1.0 );
+    }
+  }
+
+  finish();
+}
+
+void PrintLayoutExportJob::exportAtlasToPdf()
+{
+  if ( !mFeedback.isCanceled() )
+  {
+    // all pages go through a single PDF writer within one call, the event loop can't run in between them
+    // without letting the project change under the layout being rendered
+    const QMetaObject::Connection connection = connect( &mFeedback, &QgsFeedback::progressChanged, this, [=]( double progress ) {
+      setProgress( progress / 100.0 );
+    } );
+
+    mIsExporting = true;
+    const QgsLayoutExporter::ExportResult result = QgsLayoutExporter::exportToPdf( mLayout->atlas(), mDestination, pdfSettings, mError, &mFeedback );
+    mIsExporting = false;
+
+    disconnect( connection );
+
+    if ( result != QgsLayoutExporter::Success && result != QgsLayoutExporter::Canceled && mError.isEmpty() )
+      mError = tr( "Failed to export the atlas to `%1`" ).arg( mDestination );
+  }
+
+  finish();
+}
+
+void PrintLayoutExportJob::exportNextAtlasPage()
+{
+  QgsLayoutAtlas *atlas = mLayout->atlas();
+
+  if ( mFeedback.isCanceled() )
+  {
+    finish();
+    return;
+  }
+
+  if ( !mIsAtlasRendering )
+  {
+    if ( !atlas->beginRender() )
+    {
+      mError = tr( "Failed to prepare the atlas for rendering" );
+      finish();
+      return;
+    }
+
+    mIsAtlasRendering = true;
+    mExporter = std::make_unique<QgsLayoutExporter>( mLayout.get() );
+  }
+
+  const int page = mExportedPages;
+  if ( !atlas->seekTo( page ) )
+  {
+    mError = tr( "Failed to render atlas page %1" ).arg( page + 1 );
+    finish();
+    return;
+  }
+
+  const QString filePath = atlas->filePath( mDestination, exportToPdf ? QStringLiteral( "pdf" ) : imageExtension );
+  mIsExporting = true;
+  const QgsLayoutExporter::ExportResult result = exportToPdf
+                                                   ? mExporter->exportToPdf( filePath, pdfSettings )
+                                                   : mExporter->exportToImage( filePath, imageSettings );
+  mIsExporting = false;
+
+  if ( result != QgsLayoutExporter::Success )
+  {
+    mError = tr( "Failed to export atlas page %1 to `%2`" ).arg( page + 1 ).arg( mExporter->errorFile().isEmpty() ? filePath : mExporter->errorFile() );
+    finish();
+    return;
+  }
+
+  mExportedPages++;
+  setProgress( static_cast<double>( mExportedPages ) / mPageCount );
+
+  if ( mExportedPages == mPageCount )
+  {
+    finish();
+    return;
+  }
+
+  // pages land in separate files, let the event loop run in between
+  QTimer::singleShot( 0, this, &PrintLayoutExportJob::exportNextAtlasPage );
+}
+
+void PrintLayoutExportJob::finish()
+{
+  mExporter.reset();
+  if ( mIsAtlasRendering )
+  {
+    mLayout->atlas()->endRender();
+    mIsAtlasRendering = false;
+  }
+
+  mIsRunning = false;
+
+  if ( mFeedback.isCanceled() && mError.isEmpty() )
+    mError = tr( "The export was canceled" );
+
+  if ( !mError.isEmpty() )
+    QgsLogger::warning( QStringLiteral( "Print layout export to `%1` failed: %2" ).arg( mDestination, mError ) );
+
+  emit finished( mError.isEmpty(), mError );
+}
+
+void PrintLayoutExportJob::setProgress( double progress )
+{
+  if ( mProgress == progress )
+    return;
+
+  mProgress = progress;
+  emit progressChanged( mProgress );
+}
@@ -0,0 +1,113 @@
+/***************************************************************************
+  printlayoutexportjob.h - PrintLayoutExportJob
+
+ ---------------------
+ begin                : October 2026
+ copyright            : (C) 2026 by OPENGIS.ch
+ email                : info at opengis dot ch
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef PRINTLAYOUTEXPORTJOB_H
+#define PRINTLAYOUTEXPORTJOB_H
+
+#include <QObject>
+#include <memory>
+#include <qgsfeedback.h>
+#include <qgslayoutexporter.h>
+
+class QgsPrintLayout;
+
+/**
+ * \class PrintLayoutExportJob
+ * Exports a print layout, reporting progress and supporting cancellation.
+ *
+ * Layouts render project layers, which are only safe to access from the main thread, hence the export
+ * runs on the main thread and blocks it while a page is rendered. Atlas pages exported to individual files
+ * are exported one at a time with the event loop running in between, which is when the export can be
+ * canceled. A single layout and an atlas exported to a single PDF file are rendered in one go.
+ *
+ * The layout is cloned when the job is created, changes made to the project layout afterwards do not
+ * affect the export.
+ */
+class PrintLayoutExportJob : public QObject
+{
+    Q_OBJECT
+
+  public:
+    /**
+     * Constructor
+     * \param layout the layout to export, cloned right away
+     * \param destination the exported file path, or the base file path of atlas pages
+     * \param parent the parent object
+     */
+    PrintLayoutExportJob( QgsPrintLayout *layout, const QString &destination, QObject *parent = nullptr );
+    ~PrintLayoutExportJob() override;
+
+    QgsLayoutExporter::PdfExportSettings pdfSettings;
+    QgsLayoutExporter::ImageExportSettings imageSettings;
+    QString imageExtension = QStringLiteral( "jpg" );
+
+    //! Whether the atlas pages are exported to a single file, defaults to TRUE
+    bool singleFile = true;
+
+    //! Whether the layout is exported to PDF, images are exported otherwise, defaults to TRUE
+    bool exportToPdf = true;
+
+    //! Returns the destination of the export
+    QString destination() const { return mDestination; }
+
+    //! Returns the export progress, from 0 to 1
+    double progress() const { return mProgress; }
+
+    //! Returns whether the job is running
+    bool isRunning() const { return mIsRunning; }
+
+    /**
+     * Returns whether the job is in the middle of exporting a page, e.g. when a layer renderer runs a local
+     * event loop while fetching remote data. The job must not be deleted right away then, see QObject::deleteLater().
+     */
+    bool isExporting() const { return mIsExporting; }
+
+    /**
+     * Starts the export, the first page is exported once the event loop runs.
+     * \returns FALSE if the layout has nothing to export
+     */
+    bool start();
+
+    //! Cancels the export, finished will be emitted once the page being exported is done
+    void cancel();
+
+  signals:
+    void progressChanged( double progress );
+
+    //! Emitted once the export is over, \a success is FALSE if it failed or was canceled
+    void finished( bool success, const QString &error );
+
+  private:
+    void exportLayout();
+    void exportAtlasToPdf();
+    void exportNextAtlasPage();
+    void finish();
+    void setProgress( double progress );
+
+    std::unique_ptr<QgsPrintLayout> mLayout;
+    std::unique_ptr<QgsLayoutExporter> mExporter;
+    QString mDestination;
+    QgsFeedback mFeedback;
+    bool mIsRunning = false;
+    bool mIsExporting = false;
+    bool mIsAtlasRendering = false;
+    int mPageCount = 0;
+    int mExportedPages = 0;
+    double mProgress = 0.0;
+    QString mError;
+};
+
+#endif // PRINTLAYOUTEXPORTJOB_H
@@ -28,11 +28,17 @@
 #include <QTextDocument>
 #include <QTimer>
 #include <QUrlQuery>
+#include <algorithm>
 #include <qgsapplication.h>
 #include <qgsmessagelog.h>
 #include <qgsnetworkaccessmanager.h>
 #include <qgssettings.h>
+#include <qgsziputils.h>
 
+#define MAX_PARALLEL_ATTACHMENT_UPLOADS 3
+#define MAX_ATTACHMENT_UPLOAD_ATTEMPTS 4
+#define ATTACHMENT_UPLOAD_RETRY_DELAY 5000
+#define MIN_COMPRESSED_REQUEST_BODY_SIZE 1024
 
 QFieldCloudConnection::QFieldCloudConnection()
   : mUrl( QSettings().value( QStringLiteral( "/QFieldCloud/url" ), defaultUrl() ).toString() )
@@ -138,13 +144,27 @@ CloudUserInformation QFieldCloudConnection::userInformation() const
 
 void QFieldCloudConnection::login()
 {
-  NetworkReply *reply = ( !mToken.isEmpty() && ( mPassword.isEmpty() || mUsername.isEmpty() ) )
-                          ? get( QStringLiteral( "/api/v1/auth/user/" ) )
-                          : post( QStringLiteral( "/api/v1/auth/token/" ), QVariantMap(
-                                                                             {
-                                                                               { "username", mUsername },
-                                                                               { "password", mPassword },
-                                                                             } ) );
+  NetworkReply *reply = nullptr;
+  if ( !mToken.isEmpty() && ( mPassword.isEmpty() || mUsername.isEmpty() ) )
+  {
+    reply = get( QStringLiteral( "/api/v1/auth/user/" ) );
+  }
+  else
+  {
+    // the token request is not tracked, a rejected login must neither count as pending nor invalidate the session
+    QNetworkRequest request( mUrl + QStringLiteral( "/api/v1/auth/token/" ) );
+    request.setHeader( QNetworkRequest::ContentTypeHeader, "application/json" );
+    request.setAttribute( QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::RedirectPolicy::NoLessSafeRedirectPolicy );
+    setAuthenticationToken( request );
+    setClientHeaders( request );
+
+    const QVariantMap params(
+      {
+        { "username", mUsername },
+        { "password", mPassword },
+      } );
+    reply = NetworkManager::post( request, QJsonDocument( QJsonObject::fromVariantMap( params ) ).toJson( QJsonDocument::Compact ) );
+  }
 
   setStatus( ConnectionStatus::Connecting );
 
@@ -249,27 +269,70 @@ QFieldCloudConnection::ConnectionState QFieldCloudConnection::state() const
   return mState;
 }
 
-NetworkReply *QFieldCloudConnection::post( const QString &endpoint, const QVariantMap &params, const QStringList &fileNames )
+NetworkReply *QFieldCloudConnection::post( const QString &endpoint, const QVariantMap &params, const QStringList &fileNames, bool compressFiles )
 {
   QNetworkRequest request( mUrl + endpoint );
-  QByteArray requestBody = QJsonDocument( QJsonObject::fromVariantMap( params ) ).toJson();
+  QByteArray requestBody = QJsonDocument( QJsonObject::fromVariantMap( params ) ).toJson( QJsonDocument::Compact );
   setAuthenticationToken( request );
   request.setAttribute( QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::RedirectPolicy::NoLessSafeRedirectPolicy );
 
   if ( fileNames.isEmpty() )
   {
     request.setHeader( QNetworkRequest::ContentTypeHeader, "application/json" );
+    const QByteArray unencodedBody = requestBody;
+    compressRequestBody( request, requestBody );
+
+    // tracked like any other request, so a rejected compressed body turns compression off
+    NetworkReply *reply = post( request, endpoint, requestBody );
+    if ( requestBody != unencodedBody )
+      reply->setUnencodedPayload( unencodedBody );
+
+    return reply;
+  }
+
+  if ( compressFiles && mServerAcceptsGzip && !mGzipRejected )
+  {
+    // a gzip content encoding applies to the whole body, hence the multipart body is assembled in memory
+    const QByteArray boundary = QByteArrayLiteral( "qfield-boundary-" ) + QByteArray::number( QDateTime::currentMSecsSinceEpoch(), 16 );
+    QByteArray multiPartBody;
+    multiPartBody += "--" + boundary + "\r\n";
+    multiPartBody += "Content-Type: application/json\r\n";
+    multiPartBody += "Content-Disposition: form-data; name=\"text\"\r\n\r\n";
+    multiPartBody += requestBody + "\r\n";
+
+    for ( const QString &fileName : fileNames )
+    {
+      QFile file( fileName );
+
+      if ( !file.open( QIODevice::ReadOnly ) )
+        return nullptr;
 
-    return NetworkManager::post( request, requestBody );
+      multiPartBody += "--" + boundary + "\r\n";
+      multiPartBody += "Content-Type: application/json\r\n";
+      multiPartBody += QStringLiteral( "Content-Disposition: form-data; name=\"file\"; filename=\"%1\"\r\n\r\n" ).arg( fileName ).toUtf8();
+      multiPartBody += file.readAll() + "\r\n";
+    }
+    multiPartBody += "--" + boundary + "--\r\n";
+
+    request.setHeader( QNetworkRequest::ContentTypeHeader, QByteArray( "multipart/form-data; boundary=" ) + boundary );
+    setClientHeaders( request );
+    const QByteArray unencodedBody = multiPartBody;
+    compressRequestBody( request, multiPartBody );
+
+    NetworkReply *reply = NetworkManager::post( request, multiPartBody );
+    if ( multiPartBody != unencodedBody )
+      reply->setUnencodedPayload( unencodedBody );
+    trackRequest( reply );
+
+    return reply;
   }
 
   QHttpMultiPart *multiPart = new QHttpMultiPart( QHttpMultiPart::FormDataType );
   QHttpPart textPart;
 
-  QJsonDocument doc( QJsonObject::fromVariantMap( params ) );
   textPart.setHeader( QNetworkRequest::ContentTypeHeader, QVariant( "application/json" ) );
   textPart.setHeader( QNetworkRequest::ContentDispositionHeader, QVariant( "form-data; name=\"text\"" ) );
-  textPart.setBody( doc.toJson() );
+  textPart.setBody( requestBody );
 
   multiPart->append( textPart );
 
@@ -295,25 +358,25 @@ NetworkReply *QFieldCloudConnection::post( const QString &endpoint, const QVaria
 
   multiPart->setParent( reply );
 
-  mPendingRequests++;
-  setState( ConnectionState::Busy );
-  connect( reply, &NetworkReply::finished, this, [=]() {
-    QNetworkReply *rawReply = reply->reply();
-    if ( --mPendingRequests == 0 )
-    {
-      if ( rawReply->error() != QNetworkReply::NoError )
-      {
-        int httpCode = rawReply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt();
-        if ( httpCode == 401 )
-        {
-          // Access token has been invalidated remotely
-          invalidateToken();
-          setStatus( ConnectionStatus::Disconnected );
-        }
-      }
-      setState( ConnectionState::Idle );
-    }
-  } );
+  trackRequest( reply );
+
+  return reply;
+}
+
+NetworkReply *QFieldCloudConnection::post( QNetworkRequest &request, const QString &endpoint, const QByteArray &payload )
+{
+  QUrl url( endpoint );
+
+  if ( url.isRelative() )
+    url.setUrl( mUrl + endpoint );
+
+  request.setUrl( url );
+
+  setClientHeaders( request );
+
+  NetworkReply *reply = NetworkManager::post( request, payload );
+
+  trackRequest( reply );
 
   return reply;
 }
@@ -356,25 +419,7 @@ NetworkReply *QFieldCloudConnection::get( QNetworkRequest &request, const QUrl &
 
   NetworkReply *reply = NetworkManager::get( request );
 
-  mPendingRequests++;
-  setState( ConnectionState::Busy );
-  connect( reply, &NetworkReply::finished, this, [=]() {
-    QNetworkReply *rawReply = reply->reply();
-    if ( --mPendingRequests == 0 )
-    {
-      if ( rawReply->error() != QNetworkReply::NoError )
-      {
-        int httpCode = rawReply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt();
-        if ( httpCode == 401 )
-        {
-          // Access token has been invalidated remotely
-          invalidateToken();
-          setStatus( ConnectionStatus::Disconnected );
-        }
-      }
-      setState( ConnectionState::Idle );
-    }
-  } );
+  trackRequest( reply );
 
   // assume all redirect will never emit "redirected"
   connect( reply, &NetworkReply::redirected, this, [=]() {
@@ -445,6 +490,57 @@ void QFieldCloudConnection::setClientHeaders( QNetworkRequest &request )
   }
 }
 
+void QFieldCloudConnection::compressRequestBody( QNetworkRequest &request, QByteArray &body ) const
+{
+  if ( !mServerAcceptsGzip || mGzipRejected || body.size() < MIN_COMPRESSED_REQUEST_BODY_SIZE )
+    return;
+
+  QByteArray compressedBody;
+  if ( !QgsZipUtils::encodeGzip( body, compressedBody ) || compressedBody.size() >= body.size() )
+    return;
+
+  body = compressedBody;
+  request.setRawHeader( "Content-Encoding", "gzip" );
+}
+
+void QFieldCloudConnection::trackRequest( NetworkReply *reply )
+{
+  mPendingRequests++;
+  setState( ConnectionState::Busy );
+
+  // the rejected request is sent again uncompressed by the reply itself
+  connect( reply, &NetworkReply::contentEncodingRejected, this, [=]() {
+    if ( !mGzipRejected )
+      QgsMessageLog::logMessage( tr( "The server rejected a compressed request, requests will not be compressed anymore" ), QStringLiteral( "QFieldCloud" ) );
+    mGzipRejected = true;
+  } );
+
+  connect( reply, &NetworkReply::finished, this, [=]() {
+    QNetworkReply *rawReply = reply->reply();
+    const int httpCode = rawReply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt();
+
+    // servers advertise the request content encodings they understand through the Accept-Encoding response header (RFC 7694)
+    if ( rawReply->hasRawHeader( "Accept-Encoding" ) )
+    {
+      mServerAcceptsGzip = rawReply->rawHeader( "Accept-Encoding" ).toLower().contains( "gzip" );
+    }
+
+    if ( --mPendingRequests == 0 )
+    {
+      if ( rawReply->error() != QNetworkReply::NoError )
+      {
+        if ( httpCode == 401 )
+        {
+          // Access token has been invalidated remotely
+          invalidateToken();
+          setStatus( ConnectionStatus::Disconnected );
+        }
+      }
+      setState( ConnectionState::Idle );
+    }
+  } );
+}
+
 QFieldCloudConnection::CloudError::CloudError( QNetworkReply *reply )
 {
   if ( !reply )
@@ -524,20 +620,25 @@ QFieldCloudConnection::CloudError::CloudError( QNetworkReply *reply )
 int QFieldCloudConnection::uploadPendingAttachments()
 {
   if ( mUploadingAttachments )
-    return 0;
+    return mUploadCount;
 
   QMultiMap<QString, QString> attachments = QFieldCloudUtils::getPendingAttachments();
   if ( attachments.isEmpty() )
   {
+    mFailedAttachments.clear();
     emit pendingAttachmentsUploadFinished();
     return 0;
   }
 
-  mUploadCount = attachments.size();
+  mUploadingAttachments = true;
+  mUploadCount = 0;
+  mAttachmentsQueue.clear();
+
   QMultiMap<QString, QString>::const_iterator it = attachments.constBegin();
-  while ( it != attachments.constEnd() )
+  for ( ; it != attachments.constEnd(); ++it )
   {
-    if ( !QFileInfo( it.value() ).exists() )
+    const QFileInfo fileInfo( it.value() );
+    if ( !fileInfo.exists() )
     {
       // A pending attachment has been deleted from the local device, remove
       // This can happen when for e.g. users remove a cloud project from their devices
@@ -545,41 +646,113 @@ int QFieldCloudConnection::uploadPendingAttachments()
       continue;
     }
 
-    QFileInfo projectInfo( QFieldCloudUtils::localProjectFilePath( mUsername, it.key() ) );
-    QDir projectDir( projectInfo.absolutePath() );
-    const QString apiPath = projectDir.relativeFilePath( it.value() );
-    NetworkReply *attachmentCloudReply = post( QStringLiteral( "/api/v1/files/%1/%2/" ).arg( it.key(), apiPath ), QVariantMap(), QStringList( { it.value() } ) );
+    // Attachments which failed to upload during this run are left for the next run
+    if ( mFailedAttachments.contains( QStringLiteral( "%1/%2" ).arg( it.key(), it.value() ) ) )
+      continue;
 
-    QString projectId = it.key();
-    QString fileName = it.value();
-    connect( attachmentCloudReply, &NetworkReply::finished, this, [=]() {
-      QNetworkReply *attachmentReply = attachmentCloudReply->reply();
-      attachmentCloudReply->deleteLater();
+    PendingAttachment attachment;
+    attachment.projectId = it.key();
+    attachment.fileName = it.value();
+    attachment.size = fileInfo.size();
+    attachment.lastModified = fileInfo.lastModified();
+    mAttachmentsQueue << attachment;
+  }
 
-      Q_ASSERT( attachmentCloudReply->isFinished() );
-      Q_ASSERT( attachmentReply );
+  // Send the smallest attachments first so that as many as possible reach the cloud on a poor connection,
+  // older attachments go first amongst same-sized ones
+  std::stable_sort( mAttachmentsQueue.begin(), mAttachmentsQueue.end(), []( const PendingAttachment &a, const PendingAttachment &b ) {
+    if ( a.size != b.size )
+      return a.size < b.size;
+    return a.lastModified < b.lastModified;
+  } );
 
-      // if there is an error, don't panic, we continue uploading. The files may be later manually synced.
-      if ( attachmentReply->error() != QNetworkReply::NoError )
-      {
-        QgsMessageLog::logMessage( tr( "Failed to upload attachment stored at `%1`, reason:\n%2" )
-                                     .arg( fileName )
-                                     .arg( QFieldCloudConnection::errorString( attachmentReply ) ) );
-      }
-      else
-      {
-        QFieldCloudUtils::removePendingAttachment( projectId, fileName );
-      }
+  mUploadCount = mAttachmentsQueue.size();
+  if ( mUploadCount == 0 )
+  {
+    mUploadingAttachments = false;
+    mFailedAttachments.clear();
+    emit pendingAttachmentsUploadFinished();
+    return 0;
+  }
 
-      mUploadCount--;
-      if ( mUploadCount == 0 )
-      {
-        // Once a batch of uploads has been successfully sent, check for any new attachments that would have been added in the meantime
-        uploadPendingAttachments();
-      }
-    } );
+  processAttachmentsQueue();
 
-    ++it;
-  }
   return mUploadCount;
 }
+
+void QFieldCloudConnection::processAttachmentsQueue()
+{
+  while ( mActiveAttachmentUploads < MAX_PARALLEL_ATTACHMENT_UPLOADS && !mAttachmentsQueue.isEmpty() )
+  {
+    uploadAttachment( mAttachmentsQueue.takeFirst() );
+  }
+
+  if ( mUploadCount == 0 )
+  {
+    mUploadingAttachments = false;
+
+    // Once a batch of uploads has been sent, check for any new attachments that would have been added in the meantime
+    uploadPendingAttachments();
+  }
+}
+
+void QFieldCloudConnection::uploadAttachment( const PendingAttachment &attachment )
+{
+  if ( !QFileInfo::exists( attachment.fileName ) )
+  {
+    QFieldCloudUtils::removePendingAttachment( attachment.projectId, attachment.fileName );
+    mUploadCount--;
+    return;
+  }
+
+  QFileInfo projectInfo( QFieldCloudUtils::localProjectFilePath( mUsername, attachment.projectId ) );
+  QDir projectDir( projectInfo.absolutePath() );
+  const QString apiPath = projectDir.relativeFilePath( attachment.fileName );
+  NetworkReply *attachmentCloudReply = post( QStringLiteral( "/api/v1/files/%1/%2/" ).arg( attachment.projectId, apiPath ), QVariantMap(), QStringList( { attachment.fileName } ) );
+
+  mActiveAttachmentUploads++;
+
+  connect( attachmentCloudReply, &NetworkReply::finished, this, [=]() {
+    QNetworkReply *attachmentReply = attachmentCloudReply->reply();
+    attachmentCloudReply->deleteLater();
+
+    Q_ASSERT( attachmentCloudReply->isFinished() );
+    Q_ASSERT( attachmentReply );
+
+    mActiveAttachmentUploads--;
+
+    if ( attachmentReply->error() == QNetworkReply::NoError )
+    {
+      QFieldCloudUtils::removePendingAttachment( attachment.projectId, attachment.fileName );
+      mUploadCount--;
+      processAttachmentsQueue();
+      return;
+    }
+
+    const int httpStatus = attachmentReply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt();
+    const bool isRetriable = httpStatus == 0 || httpStatus == 408 || httpStatus == 429 || httpStatus >= 500;
+    if ( isRetriable && attachment.attempts + 1 < MAX_ATTACHMENT_UPLOAD_ATTEMPTS )
+    {
+      PendingAttachment retryAttachment = attachment;
+      retryAttachment.attempts++;
+
+      // Back off exponentially, the attachment keeps counting as pending until it is re-queued
+      const int delay = ATTACHMENT_UPLOAD_RETRY_DELAY * ( 1 << attachment.attempts );
+      QTimer::singleShot( delay, this, [=]() {
+        mAttachmentsQueue.prepend( retryAttachment );
+        processAttachmentsQueue();
+      } );
+      processAttachmentsQueue();
+      return;
+    }
+
+    // if there is an error, don't panic, we continue uploading. The files may be later manually synced.
+    QgsMessageLog::logMessage( tr( "Failed to upload attachment stored at `%1`, reason:\n%2" )
+                                 .arg( attachment.fileName )
+                                 .arg( QFieldCloudConnection::errorString( attachmentReply ) ) );
+
+    mFailedAttachments << QStringLiteral( "%1/%2" ).arg( attachment.projectId, attachment.fileName );
+    mUploadCount--;
+    processAttachmentsQueue();
+  } );
+}
@@ -19,8 +19,10 @@
 #include "networkmanager.h"
 #include "networkreply.h"
 
+#include <QDateTime>
 #include <QJsonDocument>
 #include <QObject>
+#include <QSet>
 #include <QVariantMap>
 
 
@@ -137,10 +139,20 @@ class QFieldCloudConnection : public QObject
     /**
      * Sends a post request with the given \a parameters to the given \a endpoint.
      *
+     * When \a compressFiles is TRUE and the server advertised gzip support, the multipart
+     * body holding the \a fileNames is sent gzip compressed.
+     *
      * If this connection is not logged in, will return nullptr.
      * The returned reply needs to be deleted by the caller.
      */
-    NetworkReply *post( const QString &endpoint, const QVariantMap &params = QVariantMap(), const QStringList &fileNames = QStringList() );
+    NetworkReply *post( const QString &endpoint, const QVariantMap &params = QVariantMap(), const QStringList &fileNames = QStringList(), bool compressFiles = false );
+
+    /**
+     * Sends a post \a request with a raw \a payload to a given \a endpoint.
+     *
+     * The returned reply needs to be deleted by the caller.
+     */
+    NetworkReply *post( QNetworkRequest &request, const QString &endpoint, const QByteArray &payload );
 
 
     /**
@@ -167,6 +179,8 @@ class QFieldCloudConnection : public QObject
 
     /**
      * Uploads any pending attachments linked to the logged in user account.
+     * Attachments are queued smallest first and sent a few at a time, failed uploads
+     * are retried with an increasing delay.
      * \returns the number of attachments to be uploaded.
      */
     int uploadPendingAttachments();
@@ -204,10 +218,41 @@ class QFieldCloudConnection : public QObject
 
     int mPendingRequests = 0;
 
+    struct PendingAttachment
+    {
+        QString projectId;
+        QString fileName;
+        qint64 size = 0;
+        QDateTime lastModified;
+        int attempts = 0;
+    };
+
+    void processAttachmentsQueue();
+    void uploadAttachment( const PendingAttachment &attachment );
+
     bool mUploadingAttachments = false;
     int mUploadCount = 0;
+    int mActiveAttachmentUploads = 0;
+    QList<PendingAttachment> mAttachmentsQueue;
+    QSet<QString> mFailedAttachments;
 
     void setClientHeaders( QNetworkRequest &request );
+
+    /**
+     * Gzip compresses the request \a body in place and sets the matching content encoding on
+     * the \a request, provided the server accepts it and the body is worth compressing.
+     */
+    void compressRequestBody( QNetworkRequest &request, QByteArray &body ) const;
+
+    /**
+     * Tracks the pending \a reply to update the connection state, invalidate a remotely revoked
+     * token and learn whether the server accepts compressed requests.
+     */
+    void trackRequest( NetworkReply *reply );
+
+    bool mServerAcceptsGzip = false;
+    //! Whether the server rejected a compressed request, compression then stays off for the session whatever the server advertises
+    bool mGzipRejected = false;
 };
 
 #endif // QFIELDCLOUDCONNECTION_H
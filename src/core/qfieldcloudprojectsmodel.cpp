@@ -14,7 +14,8 @@
  ***************************************************************************/
 
 #include "deltafilewrapper.h"
-#include "fileutils.h"
+#include "filechecksumcache.h"
+#include "filedeltautils.h"
 #include "layerobserver.h"
 #include "qfield.h"
 #include "qfieldcloudconnection.h"
@@ -23,12 +24,15 @@
 
 #include <QDir>
 #include <QDirIterator>
+#include <QFutureWatcher>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QNetworkReply>
+#include <QSaveFile>
 #include <QSettings>
-#include <QTemporaryFile>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
 #include <qgis.h>
 #include <qgsapplication.h>
 #include <qgsmessagelog.h>
@@ -37,11 +41,29 @@
 #include <qgsproviderregistry.h>
 
 #define MAX_REDIRECTS_ALLOWED 10
-#define MAX_PARALLEL_REQUESTS 6
+#define MIN_PARALLEL_REQUESTS 1
+#define INITIAL_PARALLEL_REQUESTS 4
+#define MAX_PARALLEL_REQUESTS 12
+#define DOWNLOAD_THROUGHPUT_SAMPLE_MSECS 2000
+#define MAX_DOWNLOAD_RESUME_ATTEMPTS 5
+#define MIN_FILE_DELTA_DOWNLOAD_SIZE ( 1024 * 1024 )
 #define CACHE_PROJECT_DATA_SECS 5
+#define JOB_STATUS_LONG_POLL_WAIT_SECS 25
+#define FILE_DELTA_UNSUPPORTED_RECHECK_DAYS 7
+
+static QString checksumCacheFilePath()
+{
+  return QStringLiteral( "%1/checksums.cache" ).arg( QFieldCloudUtils::localCloudDirectory() );
+}
+
+static QString projectsListSnapshotFilePath( const QString &username, bool isPublic )
+{
+  return QStringLiteral( "%1/%2/%3" ).arg( QFieldCloudUtils::localCloudDirectory(), username, isPublic ? QStringLiteral( "projects_public.json" ) : QStringLiteral( "projects.json" ) );
+}
 
 QFieldCloudProjectsModel::QFieldCloudProjectsModel()
   : mProject( QgsProject::instance() )
+  , mDownloadConcurrency( INITIAL_PARALLEL_REQUESTS )
 {
   QJsonArray projects;
   reload( projects );
@@ -96,8 +118,15 @@ QFieldCloudProjectsModel::QFieldCloudProjectsModel()
     mUsername = mCloudConnection->username();
     if ( mCloudConnection->status() != QFieldCloudConnection::ConnectionStatus::LoggedIn )
     {
+      // while an existing session is being restored, show the last known projects list right away
       QJsonArray projects;
+      if ( mCloudConnection->hasToken() && !mUsername.isEmpty() )
+      {
+        projects = readProjectsListSnapshot( false ).value( QStringLiteral( "projects" ) ).toArray();
+      }
       reload( projects );
+      if ( !projects.isEmpty() )
+        mProjectsListSnapshotFilePath = projectsListSnapshotFilePath( mUsername, false );
     }
     connect( mCloudConnection, &QFieldCloudConnection::usernameChanged, this, [=]() {
       mUsername = mCloudConnection->username();
@@ -212,8 +241,25 @@ void QFieldCloudProjectsModel::refreshProjectsList( bool shouldRefreshPublic )
     case QFieldCloudConnection::ConnectionStatus::LoggedIn:
     {
       QString url = shouldRefreshPublic ? QStringLiteral( "/api/v1/projects/public/" ) : QStringLiteral( "/api/v1/projects/" );
-      NetworkReply *reply = mCloudConnection->get( url );
-      connect( reply, &NetworkReply::finished, this, &QFieldCloudProjectsModel::projectListReceived );
+
+      QNetworkRequest request;
+      request.setHeader( QNetworkRequest::ContentTypeHeader, "application/json" );
+      request.setAttribute( QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::RedirectPolicy::NoLessSafeRedirectPolicy );
+      mCloudConnection->setAuthenticationToken( request );
+
+      // only ask for the list if it changed since the last stored snapshot
+      const QJsonObject snapshot = readProjectsListSnapshot( shouldRefreshPublic );
+      const QString etag = snapshot.value( QStringLiteral( "etag" ) ).toString();
+      const QString lastModified = snapshot.value( QStringLiteral( "last_modified" ) ).toString();
+      if ( !etag.isEmpty() )
+        request.setRawHeader( "If-None-Match", etag.toUtf8() );
+      if ( !lastModified.isEmpty() )
+        request.setRawHeader( "If-Modified-Since", lastModified.toUtf8() );
+
+      NetworkReply *reply = mCloudConnection->get( request, url );
+      connect( reply, &NetworkReply::finished, this, [=]() {
+        projectListReceived( reply, shouldRefreshPublic );
+      } );
       break;
     }
     case QFieldCloudConnection::ConnectionStatus::Disconnected:
@@ -228,6 +274,19 @@ void QFieldCloudProjectsModel::refreshProjectsList( bool shouldRefreshPublic )
   }
 }
 
+std::shared_ptr<FileChecksumCache> QFieldCloudProjectsModel::fileChecksumCache()
+{
+  const QString cacheFilePath = checksumCacheFilePath();
+  if ( !mFileChecksumCache || mFileChecksumCacheFilePath != cacheFilePath )
+  {
+    // pending hashing tasks keep their own reference to the previous cache until they are done
+    mFileChecksumCache = std::make_shared<FileChecksumCache>( cacheFilePath );
+    mFileChecksumCacheFilePath = cacheFilePath;
+  }
+
+  return mFileChecksumCache;
+}
+
 QModelIndex QFieldCloudProjectsModel::findProjectIndex( const QString &projectId ) const
 {
   if ( projectId.isEmpty() )
@@ -410,6 +469,8 @@ void QFieldCloudProjectsModel::projectCancelDownload( const QString &projectId )
     if ( reply )
       reply->abort();
 
+    // the partial download file is kept, a later download of the same file will resume from it
+    projectClosePartialDownloadFile( projectId, fileName );
     project->downloadFileTransfers.remove( fileName );
   }
 
@@ -593,7 +654,19 @@ void QFieldCloudProjectsModel::projectGetJobStatus( const QString &projectId, co
 
   QString jobId = project->jobs[jobType].id;
   QgsLogger::debug( QStringLiteral( "Project %1, job %2: getting job status..." ).arg( projectId, jobId ) );
-  NetworkReply *reply = mCloudConnection->get( QStringLiteral( "/api/v1/jobs/%1/" ).arg( jobId ) );
+
+  QNetworkRequest request;
+  request.setHeader( QNetworkRequest::ContentTypeHeader, "application/json" );
+  request.setAttribute( QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::RedirectPolicy::NoLessSafeRedirectPolicy );
+  mCloudConnection->setAuthenticationToken( request );
+
+  // servers supporting it hold the request until the job status differs from the last known one (RFC 7240),
+  // they reply with 304 if it did not change within the wait time
+  request.setRawHeader( "Prefer", QStringLiteral( "wait=%1" ).arg( JOB_STATUS_LONG_POLL_WAIT_SECS ).toLatin1() );
+  if ( !project->jobs[jobType].statusString.isEmpty() )
+    request.setRawHeader( "If-None-Match", QStringLiteral( "\"%1\"" ).arg( project->jobs[jobType].statusString ).toUtf8() );
+
+  NetworkReply *reply = mCloudConnection->get( request, QStringLiteral( "/api/v1/jobs/%1/" ).arg( jobId ) );
 
   connect( reply, &NetworkReply::finished, this, [=]() {
     reply->deleteLater();
@@ -624,6 +697,19 @@ void QFieldCloudProjectsModel::projectGetJobStatus( const QString &projectId, co
       return;
     }
 
+    const bool isLongPoll = rawReply->rawHeader( "Preference-Applied" ).trimmed().startsWith( "wait" );
+
+    // a reply the server held already spaced out the requests
+    if ( isLongPoll )
+      project->jobs[jobType].statusPollAttempts = 0;
+
+    if ( rawReply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt() == 304 )
+    {
+      QgsLogger::debug( QStringLiteral( "Project %1, job %2: job status unchanged" ).arg( projectId, jobId ) );
+      retryProjectGetJobStatus( projectId, jobType, isLongPoll );
+      return;
+    }
+
     const QJsonObject payload = QJsonDocument::fromJson( rawReply->readAll() ).object();
     const QString jobStatusString = payload.value( QStringLiteral( "status" ) ).toString();
 
@@ -636,7 +722,11 @@ void QFieldCloudProjectsModel::projectGetJobStatus( const QString &projectId, co
       return;
     }
 
+    const bool isStatusChanged = project->jobs[jobType].statusString != jobStatusString;
     project->jobs[jobType].status = getJobStatusFromString( jobStatusString );
+    project->jobs[jobType].statusString = jobStatusString;
+    if ( isStatusChanged )
+      project->jobs[jobType].statusPollAttempts = 0;
 
     QgsLogger::debug( QStringLiteral( "Project %1, job %2: getting job status finished with `%3`" ).arg( projectId, jobId, jobStatusString ) );
 
@@ -647,9 +737,7 @@ void QFieldCloudProjectsModel::projectGetJobStatus( const QString &projectId, co
       case JobStartedStatus:
       case JobStoppedStatus:
         // infinite retry, there should be one day, when we can get the status!
-        QTimer::singleShot( sDelayBeforeStatusRetry, [=]() {
-          projectGetJobStatus( projectId, jobType );
-        } );
+        retryProjectGetJobStatus( projectId, jobType, isLongPoll && isStatusChanged );
         break;
 
       case JobFailedStatus:
@@ -662,6 +750,22 @@ void QFieldCloudProjectsModel::projectGetJobStatus( const QString &projectId, co
   } );
 }
 
+void QFieldCloudProjectsModel::retryProjectGetJobStatus( const QString &projectId, const JobType jobType, bool retryImmediately )
+{
+  CloudProject *project = findProject( projectId );
+
+  if ( !project || !project->jobs.contains( jobType ) )
+    return;
+
+  // when the server does not wait for status changes, poll less and less often while the status does not change
+  Job &job = project->jobs[jobType];
+  const int delay = retryImmediately ? 0 : sDelayBeforeStatusRetry * ( 1 << std::min( job.statusPollAttempts++, 3 ) );
+
+  QTimer::singleShot( delay, this, [=]() {
+    projectGetJobStatus( projectId, jobType );
+  } );
+}
+
 void QFieldCloudProjectsModel::projectPackageAndDownload( const QString &projectId )
 {
   QgsLogger::debug( QStringLiteral( "Project %1: package and download initiated." ).arg( projectId ) );
@@ -694,12 +798,18 @@ void QFieldCloudProjectsModel::projectPackageAndDownload( const QString &project
   project->downloadBytesTotal = 0;
   project->downloadBytesReceived = 0;
   project->downloadProgress = 0;
+  project->downloadBytesPerSecond = 0.0;
+  project->downloadSecondsRemaining = -1;
   project->status = ProjectStatus::Downloading;
   project->errorStatus = NoErrorStatus;
   project->modification = NoModification;
 
   emit dataChanged( projectIndex, projectIndex );
 
+  mDownloadSampleTimer.invalidate();
+  mDownloadSampleBytesPerSecond = 0.0;
+  mDownloadConcurrencyTrend = 0;
+
   auto projectRepackageIfNeededAndThenDownload = [=]() {
     if ( project->needsRepackaging )
     {
@@ -893,6 +1003,9 @@ void QFieldCloudProjectsModel::projectDownload( const QString &projectId )
     return;
   }
 
+  // restore the project files if a previous install of downloaded files was interrupted
+  projectRollbackInterruptedInstall( projectId );
+
   NetworkReply *reply = mCloudConnection->get( QStringLiteral( "/api/v1/packages/%1/latest/" ).arg( projectId ) );
 
   emit dataChanged( projectIndex, projectIndex, QVector<int>() << PackagingStatusRole << StatusRole );
@@ -937,14 +1050,12 @@ void QFieldCloudProjectsModel::projectDownload( const QString &projectId )
     }
 
     const QJsonArray files = payload.value( QStringLiteral( "files" ) ).toArray();
+    QStringList projectFileNames;
     for ( const QJsonValue &fileValue : files )
     {
       QJsonObject fileObject = fileValue.toObject();
-      int fileSize = fileObject.value( QStringLiteral( "size" ) ).toInt();
       QString fileName = fileObject.value( QStringLiteral( "name" ) ).toString();
-      QString projectFileName = QStringLiteral( "%1/%2/%3/%4" ).arg( QFieldCloudUtils::localCloudDirectory(), mUsername, projectId, fileName );
       QString cloudChecksum = fileObject.value( QStringLiteral( "sha256" ) ).toString();
-      QString localChecksum = FileUtils::fileChecksum( projectFileName, QCryptographicHash::Sha256 ).toHex();
 
       if (
         !fileObject.value( QStringLiteral( "size" ) ).isDouble()
@@ -956,60 +1067,108 @@ void QFieldCloudProjectsModel::projectDownload( const QString &projectId )
         return;
       }
 
-      if ( cloudChecksum == localChecksum )
-        continue;
-
-      project->downloadFileTransfers.insert( fileName, FileTransfer( fileName, fileSize ) );
-      project->downloadBytesTotal += std::max( fileSize, 0 );
+      projectFileNames << QStringLiteral( "%1/%2/%3/%4" ).arg( QFieldCloudUtils::localCloudDirectory(), mUsername, projectId, fileName );
     }
 
-    const QJsonObject layers = payload.value( QStringLiteral( "layers" ) ).toObject();
-    bool hasLayerExportErrror = false;
-    for ( const QString &layerKey : layers.keys() )
-    {
-      QJsonObject layer = layers.value( layerKey ).toObject();
-      QString layerName = layer.value( QStringLiteral( "name" ) ).toString();
-      QString layerStatus = layer.value( QStringLiteral( "error_code" ) ).toString();
+    // only local files modified since they were last hashed are read again, which still reads whole files
+    // after a local edit, keep it off the main thread
+    std::shared_ptr<FileChecksumCache> checksumCache = fileChecksumCache();
+    QFutureWatcher<QHash<QString, QByteArray>> *watcher = new QFutureWatcher<QHash<QString, QByteArray>>( this );
+    connect( watcher, &QFutureWatcher<QHash<QString, QByteArray>>::finished, this, [=]() {
+      const QHash<QString, QByteArray> localChecksums = watcher->result();
+      watcher->deleteLater();
 
-      if (
-        layerKey.isEmpty()
-        || layerName.isEmpty()
-        || layerStatus.isEmpty()
-        || !layer.value( QStringLiteral( "is_valid" ) ).isBool() )
+      CloudProject *project = findProject( projectId );
+      if ( !project || project->packagingStatus == PackagingAbortStatus )
       {
-        QgsLogger::debug( QStringLiteral( "Project %1: JSON structure package in \"layers\" list does not contain the expected fields: name(string), error_code(string), is_valid(bool)" ).arg( projectId ) );
+        QgsLogger::debug( QStringLiteral( "Project %1: local checksums computed, but the project is deleted or aborted." ).arg( projectId ) );
+        return;
       }
-      else
+
+      projectDownloadCompareFiles( projectId, payload, projectFileNames, localChecksums );
+    } );
+    watcher->setFuture( QtConcurrent::run( [checksumCache, projectFileNames]() {
+      const QHash<QString, QByteArray> localChecksums = checksumCache->checksums( projectFileNames );
+      checksumCache->save();
+      return localChecksums;
+    } ) );
+  } );
+}
+
+void QFieldCloudProjectsModel::projectDownloadCompareFiles( const QString &projectId, const QJsonObject &payload, const QStringList &projectFileNames, const QHash<QString, QByteArray> &localChecksums )
+{
+  CloudProject *project = findProject( projectId );
+  if ( !project )
+    return;
+
+  const QModelIndex projectIndex = findProjectIndex( projectId );
+  const QJsonArray files = payload.value( QStringLiteral( "files" ) ).toArray();
+  const QString packageId = payload.value( QStringLiteral( "package_id" ) ).toString();
+  const QString packagedAt = payload.value( QStringLiteral( "packaged_at" ) ).toString();
+
+  for ( int i = 0; i < files.size(); i++ )
+  {
+    QJsonObject fileObject = files.at( i ).toObject();
+    const qint64 fileSize = static_cast<qint64>( fileObject.value( QStringLiteral( "size" ) ).toDouble() );
+    QString fileName = fileObject.value( QStringLiteral( "name" ) ).toString();
+    QString cloudChecksum = fileObject.value( QStringLiteral( "sha256" ) ).toString();
+    QString localChecksum = localChecksums.value( projectFileNames.at( i ) ).toHex();
+
+    if ( cloudChecksum == localChecksum )
+      continue;
+
+    FileTransfer transfer( fileName, fileSize );
+    transfer.checksum = cloudChecksum;
+    project->downloadFileTransfers.insert( fileName, transfer );
+    project->downloadBytesTotal += std::max<qint64>( fileSize, 0 );
+  }
+
+  const QJsonObject layers = payload.value( QStringLiteral( "layers" ) ).toObject();
+  bool hasLayerExportErrror = false;
+  for ( const QString &layerKey : layers.keys() )
+  {
+    QJsonObject layer = layers.value( layerKey ).toObject();
+    QString layerName = layer.value( QStringLiteral( "name" ) ).toString();
+    QString layerStatus = layer.value( QStringLiteral( "error_code" ) ).toString();
+
+    if (
+      layerKey.isEmpty()
+      || layerName.isEmpty()
+      || layerStatus.isEmpty()
+      || !layer.value( QStringLiteral( "is_valid" ) ).isBool() )
+    {
+      QgsLogger::debug( QStringLiteral( "Project %1: JSON structure package in \"layers\" list does not contain the expected fields: name(string), error_code(string), is_valid(bool)" ).arg( projectId ) );
+    }
+    else
+    {
+      if ( !layer.value( QStringLiteral( "is_valid" ) ).toBool() )
       {
-        if ( !layer.value( QStringLiteral( "is_valid" ) ).toBool() )
-        {
-          QString errorSummary = layer.value( QStringLiteral( "error_summary" ) ).toString() + layer.value( QStringLiteral( "provider_error_summary" ) ).toString();
+        QString errorSummary = layer.value( QStringLiteral( "error_summary" ) ).toString() + layer.value( QStringLiteral( "provider_error_summary" ) ).toString();
 
-          project->packagedLayerErrors.append( tr( "Project %1: Packaged layer `%2` is not valid. Error code %3, error message: %4" ).arg( projectId, layerName, layerStatus, errorSummary ) );
-          QgsMessageLog::logMessage( project->packagedLayerErrors.last() );
+        project->packagedLayerErrors.append( tr( "Project %1: Packaged layer `%2` is not valid. Error code %3, error message: %4" ).arg( projectId, layerName, layerStatus, errorSummary ) );
+        QgsMessageLog::logMessage( project->packagedLayerErrors.last() );
 
-          hasLayerExportErrror = true;
-        }
+        hasLayerExportErrror = true;
       }
     }
+  }
 
-    if ( hasLayerExportErrror )
-    {
-      QgsLogger::debug( QStringLiteral( "Project %1: packaged files list request finished with some failed layers:\n%2" ).arg( projectId, project->packagedLayerErrors.join( QStringLiteral( "\n" ) ) ) );
-      emit dataChanged( projectIndex, projectIndex, QVector<int>() << PackagedLayerErrorsRole );
-    }
+  if ( hasLayerExportErrror )
+  {
+    QgsLogger::debug( QStringLiteral( "Project %1: packaged files list request finished with some failed layers:\n%2" ).arg( projectId, project->packagedLayerErrors.join( QStringLiteral( "\n" ) ) ) );
+    emit dataChanged( projectIndex, projectIndex, QVector<int>() << PackagedLayerErrorsRole );
+  }
 
-    project->lastExportId = packageId;
-    project->lastExportedAt = packagedAt;
+  project->lastExportId = packageId;
+  project->lastExportedAt = packagedAt;
 
-    QgsLogger::debug( QStringLiteral( "Project %1: packaged files to download - %2 files, namely: %3" )
-                        .arg( projectId )
-                        .arg( project->downloadFileTransfers.count() )
-                        .arg( project->downloadFileTransfers.keys().join( ", " ) ) );
+  QgsLogger::debug( QStringLiteral( "Project %1: packaged files to download - %2 files, namely: %3" )
+                      .arg( projectId )
+                      .arg( project->downloadFileTransfers.count() )
+                      .arg( project->downloadFileTransfers.keys().join( ", " ) ) );
 
-    updateActiveProjectFilesToDownload( projectId );
-    projectDownloadFiles( projectId );
-  } );
+  updateActiveProjectFilesToDownload( projectId );
+  projectDownloadFiles( projectId );
 }
 
 void QFieldCloudProjectsModel::updateActiveProjectFilesToDownload( const QString &projectId )
@@ -1022,7 +1181,7 @@ void QFieldCloudProjectsModel::updateActiveProjectFilesToDownload( const QString
   if ( !project )
     return;
 
-  const QStringList fileNames = project->downloadFileTransfers.keys();
+  QStringList fileNames = project->downloadFileTransfers.keys();
 
   if ( fileNames.isEmpty() )
   {
@@ -1030,6 +1189,11 @@ void QFieldCloudProjectsModel::updateActiveProjectFilesToDownload( const QString
     return;
   }
 
+  // start with the biggest files, so that the last files left downloading are small ones rather than a lone large file
+  std::stable_sort( fileNames.begin(), fileNames.end(), [project]( const QString &a, const QString &b ) {
+    return project->downloadFileTransfers[a].bytesTotal > project->downloadFileTransfers[b].bytesTotal;
+  } );
+
   for ( const QString &fileName : fileNames )
   {
     if ( project->downloadFileTransfers[fileName].networkReply )
@@ -1049,7 +1213,11 @@ void QFieldCloudProjectsModel::updateActiveProjectFilesToDownload( const QString
       }
     }
 
-    if ( mActiveProjectFilesToDownload.size() >= MAX_PARALLEL_REQUESTS )
+    // the file is waiting to be resumed after a temporary error
+    if ( mActiveProjectFilesToDownload.contains( fileName ) )
+      continue;
+
+    if ( mActiveProjectFilesToDownload.size() >= mDownloadConcurrency )
     {
       return;
     }
@@ -1069,6 +1237,88 @@ void QFieldCloudProjectsModel::updateActiveProjectFilesToDownload( const QString
   }
 }
 
+void QFieldCloudProjectsModel::updateDownloadThroughput( const QString &projectId )
+{
+  CloudProject *project = findProject( projectId );
+  if ( !project )
+    return;
+
+  if ( !mDownloadSampleTimer.isValid() )
+  {
+    mDownloadSampleTimer.start();
+    mDownloadSampleBytes = project->downloadBytesReceived;
+    return;
+  }
+
+  const qint64 elapsed = mDownloadSampleTimer.elapsed();
+  if ( elapsed < DOWNLOAD_THROUGHPUT_SAMPLE_MSECS )
+    return;
+
+  const double bytesPerSecond = std::max<qint64>( project->downloadBytesReceived - mDownloadSampleBytes, 0 ) * 1000.0 / elapsed;
+  mDownloadSampleTimer.restart();
+  mDownloadSampleBytes = project->downloadBytesReceived;
+
+  // smooth the reported throughput so the remaining time does not jump around
+  project->downloadBytesPerSecond = project->downloadBytesPerSecond > 0 ? 0.7 * project->downloadBytesPerSecond + 0.3 * bytesPerSecond : bytesPerSecond;
+  project->downloadSecondsRemaining = project->downloadBytesPerSecond > 0
+                                        ? static_cast<qint64>( std::max<qint64>( project->downloadBytesTotal - project->downloadBytesReceived, 0 ) / project->downloadBytesPerSecond )
+                                        : -1;
+
+  const int previousConcurrency = mDownloadConcurrency;
+  adaptDownloadConcurrency( bytesPerSecond );
+
+  if ( mDownloadConcurrency > previousConcurrency )
+  {
+    // put the extra slots to use right away rather than when the next file completes
+    updateActiveProjectFilesToDownload( projectId );
+    projectDownloadFiles( projectId );
+  }
+}
+
+void QFieldCloudProjectsModel::adaptDownloadConcurrency( double bytesPerSecond )
+{
+  const double previousBytesPerSecond = mDownloadSampleBytesPerSecond;
+  mDownloadSampleBytesPerSecond = bytesPerSecond;
+
+  // only a saturated pipe tells anything about whether more parallel requests would help
+  const bool isSaturated = mActiveProjectFilesToDownload.size() >= mDownloadConcurrency;
+  const int previousConcurrency = mDownloadConcurrency;
+
+  if ( mDownloadConcurrencyTrend > 0 && bytesPerSecond < previousBytesPerSecond * 0.95 )
+  {
+    // the last extra request made things worse, step back
+    mDownloadConcurrency = std::max( mDownloadConcurrency - 1, MIN_PARALLEL_REQUESTS );
+    mDownloadConcurrencyTrend = -1;
+  }
+  else if ( isSaturated && ( mDownloadConcurrencyTrend == 0 || bytesPerSecond > previousBytesPerSecond * 1.05 ) )
+  {
+    mDownloadConcurrency = std::min( mDownloadConcurrency + 1, MAX_PARALLEL_REQUESTS );
+    mDownloadConcurrencyTrend = mDownloadConcurrency > previousConcurrency ? 1 : 0;
+  }
+  else
+  {
+    mDownloadConcurrencyTrend = 0;
+  }
+
+  if ( mDownloadConcurrency != previousConcurrency )
+  {
+    QgsLogger::debug( QStringLiteral( "Download concurrency changed from %1 to %2 at %3 bytes/s" ).arg( previousConcurrency ).arg( mDownloadConcurrency ).arg( bytesPerSecond ) );
+  }
+}
+
+void QFieldCloudProjectsModel::reduceDownloadConcurrency()
+{
+  // back off multiplicatively on errors, the network or the server is struggling
+  const int previousConcurrency = mDownloadConcurrency;
+  mDownloadConcurrency = std::max( mDownloadConcurrency / 2, MIN_PARALLEL_REQUESTS );
+  mDownloadConcurrencyTrend = -1;
+
+  if ( mDownloadConcurrency != previousConcurrency )
+  {
+    QgsLogger::debug( QStringLiteral( "Download concurrency reduced from %1 to %2 after a transfer error" ).arg( previousConcurrency ).arg( mDownloadConcurrency ) );
+  }
+}
+
 void QFieldCloudProjectsModel::projectDownloadFiles( const QString &projectId )
 {
   // calling updateActiveProjectFilesToDownload() before calling this function is mandatory
@@ -1097,33 +1347,354 @@ void QFieldCloudProjectsModel::projectDownloadFiles( const QString &projectId )
 
   for ( const QString &fileName : std::as_const( mActiveProjectFilesToDownload ) )
   {
-    if ( project->downloadFileTransfers[fileName].networkReply )
+    if ( project->downloadFileTransfers[fileName].networkReply || project->downloadFileTransfers[fileName].isPreparingDelta )
     {
       // Download is already in progress
       continue;
     }
 
-    NetworkReply *reply = downloadFile( projectId, fileName );
-    QTemporaryFile *file = new QTemporaryFile( reply );
-
-    file->setAutoRemove( false );
+    if ( projectCanDownloadFileDelta( projectId, fileName ) )
+    {
+      projectDownloadFileDelta( projectId, fileName );
+      continue;
+    }
 
-    if ( !file->open() )
+    QString errorString;
+    if ( !projectOpenPartialDownloadFile( projectId, fileName, errorString ) )
     {
       project->downloadFilesFailed++;
       emit projectDownloadFinished( projectId, tr( "Failed to open temporary file for `%1`, reason:\n%2" )
                                                  .arg( fileName )
-                                                 .arg( file->errorString() ) );
+                                                 .arg( errorString ) );
       return;
     }
 
-    project->downloadFileTransfers[fileName].tmpFile = file->fileName();
+    NetworkReply *reply = downloadFile( projectId, fileName, project->downloadFileTransfers[fileName].resumeOffset );
     project->downloadFileTransfers[fileName].networkReply = reply;
 
     downloadFileConnections( projectId, fileName );
   }
 }
 
+bool QFieldCloudProjectsModel::projectOpenPartialDownloadFile( const QString &projectId, const QString &fileName, QString &errorString )
+{
+  CloudProject *project = findProject( projectId );
+  if ( !project || !project->downloadFileTransfers.contains( fileName ) )
+    return false;
+
+  FileTransfer &transfer = project->downloadFileTransfers[fileName];
+  const QString partialFileName = QStringLiteral( "%1/%2.part" ).arg( QFieldCloudUtils::localProjectDownloadDirectory( mUsername, projectId ), fileName );
+  const QString checksumFileName = QStringLiteral( "%1.sha256" ).arg( partialFileName );
+
+  QDir partialFileDir = QFileInfo( partialFileName ).dir();
+  if ( !partialFileDir.exists() && !partialFileDir.mkpath( QStringLiteral( "." ) ) )
+  {
+    errorString = tr( "Failed to create directory at `%1`" ).arg( partialFileDir.path() );
+    return false;
+  }
+
+  // A partial file left behind by an interrupted download can be resumed as long as it belongs to the same file version
+  qint64 resumeOffset = 0;
+  QFile checksumFile( checksumFileName );
+  if ( QFile::exists( partialFileName ) && checksumFile.open( QIODevice::ReadOnly ) && checksumFile.readAll().trimmed() == transfer.checksum.toUtf8() )
+  {
+    resumeOffset = QFileInfo( partialFileName ).size();
+    if ( resumeOffset >= transfer.bytesTotal )
+      resumeOffset = 0;
+  }
+  checksumFile.close();
+
+  if ( resumeOffset == 0 )
+  {
+    if ( !checksumFile.open( QIODevice::WriteOnly | QIODevice::Truncate ) || checksumFile.write( transfer.checksum.toUtf8() ) < 0 )
+    {
+      errorString = checksumFile.errorString();
+      return false;
+    }
+    checksumFile.close();
+  }
+
+  std::unique_ptr<QFile> file = std::make_unique<QFile>( partialFileName );
+  if ( !file->open( resumeOffset > 0 ? QIODevice::ReadWrite | QIODevice::Append : QIODevice::ReadWrite | QIODevice::Truncate ) )
+  {
+    errorString = file->errorString();
+    return false;
+  }
+
+  transfer.partialFileHash = std::make_shared<QCryptographicHash>( QCryptographicHash::Sha256 );
+  if ( resumeOffset > 0 )
+  {
+    // feed the already downloaded content to the hash, the file position ends up back at the end for appending
+    file->seek( 0 );
+    if ( !transfer.partialFileHash->addData( file.get() ) )
+    {
+      transfer.partialFileHash->reset();
+      file->resize( 0 );
+      resumeOffset = 0;
+    }
+    file->seek( file->size() );
+
+    QgsLogger::debug( QStringLiteral( "Project %1, file `%2`: resuming download from byte %3" ).arg( projectId, fileName ).arg( resumeOffset ) );
+  }
+
+  project->downloadBytesReceived -= transfer.bytesTransferred;
+  project->downloadBytesReceived += resumeOffset;
+  transfer.bytesTransferred = resumeOffset;
+  transfer.resumeOffset = resumeOffset;
+  transfer.tmpFile = partialFileName;
+  transfer.partialFile = file.release();
+  transfer.writeErrorString.clear();
+
+  return true;
+}
+
+void QFieldCloudProjectsModel::projectClosePartialDownloadFile( const QString &projectId, const QString &fileName )
+{
+  CloudProject *project = findProject( projectId );
+  if ( !project || !project->downloadFileTransfers.contains( fileName ) )
+    return;
+
+  FileTransfer &transfer = project->downloadFileTransfers[fileName];
+  if ( transfer.partialFile )
+  {
+    transfer.partialFile->close();
+    delete transfer.partialFile;
+    transfer.partialFile = nullptr;
+  }
+}
+
+bool QFieldCloudProjectsModel::projectCanDownloadFileDelta( const QString &projectId, const QString &fileName ) const
+{
+  if ( fileDeltaUnsupported() )
+    return false;
+
+  CloudProject *project = findProject( projectId );
+  if ( !project || !project->downloadFileTransfers.contains( fileName ) )
+    return false;
+
+  const FileTransfer &transfer = project->downloadFileTransfers[fileName];
+  if ( transfer.skipDelta || transfer.bytesTotal < MIN_FILE_DELTA_DOWNLOAD_SIZE )
+    return false;
+
+  // an interrupted download is resumed rather than turned into a delta
+  if ( QFile::exists( QStringLiteral( "%1/%2.part" ).arg( QFieldCloudUtils::localProjectDownloadDirectory( mUsername, projectId ), fileName ) ) )
+    return false;
+
+  const QFileInfo localFileInfo( QStringLiteral( "%1/%2/%3/%4" ).arg( QFieldCloudUtils::localCloudDirectory(), mUsername, projectId, fileName ) );
+  return localFileInfo.isFile() && localFileInfo.size() >= MIN_FILE_DELTA_DOWNLOAD_SIZE;
+}
+
+void QFieldCloudProjectsModel::projectDownloadFileDelta( const QString &projectId, const QString &fileName )
+{
+  CloudProject *project = findProject( projectId );
+  if ( !project || !project->downloadFileTransfers.contains( fileName ) )
+    return;
+
+  const QString localFileName = QStringLiteral( "%1/%2/%3/%4" ).arg( QFieldCloudUtils::localCloudDirectory(), mUsername, projectId, fileName );
+  const QString partialFileName = QStringLiteral( "%1/%2.part" ).arg( QFieldCloudUtils::localProjectDownloadDirectory( mUsername, projectId ), fileName );
+
+  project->downloadFileTransfers[fileName].isPreparingDelta = true;
+
+  QgsLogger::debug( QStringLiteral( "Project %1, file `%2`: computing the local file signature for a delta download" ).arg( projectId, fileName ) );
+
+  // computing the signature reads the whole local copy, keep it off the main thread
+  QFutureWatcher<QByteArray> *watcher = new QFutureWatcher<QByteArray>( this );
+  connect( watcher, &QFutureWatcher<QByteArray>::finished, this, [=]() {
+    const QByteArray signature = watcher->result();
+    watcher->deleteLater();
+
+    CloudProject *project = findProject( projectId );
+    if ( !project || !project->downloadFileTransfers.contains( fileName ) )
+      return;
+
+    FileTransfer &transfer = project->downloadFileTransfers[fileName];
+    transfer.isPreparingDelta = false;
+
+    if ( project->status != ProjectStatus::Downloading || project->packagingStatus == PackagingAbortStatus )
+      return;
+
+    if ( !signature.isEmpty() && QDir().mkpath( QFileInfo( partialFileName ).absolutePath() ) )
+    {
+      std::unique_ptr<QFile> deltaFile = std::make_unique<QFile>( QStringLiteral( "%1.delta" ).arg( partialFileName ) );
+      if ( deltaFile->open( QIODevice::ReadWrite | QIODevice::Truncate ) )
+      {
+        transfer.isDelta = true;
+        transfer.resumeOffset = 0;
+        transfer.tmpFile = partialFileName;
+        transfer.partialFile = deltaFile.release();
+        transfer.writeErrorString.clear();
+        transfer.networkReply = downloadFileDelta( projectId, fileName, signature );
+
+        downloadFileConnections( projectId, fileName );
+        return;
+      }
+    }
+
+    transfer.skipDelta = true;
+    projectDownloadFiles( projectId );
+  } );
+  watcher->setFuture( QtConcurrent::run( [localFileName]() {
+    return FileDeltaUtils::signature( localFileName );
+  } ) );
+}
+
+void QFieldCloudProjectsModel::projectApplyDownloadedFileDelta( const QString &projectId, const QString &fileName )
+{
+  CloudProject *project = findProject( projectId );
+  if ( !project || !project->downloadFileTransfers.contains( fileName ) )
+    return;
+
+  FileTransfer &transfer = project->downloadFileTransfers[fileName];
+  NetworkReply *reply = transfer.networkReply;
+  QNetworkReply *rawReply = reply->reply();
+  const QString localFileName = QStringLiteral( "%1/%2/%3/%4" ).arg( QFieldCloudUtils::localCloudDirectory(), mUsername, projectId, fileName );
+  const QString partialFileName = QStringLiteral( "%1/%2.part" ).arg( QFieldCloudUtils::localProjectDownloadDirectory( mUsername, projectId ), fileName );
+
+  std::shared_ptr<QFile> deltaFile( transfer.partialFile );
+  transfer.partialFile = nullptr;
+  transfer.isDelta = false;
+
+  // falls back to downloading the whole file, the reply is kept as the active one until then so the transfer is not restarted
+  auto deltaFailed = [=]( const QString &errorString ) {
+    CloudProject *project = findProject( projectId );
+    if ( deltaFile )
+    {
+      deltaFile->close();
+      deltaFile->remove();
+    }
+    QFile::remove( partialFileName );
+
+    if ( !project || !project->downloadFileTransfers.contains( fileName ) )
+      return;
+
+    QgsLogger::debug( QStringLiteral( "Project %1, file `%2`: delta download failed, downloading the whole file instead. %3" ).arg( projectId, fileName, errorString ) );
+
+    FileTransfer &transfer = project->downloadFileTransfers[fileName];
+    project->downloadBytesReceived -= transfer.bytesTransferred;
+    transfer.bytesTransferred = 0;
+    transfer.skipDelta = true;
+    transfer.networkReply = nullptr;
+    reply->deleteLater();
+
+    if ( project->packagingStatus != PackagingAbortStatus )
+      projectDownloadFiles( projectId );
+  };
+
+  const int httpStatusCode = rawReply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt();
+  if ( !deltaFile || !transfer.writeErrorString.isEmpty() )
+  {
+    deltaFailed( transfer.writeErrorString );
+    return;
+  }
+
+  if ( rawReply->error() != QNetworkReply::NoError || httpStatusCode != 200 )
+  {
+    // servers not supporting delta downloads will keep answering the same, stop asking them
+    if ( httpStatusCode == 404 || httpStatusCode == 405 || httpStatusCode == 501 || ( httpStatusCode >= 300 && httpStatusCode < 400 ) )
+      setFileDeltaUnsupported();
+
+    // other server side failures are likely to repeat for every file, only network hiccups are worth trying again
+    const bool isTransient = httpStatusCode == 0 || httpStatusCode == 408 || httpStatusCode == 429 || httpStatusCode == 502 || httpStatusCode == 503 || httpStatusCode == 504;
+    if ( !isTransient )
+      mFileDeltaDisabled = true;
+
+    deltaFailed( QFieldCloudConnection::errorString( rawReply ) );
+    return;
+  }
+
+  const QByteArray data = rawReply->readAll();
+  if ( deltaFile->write( data ) != data.size() || !deltaFile->flush() || !deltaFile->seek( 0 ) )
+  {
+    deltaFailed( deltaFile->errorString() );
+    return;
+  }
+
+  // handed over to the transfer once rebuilt, only deleted here on failure as the background task may still be writing to it otherwise
+  QFile *file = new QFile( partialFileName );
+  if ( !file->open( QIODevice::ReadWrite | QIODevice::Truncate ) )
+  {
+    const QString errorString = file->errorString();
+    delete file;
+    deltaFailed( errorString );
+    return;
+  }
+
+  // rebuilding the file reads the whole local copy, keep it off the main thread
+  std::shared_ptr<QCryptographicHash> hash = std::make_shared<QCryptographicHash>( QCryptographicHash::Sha256 );
+  QFutureWatcher<QString> *watcher = new QFutureWatcher<QString>( this );
+  connect( watcher, &QFutureWatcher<QString>::finished, this, [=]() {
+    QString errorString = watcher->result();
+    watcher->deleteLater();
+
+    CloudProject *project = findProject( projectId );
+    if ( !project || !project->downloadFileTransfers.contains( fileName ) || project->downloadFileTransfers[fileName].networkReply != reply )
+    {
+      // the transfer moved on without this delta, only its own temporary output is cleaned up
+      delete file;
+      const bool isTransferGone = !project || !project->downloadFileTransfers.contains( fileName );
+      const bool isNewerDelta = !isTransferGone && ( project->downloadFileTransfers[fileName].isDelta || project->downloadFileTransfers[fileName].isPreparingDelta );
+      deltaFile->close();
+      if ( !isNewerDelta )
+        deltaFile->remove();
+      if ( isTransferGone )
+        QFile::remove( partialFileName );
+      return;
+    }
+
+    if ( errorString.isEmpty() && QString( hash->result().toHex() ) != project->downloadFileTransfers[fileName].checksum )
+      errorString = tr( "Checksum mismatch of the file rebuilt from the delta." );
+
+    if ( !errorString.isEmpty() )
+    {
+      delete file;
+      deltaFailed( errorString );
+      return;
+    }
+
+    deltaFile->close();
+    deltaFile->remove();
+
+    FileTransfer &transfer = project->downloadFileTransfers[fileName];
+    transfer.tmpFile = partialFileName;
+    transfer.partialFile = file;
+    transfer.partialFileHash = hash;
+
+    // the rebuilt file counts as fully transferred
+    project->downloadBytesReceived -= transfer.bytesTransferred;
+    transfer.bytesTransferred = transfer.bytesTotal;
+    project->downloadBytesReceived += transfer.bytesTransferred;
+
+    QgsLogger::debug( QStringLiteral( "Project %1, file `%2`: rebuilt from a delta of the local file" ).arg( projectId, fileName ) );
+
+    if ( project->packagingStatus != PackagingAbortStatus )
+      projectDownloadFileFinished( projectId, fileName );
+  } );
+  watcher->setFuture( QtConcurrent::run( [localFileName, deltaFile, file, hash]() {
+    QString errorString;
+    if ( !FileDeltaUtils::applyDelta( localFileName, deltaFile.get(), file, hash.get(), &errorString ) && errorString.isEmpty() )
+      errorString = QObject::tr( "Failed to apply the file delta." );
+    return errorString;
+  } ) );
+}
+
+bool QFieldCloudProjectsModel::fileDeltaUnsupported() const
+{
+  if ( !mCloudConnection || mFileDeltaDisabled )
+    return true;
+
+  // servers get upgraded, ask them again once in a while
+  const QDateTime unsupportedAt = QSettings().value( QStringLiteral( "QFieldCloud/fileDeltaUnsupported/%1" ).arg( QUrl( mCloudConnection->url() ).authority() ) ).toDateTime();
+  return unsupportedAt.isValid() && unsupportedAt.addDays( FILE_DELTA_UNSUPPORTED_RECHECK_DAYS ) > QDateTime::currentDateTimeUtc();
+}
+
+void QFieldCloudProjectsModel::setFileDeltaUnsupported()
+{
+  if ( !mCloudConnection )
+    return;
+
+  QSettings().setValue( QStringLiteral( "QFieldCloud/fileDeltaUnsupported/%1" ).arg( QUrl( mCloudConnection->url() ).authority() ), QDateTime::currentDateTimeUtc() );
+}
+
 bool QFieldCloudProjectsModel::projectMoveDownloadedFilesToPermanentStorage( const QString &projectId )
 {
   if ( !mCloudConnection )
@@ -1132,45 +1703,142 @@ bool QFieldCloudProjectsModel::projectMoveDownloadedFilesToPermanentStorage( con
   if ( !project )
     return false;
 
-  bool hasError = false;
+  const QString downloadDirectory = QFieldCloudUtils::localProjectDownloadDirectory( mUsername, projectId );
+  const QString backupDirectory = QStringLiteral( "%1/.backup" ).arg( downloadDirectory );
   const QStringList fileNames = project->downloadFileTransfers.keys();
 
+  // Write the rollback journal listing every file about to be replaced before touching the project directory,
+  // so that an install interrupted midway (even by a crash) can be rolled back
+  QJsonArray journal;
   for ( const QString &fileName : fileNames )
   {
-    QFileInfo fileInfo( fileName );
-    QFile file( project->downloadFileTransfers[fileName].tmpFile );
-    QDir dir( QStringLiteral( "%1/%2/%3/%4" ).arg( QFieldCloudUtils::localCloudDirectory(), mUsername, projectId, fileInfo.path() ) );
+    const QString destinationFileName = QDir::cleanPath( QStringLiteral( "%1/%2/%3/%4" ).arg( QFieldCloudUtils::localCloudDirectory(), mUsername, projectId, fileName ) );
+    QJsonObject entry;
+    entry.insert( QStringLiteral( "destination" ), destinationFileName );
+    entry.insert( QStringLiteral( "backup" ), QStringLiteral( "%1/%2" ).arg( backupDirectory, fileName ) );
+    entry.insert( QStringLiteral( "existed" ), QFile::exists( destinationFileName ) );
+    journal.append( entry );
+  }
+
+  QSaveFile journalFile( QStringLiteral( "%1/install.json" ).arg( downloadDirectory ) );
+  if ( !journalFile.open( QIODevice::WriteOnly ) || journalFile.write( QJsonDocument( journal ).toJson( QJsonDocument::Compact ) ) < 0 || !journalFile.commit() )
+  {
+    QgsMessageLog::logMessage( QStringLiteral( "Failed to write the install journal of project `%1`, reason:\n%2" ).arg( projectId, journalFile.errorString() ) );
+    return false;
+  }
+
+  std::shared_ptr<FileChecksumCache> checksumCache = fileChecksumCache();
+  bool hasError = false;
+  for ( int i = 0; i < fileNames.size() && !hasError; i++ )
+  {
+    const QJsonObject entry = journal.at( i ).toObject();
+    const QString fileName = fileNames.at( i );
+    const QString destinationFileName = entry.value( QStringLiteral( "destination" ) ).toString();
+    const QString backupFileName = entry.value( QStringLiteral( "backup" ) ).toString();
 
-    if ( !hasError && !dir.exists() && !dir.mkpath( QStringLiteral( "." ) ) )
+    QDir destinationDir = QFileInfo( destinationFileName ).dir();
+    QDir backupDir = QFileInfo( backupFileName ).dir();
+    if ( ( !destinationDir.exists() && !destinationDir.mkpath( QStringLiteral( "." ) ) ) || ( !backupDir.exists() && !backupDir.mkpath( QStringLiteral( "." ) ) ) )
     {
       hasError = true;
-      QgsMessageLog::logMessage( QStringLiteral( "Failed to create directory at `%1`" ).arg( dir.path() ) );
+      QgsMessageLog::logMessage( QStringLiteral( "Failed to create directory at `%1`" ).arg( destinationDir.exists() ? backupDir.path() : destinationDir.path() ) );
+      break;
     }
 
-    const QString destinationFileName( QDir::cleanPath( dir.filePath( fileInfo.fileName() ) ) );
-
-    // if the file already exists, we need to delete it first, as QT does not support overwriting
-    // NOTE: it is possible that someone creates the file in the meantime between this and the next if statement
-    if ( !hasError && QFile::exists( destinationFileName ) && !file.remove( destinationFileName ) )
+    // move the current file aside, the backup lives on the same file system so this is a mere rename
+    if ( entry.value( QStringLiteral( "existed" ) ).toBool() )
     {
-      hasError = true;
-      QgsMessageLog::logMessage( QStringLiteral( "Failed to remove file before overwriting stored at `%1`, reason:\n%2" ).arg( fileName ).arg( file.errorString() ) );
+      QFile::remove( backupFileName );
+      QFile destinationFile( destinationFileName );
+      if ( !destinationFile.rename( backupFileName ) )
+      {
+        hasError = true;
+        QgsMessageLog::logMessage( QStringLiteral( "Failed to move aside file stored at `%1`, reason:\n%2" ).arg( fileName, destinationFile.errorString() ) );
+        break;
+      }
     }
 
-    if ( !hasError && !file.copy( destinationFileName ) )
+    // QFile::rename only falls back to copying when the temporary file lives on another file system
+    QFile file( project->downloadFileTransfers[fileName].tmpFile );
+    if ( !file.rename( destinationFileName ) )
     {
       hasError = true;
-      QgsMessageLog::logMessage( QStringLiteral( "Failed to write downloaded file stored at `%1`, reason:\n%2" ).arg( fileName ).arg( file.errorString() ) );
-
-      if ( !QFile::remove( dir.filePath( fileName ) ) )
-        QgsMessageLog::logMessage( QStringLiteral( "Failed to remove partly overwritten file stored at `%1`" ).arg( fileName ) );
+      QgsMessageLog::logMessage( QStringLiteral( "Failed to write downloaded file stored at `%1`, reason:\n%2" ).arg( fileName, file.errorString() ) );
+      break;
     }
 
-    if ( !file.remove() )
-      QgsMessageLog::logMessage( QStringLiteral( "Failed to remove temporary file `%1`" ).arg( fileName ) );
+    QFile::remove( QStringLiteral( "%1.sha256" ).arg( project->downloadFileTransfers[fileName].tmpFile ) );
+
+    // the downloaded content has been verified against its checksum, no need to hash it again on the next sync
+    checksumCache->insert( destinationFileName, QByteArray::fromHex( project->downloadFileTransfers[fileName].checksum.toLatin1() ) );
+  }
+
+  checksumCache->save();
+
+  if ( hasError )
+  {
+    projectRollbackInterruptedInstall( projectId );
+    return false;
+  }
+
+  // the journal removal marks the install as complete, backups are only dropped afterwards as an interrupted
+  // cleanup would otherwise leave a journal behind which rolls back the completed install on the next start
+  if ( !QFile::remove( journalFile.fileName() ) )
+  {
+    QgsMessageLog::logMessage( QStringLiteral( "Failed to remove the install journal of project `%1`" ).arg( projectId ) );
+    return true;
+  }
+
+  QDir( downloadDirectory ).removeRecursively();
+
+  return true;
+}
+
+void QFieldCloudProjectsModel::projectRollbackInterruptedInstall( const QString &projectId )
+{
+  const QString downloadDirectory = QFieldCloudUtils::localProjectDownloadDirectory( mUsername, projectId );
+  QFile journalFile( QStringLiteral( "%1/install.json" ).arg( downloadDirectory ) );
+  if ( !journalFile.exists() )
+    return;
+
+  if ( !journalFile.open( QIODevice::ReadOnly ) )
+  {
+    QgsMessageLog::logMessage( QStringLiteral( "Failed to read the install journal of project `%1`, reason:\n%2" ).arg( projectId, journalFile.errorString() ) );
+    return;
+  }
+
+  QgsLogger::debug( QStringLiteral( "Project %1: rolling back an interrupted install of downloaded files" ).arg( projectId ) );
+
+  const QJsonArray journal = QJsonDocument::fromJson( journalFile.readAll() ).array();
+  journalFile.close();
+
+  bool hasError = false;
+  for ( const QJsonValue &value : journal )
+  {
+    const QJsonObject entry = value.toObject();
+    const QString destinationFileName = entry.value( QStringLiteral( "destination" ) ).toString();
+    const QString backupFileName = entry.value( QStringLiteral( "backup" ) ).toString();
+
+    if ( QFile::exists( backupFileName ) )
+    {
+      // the file was moved aside, restore it over whatever got installed in its place
+      if ( ( QFile::exists( destinationFileName ) && !QFile::remove( destinationFileName ) ) || !QFile::rename( backupFileName, destinationFileName ) )
+      {
+        hasError = true;
+        QgsMessageLog::logMessage( QStringLiteral( "Failed to restore file `%1` from its backup" ).arg( destinationFileName ) );
+      }
+    }
+    else if ( !entry.value( QStringLiteral( "existed" ) ).toBool() && QFile::exists( destinationFileName ) )
+    {
+      // the file did not exist before the install
+      QFile::remove( destinationFileName );
+    }
   }
 
-  return !hasError;
+  if ( !hasError && QFile::remove( journalFile.fileName() ) )
+  {
+    QDir( QStringLiteral( "%1/.backup" ).arg( downloadDirectory ) ).removeRecursively();
+  }
 }
 
 
@@ -1264,11 +1932,12 @@ void QFieldCloudProjectsModel::projectUpload( const QString &projectId, const bo
   NetworkReply *deltasCloudReply = mCloudConnection->post(
     QStringLiteral( "/api/v1/deltas/%1/" ).arg( projectId ),
     QVariantMap(),
-    QStringList( { deltaFileToUpload } ) );
+    QStringList( { deltaFileToUpload } ),
+    true );
 
   Q_ASSERT( deltasCloudReply );
 
-  connect( deltasCloudReply, &NetworkReply::uploadProgress, this, [=]( int bytesSent, int bytesTotal ) {
+  connect( deltasCloudReply, &NetworkReply::uploadProgress, this, [=]( qint64 bytesSent, qint64 bytesTotal ) {
     project->uploadDeltaProgress = std::clamp( ( static_cast<double>( bytesSent ) / bytesTotal ), 0., 1. );
 
     emit dataChanged( projectIndex, projectIndex, QVector<int>() << UploadDeltaProgressRole );
@@ -1547,7 +2216,6 @@ void QFieldCloudProjectsModel::connectionStatusChanged()
 
 void QFieldCloudProjectsModel::layerObserverLayerEdited( const QString &layerId )
 {
-  Q_UNUSED( layerId )
   CloudProject *project = findProject( mCurrentProjectId );
 
   if ( !project )
@@ -1556,6 +2224,12 @@ void QFieldCloudProjectsModel::layerObserverLayerEdited( const QString &layerId
     return;
   }
 
+  // the committed layer file no longer matches its cached checksum, the modification time alone may not tell
+  // when the commit happens within the file system timestamp resolution of the previous write
+  const QgsMapLayer *layer = mProject->mapLayer( layerId );
+  if ( layer && layer->dataProvider() )
+    fileChecksumCache()->remove( layerFileName( layer ) );
+
   beginResetModel();
 
   const DeltaFileWrapper *deltaFileWrapper = mLayerObserver->deltaFileWrapper();
@@ -1570,10 +2244,10 @@ void QFieldCloudProjectsModel::layerObserverLayerEdited( const QString &layerId
   endResetModel();
 }
 
-void QFieldCloudProjectsModel::projectListReceived()
+void QFieldCloudProjectsModel::projectListReceived( NetworkReply *reply, bool isPublic )
 {
-  NetworkReply *reply = qobject_cast<NetworkReply *>( sender() );
   QNetworkReply *rawReply = reply->reply();
+  reply->deleteLater();
 
   Q_ASSERT( rawReply );
 
@@ -1583,22 +2257,85 @@ void QFieldCloudProjectsModel::projectListReceived()
     return;
   }
 
+  const QString snapshotFilePath = projectsListSnapshotFilePath( mUsername, isPublic );
+
+  if ( rawReply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt() == 304 )
+  {
+    // the remote list did not change, local projects may have been downloaded or removed since, reload the
+    // stored snapshot to refresh their local state, the model only applies the differences
+    reload( readProjectsListSnapshot( isPublic ).value( QStringLiteral( "projects" ) ).toArray() );
+    mProjectsListSnapshotFilePath = snapshotFilePath;
+    return;
+  }
+
   QByteArray response = rawReply->readAll();
 
   QJsonDocument doc = QJsonDocument::fromJson( response );
   QJsonArray projects = doc.array();
   reload( projects );
+
+  mProjectsListSnapshotFilePath = snapshotFilePath;
+  writeProjectsListSnapshot( isPublic, projects, rawReply->rawHeader( "ETag" ), rawReply->rawHeader( "Last-Modified" ) );
+}
+
+QJsonObject QFieldCloudProjectsModel::readProjectsListSnapshot( bool isPublic ) const
+{
+  if ( mUsername.isEmpty() )
+    return QJsonObject();
+
+  QFile snapshotFile( projectsListSnapshotFilePath( mUsername, isPublic ) );
+  if ( !snapshotFile.open( QIODevice::ReadOnly ) )
+    return QJsonObject();
+
+  const QJsonObject snapshot = QJsonDocument::fromJson( snapshotFile.readAll() ).object();
+  if ( snapshot.value( QStringLiteral( "url" ) ).toString() != mCloudConnection->url() )
+    return QJsonObject();
+
+  return snapshot;
+}
+
+void QFieldCloudProjectsModel::writeProjectsListSnapshot( bool isPublic, const QJsonArray &projects, const QByteArray &etag, const QByteArray &lastModified ) const
+{
+  if ( mUsername.isEmpty() )
+    return;
+
+  QJsonObject snapshot;
+  snapshot.insert( QStringLiteral( "url" ), mCloudConnection->url() );
+  snapshot.insert( QStringLiteral( "etag" ), QString::fromUtf8( etag ) );
+  snapshot.insert( QStringLiteral( "last_modified" ), QString::fromUtf8( lastModified ) );
+  snapshot.insert( QStringLiteral( "projects" ), projects );
+
+  const QString snapshotFilePath = projectsListSnapshotFilePath( mUsername, isPublic );
+  QDir().mkpath( QFileInfo( snapshotFilePath ).absolutePath() );
+
+  QSaveFile snapshotFile( snapshotFilePath );
+  if ( !snapshotFile.open( QIODevice::WriteOnly ) || snapshotFile.write( QJsonDocument( snapshot ).toJson( QJsonDocument::Compact ) ) == -1 || !snapshotFile.commit() )
+  {
+    QgsMessageLog::logMessage( tr( "Failed to store the cloud projects list snapshot to `%1`" ).arg( snapshotFilePath ), QStringLiteral( "QFieldCloud" ) );
+  }
 }
 
-NetworkReply *QFieldCloudProjectsModel::downloadFile( const QString &projectId, const QString &fileName )
+NetworkReply *QFieldCloudProjectsModel::downloadFile( const QString &projectId, const QString &fileName, qint64 rangeStart )
 {
   QNetworkRequest request;
   request.setAttribute( QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::RedirectPolicy::UserVerifiedRedirectPolicy );
+  if ( rangeStart > 0 )
+    request.setRawHeader( "Range", QStringLiteral( "bytes=%1-" ).arg( rangeStart ).toLatin1() );
   mCloudConnection->setAuthenticationToken( request );
 
   return mCloudConnection->get( request, QStringLiteral( "/api/v1/packages/%1/latest/files/%2/" ).arg( projectId, fileName ) );
 }
 
+NetworkReply *QFieldCloudProjectsModel::downloadFileDelta( const QString &projectId, const QString &fileName, const QByteArray &signature )
+{
+  QNetworkRequest request;
+  // deltas are computed by the API itself, a redirect means the server does not support them
+  request.setAttribute( QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::RedirectPolicy::ManualRedirectPolicy );
+  request.setHeader( QNetworkRequest::ContentTypeHeader, "application/octet-stream" );
+  mCloudConnection->setAuthenticationToken( request );
+
+  return mCloudConnection->post( request, QStringLiteral( "/api/v1/packages/%1/latest/files/%2/delta/" ).arg( projectId, fileName ), signature );
+}
 
 void QFieldCloudProjectsModel::downloadFileConnections( const QString &projectId, const QString &fileName )
 {
@@ -1662,6 +2399,8 @@ void QFieldCloudProjectsModel::downloadFileConnections( const QString &projectId
     QgsLogger::debug( QStringLiteral( "Package %1, file `%2`: redirected to `%3`" ).arg( projectId, fileName, url.toString() ) );
 
     QNetworkRequest request;
+    if ( project->downloadFileTransfers[fileName].resumeOffset > 0 )
+      request.setRawHeader( "Range", QStringLiteral( "bytes=%1-" ).arg( project->downloadFileTransfers[fileName].resumeOffset ).toLatin1() );
     project->downloadFileTransfers[fileName].networkReply = mCloudConnection->get( request, url );
     project->downloadFileTransfers[fileName].networkReply->setParent( reply );
 
@@ -1671,7 +2410,41 @@ void QFieldCloudProjectsModel::downloadFileConnections( const QString &projectId
     downloadFileConnections( projectId, fileName );
   } );
 
-  connect( reply, &NetworkReply::downloadProgress, reply, [=]( int bytesReceived, int bytesTotal ) {
+  connect( reply, &NetworkReply::readyRead, reply, [=]() {
+    if ( !findProject( projectId ) || !project->downloadFileTransfers.contains( fileName ) )
+      return;
+
+    FileTransfer &transfer = project->downloadFileTransfers[fileName];
+
+    // redirected requests and error responses do not carry the file content
+    QNetworkReply *rawReply = reply->currentReply();
+    const int httpStatusCode = rawReply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt();
+    if ( transfer.networkReply != reply || !transfer.partialFile || ( httpStatusCode != 200 && httpStatusCode != 206 ) || ( transfer.isDelta && httpStatusCode != 200 ) )
+      return;
+
+    if ( transfer.resumeOffset > 0 && httpStatusCode == 200 )
+    {
+      QgsLogger::debug( QStringLiteral( "Project %1, file `%2`: the server does not support resuming, downloading from the start" ).arg( projectId, fileName ) );
+      transfer.partialFile->resize( 0 );
+      transfer.partialFileHash->reset();
+      transfer.resumeOffset = 0;
+    }
+
+    // stream the received chunk straight into the partial download file, never buffering the whole file in memory
+    const QByteArray data = rawReply->readAll();
+    if ( transfer.partialFile->write( data ) != data.size() )
+    {
+      transfer.writeErrorString = transfer.partialFile->errorString();
+      reply->abort();
+      return;
+    }
+
+    // a delta is only hashed once the file is rebuilt out of it
+    if ( !transfer.isDelta )
+      transfer.partialFileHash->addData( data );
+  } );
+
+  connect( reply, &NetworkReply::downloadProgress, reply, [=]( qint64 bytesReceived, qint64 bytesTotal ) {
     if ( !findProject( projectId ) )
     {
       QgsLogger::debug( QStringLiteral( "Project %1, file `%2`: updating download progress, but the project is deleted." ).arg( projectId, fileName ) );
@@ -1680,13 +2453,18 @@ void QFieldCloudProjectsModel::downloadFileConnections( const QString &projectId
 
     Q_UNUSED( bytesTotal )
 
+    if ( project->downloadFileTransfers[fileName].networkReply != reply )
+      return;
+
     // it means the NetworkReply has failed and retried
     project->downloadBytesReceived -= project->downloadFileTransfers[fileName].bytesTransferred;
-    project->downloadBytesReceived += bytesReceived;
-    project->downloadFileTransfers[fileName].bytesTransferred = bytesReceived;
-    project->downloadProgress = std::clamp( ( static_cast<double>( project->downloadBytesReceived ) / std::max( project->downloadBytesTotal, 1 ) ), 0., 1. );
+    project->downloadFileTransfers[fileName].bytesTransferred = project->downloadFileTransfers[fileName].resumeOffset + bytesReceived;
+    project->downloadBytesReceived += project->downloadFileTransfers[fileName].bytesTransferred;
+    project->downloadProgress = std::clamp( ( static_cast<double>( project->downloadBytesReceived ) / std::max<qint64>( project->downloadBytesTotal, 1 ) ), 0., 1. );
+
+    updateDownloadThroughput( projectId );
 
-    emit dataChanged( projectIndex, projectIndex, QVector<int>() << DownloadProgressRole );
+    emit dataChanged( projectIndex, projectIndex, QVector<int>() << DownloadProgressRole << DownloadBytesPerSecondRole << DownloadSecondsRemainingRole );
   } );
 
   connect( reply, &NetworkReply::finished, reply, [=]() {
@@ -1699,9 +2477,6 @@ void QFieldCloudProjectsModel::downloadFileConnections( const QString &projectId
       return;
     }
 
-    QVector<int> rolesChanged;
-    QNetworkReply *rawReply = reply->reply();
-
     Q_ASSERT( reply->isFinished() );
     Q_ASSERT( reply );
 
@@ -1709,118 +2484,189 @@ void QFieldCloudProjectsModel::downloadFileConnections( const QString &projectId
     if ( project->downloadFileTransfers[fileName].networkReply != reply )
       return;
 
-    project->downloadFilesFinished++;
+    // the file is only complete once rebuilt out of the delta, which happens in the background
+    if ( project->downloadFileTransfers[fileName].isDelta )
+    {
+      projectApplyDownloadedFileDelta( projectId, fileName );
+      return;
+    }
+
+    projectDownloadFileFinished( projectId, fileName );
+  } );
+}
 
-    bool hasError = false;
-    QString errorMessageDetail;
-    QString errorMessage;
+void QFieldCloudProjectsModel::projectDownloadFileFinished( const QString &projectId, const QString &fileName )
+{
+  CloudProject *project = findProject( projectId );
+  if ( !project || !project->downloadFileTransfers.contains( fileName ) )
+    return;
 
-    if ( rawReply->error() != QNetworkReply::NoError )
+  const QModelIndex projectIndex = findProjectIndex( projectId );
+  const QStringList fileNames = project->downloadFileTransfers.keys();
+  FileTransfer &transfer = project->downloadFileTransfers[fileName];
+  QNetworkReply *rawReply = transfer.networkReply->reply();
+  QVector<int> rolesChanged;
+
+  bool hasError = false;
+  bool canResume = false;
+  QString errorMessageDetail;
+  QString errorMessage;
+
+  if ( !transfer.writeErrorString.isEmpty() || !transfer.partialFile )
+  {
+    hasError = true;
+    errorMessageDetail = transfer.writeErrorString;
+    errorMessage = tr( "File system error. Failed to write file to temporary location `%1`." ).arg( transfer.tmpFile );
+  }
+  else if ( rawReply->error() != QNetworkReply::NoError )
+  {
+    hasError = true;
+    errorMessageDetail = QFieldCloudConnection::errorString( rawReply );
+    errorMessage = tr( "Network error. Failed to download file `%1`." ).arg( fileName );
+
+    switch ( rawReply->error() )
+    {
+      case QNetworkReply::RemoteHostClosedError:
+      case QNetworkReply::TimeoutError:
+      case QNetworkReply::TemporaryNetworkFailureError:
+      case QNetworkReply::NetworkSessionFailedError:
+      case QNetworkReply::ProxyTimeoutError:
+      case QNetworkReply::ServiceUnavailableError:
+      case QNetworkReply::UnknownNetworkError:
+        canResume = true;
+        break;
+      default:
+        break;
+    }
+  }
+  else
+  {
+    // any remaining data not consumed on readyRead yet
+    const QByteArray data = rawReply->readAll();
+    if ( !data.isEmpty() )
     {
-      hasError = true;
-      errorMessageDetail = QFieldCloudConnection::errorString( rawReply );
-      errorMessage = tr( "Network error. Failed to download file `%1`." ).arg( fileName );
+      transfer.partialFile->write( data );
+      transfer.partialFileHash->addData( data );
     }
 
-    if ( !hasError )
+    if ( !transfer.partialFile->flush() || transfer.partialFile->error() != QFile::NoError )
     {
-      QFile file( project->downloadFileTransfers[fileName].tmpFile );
-
-      if ( file.open( QIODevice::ReadWrite ) )
-      {
-        file.write( rawReply->readAll() );
+      hasError = true;
+      errorMessageDetail = transfer.partialFile->errorString();
+      errorMessage = tr( "File system error. Failed to write file to temporary location `%1`." ).arg( transfer.tmpFile );
+    }
+    else if ( QString( transfer.partialFileHash->result().toHex() ) != transfer.checksum )
+    {
+      hasError = true;
+      errorMessage = tr( "Checksum mismatch. The downloaded file `%1` is corrupted." ).arg( fileName );
 
-        if ( file.error() != QFile::NoError )
-        {
-          hasError = true;
-          errorMessageDetail = file.errorString();
-          errorMessage = tr( "File system error. Failed to write file to temporary location `%1`." ).arg( project->downloadFileTransfers[fileName].tmpFile );
-        }
-      }
-      else
-      {
-        hasError = true;
-        errorMessageDetail = file.errorString();
-        errorMessage = tr( "File system error. Failed to open file for writing on temporary `%1`." ).arg( project->downloadFileTransfers[fileName].tmpFile );
-      }
+      // a corrupted partial file cannot be resumed, start from scratch next time
+      projectClosePartialDownloadFile( projectId, fileName );
+      QFile::remove( transfer.tmpFile );
+      QFile::remove( QStringLiteral( "%1.sha256" ).arg( transfer.tmpFile ) );
     }
+  }
 
-    // check if the code above failed with error
-    if ( hasError )
-    {
-      project->downloadFilesFailed++;
+  projectClosePartialDownloadFile( projectId, fileName );
 
-      QgsLogger::debug( QStringLiteral( "Project %1, file `%2`: %3 %4" ).arg( errorMessage, fileName, errorMessage, errorMessageDetail ) );
+  if ( hasError && canResume && transfer.resumeAttempts < MAX_DOWNLOAD_RESUME_ATTEMPTS )
+  {
+    reduceDownloadConcurrency();
 
-      // translate the user messages
-      const QString baseMessage = tr( "Project `%1`, file `%2`: %3" ).arg( project->name, fileName, errorMessage );
-      const QString trimmedMessage = baseMessage + QStringLiteral( " " ) + tr( "System message: " )
-                                     + ( ( errorMessageDetail.size() > 100 )
-                                           ? ( errorMessageDetail.left( 100 ) + tr( " (see more in the QField error log)…" ) )
-                                           : errorMessageDetail );
+    transfer.resumeAttempts++;
+    transfer.networkReply = nullptr;
 
-      QgsMessageLog::logMessage( QStringLiteral( "%1\n%2" ).arg( baseMessage, errorMessageDetail ) );
+    // back off before resuming the transfer from where it stopped
+    const int delay = sDelayBeforeStatusRetry * ( 1 << std::min( transfer.resumeAttempts - 1, 4 ) );
+    QgsLogger::debug( QStringLiteral( "Project %1, file `%2`: %3 %4, resuming in %5 ms" ).arg( projectId, fileName, errorMessage, errorMessageDetail ).arg( delay ) );
 
-      emit projectDownloadFinished( projectId, trimmedMessage );
+    QTimer::singleShot( delay, this, [=]() {
+      CloudProject *project = findProject( projectId );
+      if ( !project || project->status != ProjectStatus::Downloading || project->packagingStatus == PackagingAbortStatus || !project->downloadFileTransfers.contains( fileName ) )
+        return;
 
-      return;
-    }
+      projectDownloadFiles( projectId );
+    } );
+    return;
+  }
 
-    QgsLogger::debug( QStringLiteral( "Package %1, file `%2`: downloaded" ).arg( projectId, fileName ) );
+  project->downloadFilesFinished++;
 
-    updateActiveProjectFilesToDownload( projectId );
+  // check if the code above failed with error
+  if ( hasError )
+  {
+    project->downloadFilesFailed++;
 
-    if ( project->downloadFilesFinished == fileNames.count() )
-    {
-      QgsLogger::debug( QStringLiteral( "Project %1: All files downloaded." ).arg( projectId ) );
+    QgsLogger::debug( QStringLiteral( "Project %1, file `%2`: %3 %4" ).arg( errorMessage, fileName, errorMessage, errorMessageDetail ) );
 
-      Q_ASSERT( mActiveProjectFilesToDownload.size() == 0 );
+    // translate the user messages
+    const QString baseMessage = tr( "Project `%1`, file `%2`: %3" ).arg( project->name, fileName, errorMessage );
+    const QString trimmedMessage = baseMessage + QStringLiteral( " " ) + tr( "System message: " )
+                                   + ( ( errorMessageDetail.size() > 100 )
+                                         ? ( errorMessageDetail.left( 100 ) + tr( " (see more in the QField error log)…" ) )
+                                         : errorMessageDetail );
 
-      if ( !hasError )
-      {
-        const QStringList unprefixedGpkgFileNames = filterGpkgFileNames( fileNames );
-        const QStringList gpkgFileNames = projectFileNames( mProject->homePath(), unprefixedGpkgFileNames );
-        // we need to close the project to safely flush the gpkg files
-        mProject->setFileName( QString() );
+    QgsMessageLog::logMessage( QStringLiteral( "%1\n%2" ).arg( baseMessage, errorMessageDetail ) );
 
-        for ( const QString &fileName : gpkgFileNames )
-          mGpkgFlusher->stop( fileName );
+    emit projectDownloadFinished( projectId, trimmedMessage );
 
-        // move the files from their temporary location to their permanent one
-        if ( !projectMoveDownloadedFilesToPermanentStorage( projectId ) )
-        {
-          emit projectDownloadFinished( projectId, tr( "Failed to copy some of the downloaded files on your device. Check your device storage." ) );
-          return;
-        }
+    return;
+  }
 
-        deleteGpkgShmAndWal( gpkgFileNames );
+  QgsLogger::debug( QStringLiteral( "Package %1, file `%2`: downloaded" ).arg( projectId, fileName ) );
 
-        for ( const QString &fileName : gpkgFileNames )
-          mGpkgFlusher->start( fileName );
+  updateActiveProjectFilesToDownload( projectId );
 
-        project->errorStatus = NoErrorStatus;
-        project->packagingStatus = PackagingFinishedStatus;
-        project->packagingStatusString = QString();
-        project->checkout = ProjectCheckout::LocalAndRemoteCheckout;
-        project->localPath = QFieldCloudUtils::localProjectFilePath( mUsername, projectId );
-        project->lastLocalExportedAt = QDateTime::currentDateTimeUtc().toString( Qt::ISODate );
-        project->lastLocalExportId = QUuid::createUuid().toString( QUuid::WithoutBraces );
-        QFieldCloudUtils::setProjectSetting( projectId, QStringLiteral( "lastExportedAt" ), project->lastExportedAt );
-        QFieldCloudUtils::setProjectSetting( projectId, QStringLiteral( "lastExportId" ), project->lastExportId );
-        QFieldCloudUtils::setProjectSetting( projectId, QStringLiteral( "lastLocalExportedAt" ), project->lastLocalExportedAt );
-        QFieldCloudUtils::setProjectSetting( projectId, QStringLiteral( "lastLocalExportId" ), project->lastLocalExportId );
+  if ( project->downloadFilesFinished == fileNames.count() )
+  {
+    QgsLogger::debug( QStringLiteral( "Project %1: All files downloaded." ).arg( projectId ) );
 
-        rolesChanged << StatusRole << LocalPathRole << CheckoutRole << LastLocalExportedAtRole;
+    Q_ASSERT( mActiveProjectFilesToDownload.size() == 0 );
 
-        emit dataChanged( projectIndex, projectIndex, rolesChanged );
-        emit projectDownloadFinished( projectId );
-      }
-    }
-    else
+    if ( !hasError )
     {
-      projectDownloadFiles( projectId );
+      const QStringList unprefixedGpkgFileNames = filterGpkgFileNames( fileNames );
+      const QStringList gpkgFileNames = projectFileNames( mProject->homePath(), unprefixedGpkgFileNames );
+      // we need to close the project to safely flush the gpkg files
+      mProject->setFileName( QString() );
+
+      for ( const QString &fileName : gpkgFileNames )
+        mGpkgFlusher->stop( fileName );
+
+      // move the files from their temporary location to their permanent one
+      if ( !projectMoveDownloadedFilesToPermanentStorage( projectId ) )
+      {
+        emit projectDownloadFinished( projectId, tr( "Failed to install some of the downloaded files on your device. Check your device storage." ) );
+        return;
+      }
+
+      deleteGpkgShmAndWal( gpkgFileNames );
+
+      for ( const QString &fileName : gpkgFileNames )
+        mGpkgFlusher->start( fileName );
+
+      project->errorStatus = NoErrorStatus;
+      project->packagingStatus = PackagingFinishedStatus;
+      project->packagingStatusString = QString();
+      project->checkout = ProjectCheckout::LocalAndRemoteCheckout;
+      project->localPath = QFieldCloudUtils::localProjectFilePath( mUsername, projectId );
+      project->lastLocalExportedAt = QDateTime::currentDateTimeUtc().toString( Qt::ISODate );
+      project->lastLocalExportId = QUuid::createUuid().toString( QUuid::WithoutBraces );
+      QFieldCloudUtils::setProjectSetting( projectId, QStringLiteral( "lastExportedAt" ), project->lastExportedAt );
+      QFieldCloudUtils::setProjectSetting( projectId, QStringLiteral( "lastExportId" ), project->lastExportId );
+      QFieldCloudUtils::setProjectSetting( projectId, QStringLiteral( "lastLocalExportedAt" ), project->lastLocalExportedAt );
+      QFieldCloudUtils::setProjectSetting( projectId, QStringLiteral( "lastLocalExportId" ), project->lastLocalExportId );
+
+      rolesChanged << StatusRole << LocalPathRole << CheckoutRole << LastLocalExportedAtRole;
+
+      emit dataChanged( projectIndex, projectIndex, rolesChanged );
+      emit projectDownloadFinished( projectId );
     }
-  } );
+  }
+  else
+  {
+    projectDownloadFiles( projectId );
+  }
 }
 
 QHash<int, QByteArray> QFieldCloudProjectsModel::roleNames() const
@@ -1849,18 +2695,23 @@ QHash<int, QByteArray> QFieldCloudProjectsModel::roleNames() const
   roles[LastLocalPushDeltasRole] = "LastLocalPushDeltas";
   roles[UserRoleRole] = "UserRole";
   roles[DeltaListRole] = "DeltaList";
+  roles[DownloadBytesPerSecondRole] = "DownloadBytesPerSecond";
+  roles[DownloadSecondsRemainingRole] = "DownloadSecondsRemaining";
 
   return roles;
 }
 
 void QFieldCloudProjectsModel::reload( const QJsonArray &remoteProjects )
 {
-  beginResetModel();
-  mProjects.clear();
+  QList<CloudProject *> projects;
+  mProjectsListSnapshotFilePath.clear();
 
   QgsProject *qgisProject = QgsProject::instance();
 
   auto restoreLocalSettings = [=]( CloudProject *cloudProject, const QDir &localPath ) {
+    // restore the project files if an install of downloaded files was interrupted, before the project gets opened
+    projectRollbackInterruptedInstall( cloudProject->id );
+
     cloudProject->deltasCount = DeltaFileWrapper( qgisProject, QStringLiteral( "%1/deltafile.json" ).arg( localPath.absolutePath() ) ).count();
     cloudProject->lastExportId = QFieldCloudUtils::projectSetting( cloudProject->id, QStringLiteral( "lastExportId" ) ).toString();
     cloudProject->lastExportedAt = QFieldCloudUtils::projectSetting( cloudProject->id, QStringLiteral( "lastExportedAt" ) ).toString();
@@ -1915,7 +2766,7 @@ void QFieldCloudProjectsModel::reload( const QJsonArray &remoteProjects )
 
     cloudProject->lastRefreshedAt = QDateTime::currentDateTimeUtc();
 
-    mProjects << cloudProject;
+    projects << cloudProject;
   }
 
   QDirIterator userDirs( QFieldCloudUtils::localCloudDirectory(), QDir::Dirs | QDir::NoDotAndDotDot );
@@ -1934,8 +2785,7 @@ void QFieldCloudProjectsModel::reload( const QJsonArray &remoteProjects )
       projectDirs.next();
 
       const QString projectId = projectDirs.fileName();
-      CloudProject *project = findProject( projectId );
-      if ( project )
+      if ( std::any_of( projects.constBegin(), projects.constEnd(), [&projectId]( const CloudProject *project ) { return project->id == projectId; } ) )
         continue;
 
       const QString projectPrefix = QStringLiteral( "QFieldCloud/projects/%1" ).arg( projectId );
@@ -1954,15 +2804,111 @@ void QFieldCloudProjectsModel::reload( const QJsonArray &remoteProjects )
       QDir localPath( QStringLiteral( "%1/%2/%3" ).arg( QFieldCloudUtils::localCloudDirectory(), username, cloudProject->id ) );
       restoreLocalSettings( cloudProject, localPath );
 
-      mProjects << cloudProject;
+      projects << cloudProject;
 
       Q_ASSERT( projectId == cloudProject->id );
     }
   }
 
-  endResetModel();
+  // apply the differences to the current list, so views keep their state and busy projects their progress
+  QSet<QString> projectIds;
+  for ( const CloudProject *project : std::as_const( projects ) )
+    projectIds.insert( project->id );
+
+  for ( int i = mProjects.size() - 1; i >= 0; i-- )
+  {
+    // busy projects are kept until their transfers are over
+    if ( projectIds.contains( mProjects.at( i )->id ) || mProjects.at( i )->status != ProjectStatus::Idle )
+      continue;
+
+    beginRemoveRows( QModelIndex(), i, i );
+    mProjects.removeAt( i );
+    endRemoveRows();
+  }
+
+  for ( int i = 0; i < projects.size(); i++ )
+  {
+    CloudProject *project = projects.at( i );
+
+    int existingRow = -1;
+    for ( int j = i; j < mProjects.size(); j++ )
+    {
+      if ( mProjects.at( j )->id == project->id )
+      {
+        existingRow = j;
+        break;
+      }
+    }
+
+    if ( existingRow == -1 )
+    {
+      beginInsertRows( QModelIndex(), i, i );
+      mProjects.insert( i, project );
+      endInsertRows();
+      continue;
+    }
+
+    if ( existingRow != i )
+    {
+      beginMoveRows( QModelIndex(), existingRow, existingRow, QModelIndex(), i );
+      mProjects.move( existingRow, i );
+      endMoveRows();
+    }
+
+    if ( updateProject( mProjects.at( i ), project ) )
+    {
+      const QModelIndex projectIndex = index( i, 0 );
+      emit dataChanged( projectIndex, projectIndex );
+    }
+
+    delete project;
+  }
+
+  if ( !mCurrentProjectId.isEmpty() && findProject( mCurrentProjectId ) )
+  {
+    emit currentProjectDataChanged();
+    refreshProjectModification( mCurrentProjectId );
+  }
+}
+
+bool QFieldCloudProjectsModel::updateProject( CloudProject *project, const CloudProject *updatedProject )
+{
+  bool changed = false;
+
+  auto update = [&changed]( auto &value, const auto &updatedValue ) {
+    if ( value != updatedValue )
+    {
+      value = updatedValue;
+      changed = true;
+    }
+  };
+
+  update( project->isPrivate, updatedProject->isPrivate );
+  update( project->owner, updatedProject->owner );
+  update( project->name, updatedProject->name );
+  update( project->description, updatedProject->description );
+  update( project->userRole, updatedProject->userRole );
+  update( project->canRepackage, updatedProject->canRepackage );
+  update( project->needsRepackaging, updatedProject->needsRepackaging );
+  project->lastRefreshedAt = updatedProject->lastRefreshedAt;
+
+  // the local state of busy projects is owned by their ongoing transfers
+  if ( project->status == ProjectStatus::Idle )
+  {
+    update( project->checkout, updatedProject->checkout );
+    update( project->localPath, updatedProject->localPath );
+    update( project->deltasCount, updatedProject->deltasCount );
+    project->lastExportId = updatedProject->lastExportId;
+    project->lastExportedAt = updatedProject->lastExportedAt;
+    project->lastLocalExportId = updatedProject->lastLocalExportId;
+    project->lastLocalExportedAt = updatedProject->lastLocalExportedAt;
+    project->lastLocalPushDeltas = updatedProject->lastLocalPushDeltas;
+  }
+
+  return changed;
 }
 
+
 int QFieldCloudProjectsModel::rowCount( const QModelIndex &parent ) const
 {
   if ( !parent.isValid() )
@@ -2013,6 +2959,10 @@ QVariant QFieldCloudProjectsModel::data( const QModelIndex &index, int role ) co
       return QVariant( mProjects.at( index.row() )->packagedLayerErrors );
     case DownloadProgressRole:
       return mProjects.at( index.row() )->downloadProgress;
+    case DownloadBytesPerSecondRole:
+      return mProjects.at( index.row() )->downloadBytesPerSecond;
+    case DownloadSecondsRemainingRole:
+      return mProjects.at( index.row() )->downloadSecondsRemaining;
     case UploadDeltaProgressRole:
       return mProjects.at( index.row() )->uploadDeltaProgress;
     case UploadDeltaStatusRole:
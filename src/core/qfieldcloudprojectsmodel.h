@@ -21,11 +21,18 @@
 #include "qgsnetworkaccessmanager.h"
 
 #include <QAbstractListModel>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QJsonObject>
 #include <QNetworkReply>
 #include <QSortFilterProxyModel>
 #include <QTimer>
 
+#include <memory>
 
+
+class FileChecksumCache;
+class QFile;
 class QNetworkRequest;
 class QFieldCloudConnection;
 class NetworkReply;
@@ -64,6 +71,8 @@ class QFieldCloudProjectsModel : public QAbstractListModel
       LastLocalPushDeltasRole,
       UserRoleRole,
       DeltaListRole,
+      DownloadBytesPerSecondRole,
+      DownloadSecondsRemainingRole,
     };
 
     Q_ENUM( ColumnRole )
@@ -257,7 +266,11 @@ class QFieldCloudProjectsModel : public QAbstractListModel
     //! Returns the data at given \a index with given \a role.
     QVariant data( const QModelIndex &index, int role ) const override;
 
-    //! Reloads the list of cloud projects with the given list of \a remoteProjects.
+    /**
+     * Reloads the list of cloud projects with the given list of \a remoteProjects.
+     * Only the differences with the current list are applied, rows are inserted, moved,
+     * removed or updated in place.
+     */
     Q_INVOKABLE void reload( const QJsonArray &remoteProjects );
 
     //! Downloads a cloud project with given \a projectId and all of its files.
@@ -293,7 +306,6 @@ class QFieldCloudProjectsModel : public QAbstractListModel
 
   private slots:
     void connectionStatusChanged();
-    void projectListReceived();
 
     void layerObserverLayerEdited( const QString &layerId );
 
@@ -321,6 +333,25 @@ class QFieldCloudProjectsModel : public QAbstractListModel
         QStringList layerIds;
         int redirectsCount = 0;
         QUrl lastRedirectUrl;
+
+        //! The sha256 checksum of the file as provided by the server
+        QString checksum;
+        //! The partial download file the response is streamed into, owned by the model while the transfer is active
+        QFile *partialFile = nullptr;
+        //! The incremental sha256 hash of the partial download file content
+        std::shared_ptr<QCryptographicHash> partialFileHash;
+        //! The number of bytes already present in the partial download file when the current request was sent
+        long long resumeOffset = 0;
+        //! The number of times the transfer was resumed after a temporary network error
+        int resumeAttempts = 0;
+        //! Error message set when writing the partial download file failed
+        QString writeErrorString;
+        //! Whether the signature of the local copy is being computed ahead of a delta transfer
+        bool isPreparingDelta = false;
+        //! Whether the current request fetches a block-level delta against the local copy instead of the whole file
+        bool isDelta = false;
+        //! Set once a delta transfer failed, the whole file is downloaded instead
+        bool skipDelta = false;
     };
 
     //! Tracks the job status (status, error etc) for a particular project. For now 1 project can have only 1 job of a type.
@@ -338,6 +369,10 @@ class QFieldCloudProjectsModel : public QAbstractListModel
         QString projectId;
         JobType type;
         JobStatus status = JobPendingStatus;
+        //! The status as last reported by the server, used to wait for its next change
+        QString statusString;
+        //! Number of status requests since the status last changed or the server last waited for a change
+        int statusPollAttempts = 0;
     };
 
     //! Tracks the cloud project information. It means it is not required CloudProject data to be already downloaded on the device.
@@ -400,9 +435,11 @@ class QFieldCloudProjectsModel : public QAbstractListModel
         QMap<QString, FileTransfer> downloadFileTransfers;
         int downloadFilesFinished = 0;
         int downloadFilesFailed = 0;
-        int downloadBytesTotal = 0;
-        int downloadBytesReceived = 0;
+        qint64 downloadBytesTotal = 0;
+        qint64 downloadBytesReceived = 0;
         double downloadProgress = 0.0; // range from 0.0 to 1.0
+        double downloadBytesPerSecond = 0.0;
+        qint64 downloadSecondsRemaining = -1;
 
         double uploadDeltaProgress = 0.0; // range from 0.0 to 1.0
         int deltasCount = 0;
@@ -420,6 +457,27 @@ class QFieldCloudProjectsModel : public QAbstractListModel
 
     inline QString layerFileName( const QgsMapLayer *layer ) const;
 
+    void projectListReceived( NetworkReply *reply, bool isPublic );
+
+    /**
+     * Requests the status of the \a jobType job of project \a projectId again. The request is sent
+     * right away if \a retryImmediately is TRUE, otherwise after a delay growing with the number of
+     * requests since the status last changed.
+     */
+    void retryProjectGetJobStatus( const QString &projectId, const JobType jobType, bool retryImmediately );
+
+    /**
+     * Copies the server side details and, for idle projects, the local state of \a updatedProject to \a project.
+     * \returns TRUE when a value exposed through the model roles changed.
+     */
+    bool updateProject( CloudProject *project, const CloudProject *updatedProject );
+
+    //! Returns the stored projects list snapshot of the current user, either the public or the user's projects list
+    QJsonObject readProjectsListSnapshot( bool isPublic ) const;
+
+    //! Stores the \a projects list alongside its \a etag and \a lastModified headers to be reused by conditional requests
+    void writeProjectsListSnapshot( bool isPublic, const QJsonArray &projects, const QByteArray &etag, const QByteArray &lastModified ) const;
+
     QList<CloudProject *> mProjects;
     QFieldCloudConnection *mCloudConnection = nullptr;
     QString mCurrentProjectId;
@@ -428,24 +486,61 @@ class QFieldCloudProjectsModel : public QAbstractListModel
     QgsGpkgFlusher *mGpkgFlusher = nullptr;
     QString mUsername;
     QStringList mActiveProjectFilesToDownload;
+    //! The local file checksums cache, shared with the tasks hashing local files in the background
+    std::shared_ptr<FileChecksumCache> mFileChecksumCache;
+    QString mFileChecksumCacheFilePath;
+    //! The snapshot file the currently shown projects list was loaded from, if any
+    QString mProjectsListSnapshotFilePath;
+    //! Whether delta downloads failed for a non-transient reason and are turned off for the session
+    bool mFileDeltaDisabled = false;
+
+    //! The number of files downloaded in parallel, adapted to the measured throughput and errors
+    int mDownloadConcurrency;
+    //! The direction of the last concurrency change, 1 when increased, -1 when decreased and 0 when unchanged
+    int mDownloadConcurrencyTrend = 0;
+    QElapsedTimer mDownloadSampleTimer;
+    qint64 mDownloadSampleBytes = 0;
+    double mDownloadSampleBytesPerSecond = 0.0;
 
     QModelIndex findProjectIndex( const QString &projectId ) const;
     CloudProject *findProject( const QString &projectId ) const;
     void projectCancelUpload( const QString &projectId );
     void projectGetDeltaStatus( const QString &projectId );
     bool projectMoveDownloadedFilesToPermanentStorage( const QString &projectId );
+    void projectRollbackInterruptedInstall( const QString &projectId );
     void projectRefreshData( const QString &projectId, const ProjectRefreshReason &refreshReason );
     void projectStartJob( const QString &projectId, const JobType jobType );
     void projectGetJobStatus( const QString &projectId, const JobType jobType );
     void projectDownload( const QString &projectId );
+    //! Queues the packaged files listed in \a payload whose local checksums differ for download
+    void projectDownloadCompareFiles( const QString &projectId, const QJsonObject &payload, const QStringList &projectFileNames, const QHash<QString, QByteArray> &localChecksums );
+
+    //! Returns the local file checksums cache of the current local cloud directory
+    std::shared_ptr<FileChecksumCache> fileChecksumCache();
 
     QString projectGetDir( const QString &projectId, const QString &setting );
     void projectSetSetting( const QString &projectId, const QString &setting, const QVariant &value );
     QVariant projectSetting( const QString &projectId, const QString &setting, const QVariant &defaultValue = QVariant() );
 
-    NetworkReply *downloadFile( const QString &projectId, const QString &fileName );
+    NetworkReply *downloadFile( const QString &projectId, const QString &fileName, qint64 rangeStart = 0 );
+    bool projectOpenPartialDownloadFile( const QString &projectId, const QString &fileName, QString &errorString );
+    void projectClosePartialDownloadFile( const QString &projectId, const QString &fileName );
+    bool projectCanDownloadFileDelta( const QString &projectId, const QString &fileName ) const;
+    void projectDownloadFileDelta( const QString &projectId, const QString &fileName );
+    //! Rebuilds the downloaded file out of the received delta in the background, falling back to a whole file download on failure
+    void projectApplyDownloadedFileDelta( const QString &projectId, const QString &fileName );
+    //! Finalizes the transfer of a downloaded file and installs the project files once they are all downloaded
+    void projectDownloadFileFinished( const QString &projectId, const QString &fileName );
+    //! Returns whether the current server recently answered it does not support delta downloads, or failed them this session
+    bool fileDeltaUnsupported() const;
+    //! Remembers across sessions that the current server does not support delta downloads
+    void setFileDeltaUnsupported();
+    NetworkReply *downloadFileDelta( const QString &projectId, const QString &fileName, const QByteArray &signature );
     void projectDownloadFiles( const QString &projectId );
     void updateActiveProjectFilesToDownload( const QString &projectId );
+    void updateDownloadThroughput( const QString &projectId );
+    void adaptDownloadConcurrency( double bytesPerSecond );
+    void reduceDownloadConcurrency();
 
     bool canSyncProject( const QString &projectId ) const;
 
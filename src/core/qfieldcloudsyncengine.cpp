@@ -0,0 +1,325 @@
+/***************************************************************************
+    qfieldcloudsyncengine.cpp
+    ---------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by OPENGIS.ch
+    email                : info at opengis dot ch
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "layerobserver.h"
+#include "qfieldcloudconnection.h"
+#include "qfieldcloudprojectsmodel.h"
+#include "qfieldcloudsyncengine.h"
+#include "qfieldcloudutils.h"
+#include "qgsgpkgflusher.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QTimer>
+#include <qgsmessagelog.h>
+#include <qgsproject.h>
+
+#define MAX_SYNC_ATTEMPTS 3
+
+QFieldCloudSyncEngine::QFieldCloudSyncEngine( QFieldCloudConnection *connection, QObject *parent )
+  : QObject( parent )
+  , mConnection( connection )
+{
+}
+
+QFieldCloudSyncEngine::~QFieldCloudSyncEngine()
+{
+  // the projects model refers to the layer observer and gpkg flusher, make sure it goes first
+  mProjectsModel.reset();
+}
+
+bool QFieldCloudSyncEngine::downloadUpdates() const
+{
+  return mDownloadUpdates;
+}
+
+void QFieldCloudSyncEngine::setDownloadUpdates( bool downloadUpdates )
+{
+  mDownloadUpdates = downloadUpdates;
+}
+
+bool QFieldCloudSyncEngine::isRunning() const
+{
+  return mIsRunning;
+}
+
+bool QFieldCloudSyncEngine::start()
+{
+  if ( mIsRunning )
+    return true;
+
+  mUsername = mConnection->username();
+  if ( mUsername.isEmpty() || ( !mConnection->hasToken() && mConnection->status() != QFieldCloudConnection::ConnectionStatus::LoggedIn ) )
+  {
+    QgsMessageLog::logMessage( tr( "Cannot synchronize cloud projects without a logged in user" ), QStringLiteral( "QFieldCloud" ) );
+    return false;
+  }
+
+  QDir().mkpath( QStringLiteral( "%1/%2" ).arg( QFieldCloudUtils::localCloudDirectory(), mUsername ) );
+  mLockFile = std::make_unique<QLockFile>( QStringLiteral( "%1/%2/sync.lock" ).arg( QFieldCloudUtils::localCloudDirectory(), mUsername ) );
+  if ( !mLockFile->tryLock( 0 ) )
+  {
+    QgsMessageLog::logMessage( tr( "The cloud projects of `%1` are already being synchronized" ).arg( mUsername ), QStringLiteral( "QFieldCloud" ) );
+    mLockFile.reset();
+    return false;
+  }
+
+  mIsRunning = true;
+  readState();
+
+  QgsProject *project = QgsProject::instance();
+  mGpkgFlusher = std::make_unique<QgsGpkgFlusher>( project );
+  mLayerObserver = std::make_unique<LayerObserver>( project );
+  mProjectsModel = std::make_unique<QFieldCloudProjectsModel>();
+  mProjectsModel->setGpkgFlusher( mGpkgFlusher.get() );
+  mProjectsModel->setLayerObserver( mLayerObserver.get() );
+  mProjectsModel->setCloudConnection( mConnection );
+  // list the local projects right away, the remote details get merged once the projects list is received
+  mProjectsModel->reload( QJsonArray() );
+
+  connect( mProjectsModel.get(), &QFieldCloudProjectsModel::pushFinished, this, [=]( const QString &projectId, bool hasError, const QString &errorString ) {
+    // a successful push followed by a download is only over once the download is
+    if ( !hasError && mDownloadUpdates )
+      return;
+
+    finishProject( projectId, hasError, errorString );
+  } );
+  connect( mProjectsModel.get(), &QFieldCloudProjectsModel::projectDownloaded, this, [=]( const QString &projectId, const QString &, const bool hasError, const QString &errorString ) {
+    finishProject( projectId, hasError, errorString );
+  } );
+
+  connect( mConnection, &QFieldCloudConnection::statusChanged, this, &QFieldCloudSyncEngine::connectionStatusChanged );
+  connect( mConnection, &QFieldCloudConnection::loginFailed, this, &QFieldCloudSyncEngine::loginFailed );
+
+  if ( mConnection->status() == QFieldCloudConnection::ConnectionStatus::LoggedIn )
+  {
+    connectionStatusChanged();
+  }
+  else if ( mConnection->status() == QFieldCloudConnection::ConnectionStatus::Disconnected )
+  {
+    mConnection->login();
+  }
+
+  return true;
+}
+
+void QFieldCloudSyncEngine::connectionStatusChanged()
+{
+  if ( !mIsRunning )
+    return;
+
+  switch ( mConnection->status() )
+  {
+    case QFieldCloudConnection::ConnectionStatus::LoggedIn:
+      if ( !mIsSynchronizing )
+      {
+        mIsSynchronizing = true;
+        enqueueProjects();
+        synchronizeNextProject();
+      }
+      break;
+
+    case QFieldCloudConnection::ConnectionStatus::Disconnected:
+      // the token got invalidated midway, what is left is kept for the next run
+      if ( mIsSynchronizing )
+      {
+        QgsMessageLog::logMessage( tr( "Cloud connection lost, cloud projects synchronization interrupted" ), QStringLiteral( "QFieldCloud" ) );
+        finish();
+      }
+      break;
+
+    case QFieldCloudConnection::ConnectionStatus::Connecting:
+      break;
+  }
+}
+
+void QFieldCloudSyncEngine::loginFailed( const QString &reason )
+{
+  QgsMessageLog::logMessage( tr( "Cloud projects synchronization aborted, login failed: %1" ).arg( reason ), QStringLiteral( "QFieldCloud" ) );
+  finish();
+}
+
+void QFieldCloudSyncEngine::enqueueProjects()
+{
+  // projects left over by a previous run come first
+  mQueue = mState.keys();
+
+  for ( int row = 0; row < mProjectsModel->rowCount( QModelIndex() ); row++ )
+  {
+    const QModelIndex index = mProjectsModel->index( row, 0 );
+    const QString projectId = index.data( QFieldCloudProjectsModel::IdRole ).toString();
+    const QFieldCloudProjectsModel::ProjectCheckouts checkout( index.data( QFieldCloudProjectsModel::CheckoutRole ).toInt() );
+
+    if ( !( checkout & QFieldCloudProjectsModel::LocalCheckout ) || mQueue.contains( projectId ) )
+      continue;
+
+    if ( mDownloadUpdates || index.data( QFieldCloudProjectsModel::LocalDeltasCountRole ).toInt() > 0 )
+    {
+      mQueue << projectId;
+      mState.insert( projectId, QJsonObject( { { QStringLiteral( "attempts" ), 0 } } ) );
+    }
+  }
+
+  writeState();
+}
+
+void QFieldCloudSyncEngine::synchronizeNextProject()
+{
+  if ( !mIsRunning )
+    return;
+
+  if ( mQueue.isEmpty() )
+  {
+    // attachments queued by the pushed deltas are uploaded last
+    connect( mConnection, &QFieldCloudConnection::pendingAttachmentsUploadFinished, this, &QFieldCloudSyncEngine::finish, Qt::UniqueConnection );
+    if ( mConnection->uploadPendingAttachments() == 0 )
+      finish();
+    return;
+  }
+
+  const QString projectId = mQueue.takeFirst();
+  const QString projectFilePath = QFieldCloudUtils::localProjectFilePath( mUsername, projectId );
+  mCurrentProjectId = projectId;
+
+  // layers are not loaded, the delta file and the attachment fields settings are all that is needed
+  if ( projectFilePath.isEmpty() || !QgsProject::instance()->read( projectFilePath, Qgis::ProjectReadFlag::DontResolveLayers ) )
+  {
+    finishProject( projectId, true, tr( "Failed to open the local copy of the project" ) );
+    return;
+  }
+
+  mProjectsModel->setCurrentProjectId( projectId );
+
+  if ( mLayerObserver->deltaFileWrapper()->count() > 0 )
+  {
+    mProjectsModel->projectUpload( projectId, mDownloadUpdates );
+  }
+  else if ( mDownloadUpdates )
+  {
+    mProjectsModel->projectPackageAndDownload( projectId );
+  }
+  else
+  {
+    finishProject( projectId, false );
+    return;
+  }
+
+  // the project is not known to the cloud anymore or was not in a state allowing to synchronize it
+  if ( mProjectsModel->projectStatus( projectId ) == QFieldCloudProjectsModel::ProjectStatus::Idle )
+  {
+    finishProject( projectId, true, tr( "The project could not be synchronized" ) );
+  }
+}
+
+void QFieldCloudSyncEngine::finishProject( const QString &projectId, bool hasError, const QString &errorString )
+{
+  if ( projectId != mCurrentProjectId )
+    return;
+
+  mCurrentProjectId.clear();
+  mProjectsModel->setCurrentProjectId( QString() );
+  QgsProject::instance()->clear();
+
+  if ( hasError )
+  {
+    const int attempts = mState.value( projectId ).toObject().value( QStringLiteral( "attempts" ) ).toInt() + 1;
+    if ( attempts < MAX_SYNC_ATTEMPTS )
+    {
+      mState.insert( projectId, QJsonObject( { { QStringLiteral( "attempts" ), attempts } } ) );
+    }
+    else
+    {
+      mState.remove( projectId );
+    }
+
+    QgsMessageLog::logMessage( tr( "Synchronizing cloud project `%1` failed (attempt %2 of %3): %4" ).arg( projectId ).arg( attempts ).arg( MAX_SYNC_ATTEMPTS ).arg( errorString ), QStringLiteral( "QFieldCloud" ) );
+  }
+  else
+  {
+    mState.remove( projectId );
+  }
+
+  writeState();
+
+  emit projectSynchronized( projectId, hasError, errorString );
+
+  // leave the projects model signal handlers before moving on to the next project
+  QTimer::singleShot( 0, this, &QFieldCloudSyncEngine::synchronizeNextProject );
+}
+
+void QFieldCloudSyncEngine::finish()
+{
+  if ( !mIsRunning )
+    return;
+
+  disconnect( mConnection, nullptr, this, nullptr );
+
+  if ( !mCurrentProjectId.isEmpty() )
+  {
+    mCurrentProjectId.clear();
+    QgsProject::instance()->clear();
+  }
+
+  writeState();
+
+  mQueue.clear();
+  mIsRunning = false;
+  mIsSynchronizing = false;
+  mLockFile.reset();
+
+  emit finished();
+}
+
+QString QFieldCloudSyncEngine::stateFilePath() const
+{
+  return QStringLiteral( "%1/%2/sync.json" ).arg( QFieldCloudUtils::localCloudDirectory(), mUsername );
+}
+
+void QFieldCloudSyncEngine::readState()
+{
+  mState = QJsonObject();
+
+  QFile stateFile( stateFilePath() );
+  if ( !stateFile.open( QIODevice::ReadOnly ) )
+    return;
+
+  const QJsonObject state = QJsonDocument::fromJson( stateFile.readAll() ).object();
+  if ( state.value( QStringLiteral( "url" ) ).toString() != mConnection->url() )
+    return;
+
+  mState = state.value( QStringLiteral( "projects" ) ).toObject();
+}
+
+void QFieldCloudSyncEngine::writeState() const
+{
+  if ( mState.isEmpty() )
+  {
+    QFile::remove( stateFilePath() );
+    return;
+  }
+
+  QJsonObject state;
+  state.insert( QStringLiteral( "url" ), mConnection->url() );
+  state.insert( QStringLiteral( "projects" ), mState );
+
+  QSaveFile stateFile( stateFilePath() );
+  if ( !stateFile.open( QIODevice::WriteOnly ) || stateFile.write( QJsonDocument( state ).toJson( QJsonDocument::Compact ) ) == -1 || !stateFile.commit() )
+  {
+    QgsMessageLog::logMessage( tr( "Failed to store the cloud projects synchronization state to `%1`" ).arg( stateFilePath() ), QStringLiteral( "QFieldCloud" ) );
+  }
+}
@@ -0,0 +1,105 @@
+/***************************************************************************
+    qfieldcloudsyncengine.h
+    ---------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by OPENGIS.ch
+    email                : info at opengis dot ch
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QFIELDCLOUDSYNCENGINE_H
+#define QFIELDCLOUDSYNCENGINE_H
+
+#include <QJsonObject>
+#include <QLockFile>
+#include <QObject>
+#include <QStringList>
+#include <memory>
+
+class LayerObserver;
+class QFieldCloudConnection;
+class QFieldCloudProjectsModel;
+class QgsGpkgFlusher;
+
+/**
+ * Synchronizes the locally checked out cloud projects of the logged in user without any user interface.
+ *
+ * Each project is opened in turn, its local changes are pushed and, unless disabled, its latest
+ * package is downloaded by the upload and download state machines of QFieldCloudProjectsModel.
+ * Pending attachments are uploaded once all projects are done.
+ *
+ * The projects left to synchronize are persisted, so a run that was interrupted or that failed
+ * resumes with them on the next run, while partially downloaded files are resumed by the
+ * projects model itself. Only one engine synchronizes a given user's projects at a time.
+ *
+ * The engine relies on QgsProject::instance(), it is meant for processes that have no opened project
+ * such as the background service or the command line sync tool.
+ */
+class QFieldCloudSyncEngine : public QObject
+{
+    Q_OBJECT
+
+  public:
+    explicit QFieldCloudSyncEngine( QFieldCloudConnection *connection, QObject *parent = nullptr );
+    ~QFieldCloudSyncEngine() override;
+
+    //! Returns whether the latest package of each project is downloaded after pushing its local changes
+    bool downloadUpdates() const;
+
+    //! Sets whether the latest package of each project is downloaded after pushing its local changes
+    void setDownloadUpdates( bool downloadUpdates );
+
+    //! Returns whether a synchronization is ongoing
+    bool isRunning() const;
+
+    /**
+     * Starts synchronizing the projects of the user of the cloud connection, logging in with the stored token if needed.
+     * \returns FALSE if no user is known or another synchronization of the same user is ongoing.
+     */
+    bool start();
+
+  signals:
+    //! Emitted when the synchronization of project \a projectId is over, with \a errorString describing the failure if any
+    void projectSynchronized( const QString &projectId, bool hasError, const QString &errorString );
+
+    //! Emitted when the synchronization is over
+    void finished();
+
+  private:
+    void connectionStatusChanged();
+    void loginFailed( const QString &reason );
+
+    void enqueueProjects();
+    void synchronizeNextProject();
+    void finishProject( const QString &projectId, bool hasError, const QString &errorString = QString() );
+    void finish();
+
+    QString stateFilePath() const;
+    void readState();
+    void writeState() const;
+
+    QFieldCloudConnection *mConnection = nullptr;
+    std::unique_ptr<QgsGpkgFlusher> mGpkgFlusher;
+    std::unique_ptr<LayerObserver> mLayerObserver;
+    std::unique_ptr<QFieldCloudProjectsModel> mProjectsModel;
+    std::unique_ptr<QLockFile> mLockFile;
+
+    bool mDownloadUpdates = true;
+    bool mIsRunning = false;
+    bool mIsSynchronizing = false;
+
+    QString mUsername;
+    QString mCurrentProjectId;
+    //! Projects left to synchronize during this run
+    QStringList mQueue;
+    //! Persisted projects left to synchronize, with their count of failed attempts
+    QJsonObject mState;
+};
+
+#endif // QFIELDCLOUDSYNCENGINE_H
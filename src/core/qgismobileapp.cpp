@@ -112,6 +112,7 @@
 #include <QFileInfo>
 #include <QFontDatabase>
 #include <QPalette>
+#include <QPointer>
 #include <QQmlFileSelector>
 #include <QResource>
 #include <QScreen>
@@ -680,6 +681,9 @@ void QgisMobileapp::readProjectFile()
 
   const QString suffix = fi.suffix().toLower();
 
+  // the export renders the current project layers, which go away as the project gets cleared or read
+  abortPrint();
+
   mProject->removeAllMapLayers();
   mProject->setTitle( QString() );
 
@@ -1196,6 +1200,9 @@ double QgisMobileapp::readProjectDoubleEntry( const QString &scope, const QStrin
 
 bool QgisMobileapp::print( const QString &layoutName )
 {
+  if ( mPrintLayoutExportJob )
+    return false;
+
   const QList<QgsPrintLayout *> printLayouts = mProject->layoutManager()->printLayouts();
   QgsPrintLayout *layoutToPrint = nullptr;
   for ( QgsPrintLayout *layout : printLayouts )
@@ -1218,56 +1225,20 @@ bool QgisMobileapp::print( const QString &layoutName )
 
   if ( !layoutToPrint->atlas() || !layoutToPrint->atlas()->enabled() )
   {
+    // the export job works on a clone, adjust the layout before it gets cloned
     if ( layoutToPrint->referenceMap() )
       layoutToPrint->referenceMap()->zoomToExtent( mMapCanvas->mapSettings()->visibleExtent() );
     layoutToPrint->refresh();
-
-    QgsLayoutExporter exporter = QgsLayoutExporter( layoutToPrint );
-
-#ifndef QT_NO_PRINTER
-    QgsLayoutExporter::PdfExportSettings pdfSettings;
-    pdfSettings.rasterizeWholeImage = layoutToPrint->customProperty( QStringLiteral( "rasterize" ), false ).toBool();
-    pdfSettings.dpi = layoutToPrint->renderContext().dpi();
-    pdfSettings.appendGeoreference = true;
-    pdfSettings.exportMetadata = true;
-    pdfSettings.simplifyGeometries = true;
-    QgsLayoutExporter::ExportResult result = exporter.exportToPdf( destination, pdfSettings );
-#else
-    QgsLayoutExporter::ImageExportSettings imageSettings;
-    imageSettings.dpi = layoutToPrint->renderContext().dpi();
-    imageSettings.exportMetadata = true;
-    QgsLayoutExporter::ExportResult result = exporter.exportToImage( destination, imageSettings );
-#endif
-
-    if ( result == QgsLayoutExporter::Success )
-      PlatformUtilities::instance()->open( destination );
-
-    return result == QgsLayoutExporter::Success ? true : false;
-  }
-  else
-  {
-    bool success = printAtlas( layoutToPrint, destination );
-    if ( success )
-    {
-#ifndef QT_NO_PRINTER
-      if ( layoutToPrint->customProperty( QStringLiteral( "singleFile" ), true ).toBool() )
-      {
-        PlatformUtilities::instance()->open( destination );
-      }
-      else
-      {
-        PlatformUtilities::instance()->open( mProject->homePath() );
-      }
-#else
-      PlatformUtilities::instance()->open( mProject->homePath() );
-#endif
-    }
-    return success;
   }
+
+  return startPrint( layoutToPrint, destination );
 }
 
 bool QgisMobileapp::printAtlasFeatures( const QString &layoutName, const QList<long long> &featureIds )
 {
+  if ( mPrintLayoutExportJob )
+    return false;
+
   const QList<QgsPrintLayout *> printLayouts = mProject->layoutManager()->printLayouts();
   QgsPrintLayout *layoutToPrint = nullptr;
   for ( QgsPrintLayout *layout : printLayouts )
@@ -1295,87 +1266,110 @@ bool QgisMobileapp::printAtlasFeatures( const QString &layoutName, const QList<l
   layoutToPrint->atlas()->setFilterExpression( QStringLiteral( "$id IN (%1)" ).arg( ids.join( ',' ) ), error );
   layoutToPrint->atlas()->setFilterFeatures( true );
 
+  // the filter is carried over to the layout clone of the export job, the project layout can be restored right away
   const QString destination = mProject->homePath() + '/' + layoutToPrint->name() + '-' + QDateTime::currentDateTime().toString( QStringLiteral( "yyyyMMdd_hhmmss" ) ) + QStringLiteral( ".pdf" );
-  const bool success = printAtlas( layoutToPrint, destination );
+  const bool started = startPrint( layoutToPrint, destination );
 
   layoutToPrint->atlas()->setFilterExpression( priorFilterExpression, error );
   layoutToPrint->atlas()->setFilterFeatures( priorFilterFeatures );
 
-  if ( success )
-  {
-#ifndef QT_NO_PRINTER
-    if ( layoutToPrint->customProperty( QStringLiteral( "singleFile" ), true ).toBool() )
-    {
-      PlatformUtilities::instance()->open( destination );
-    }
-    else
-    {
-      PlatformUtilities::instance()->open( mProject->homePath() );
-    }
-#else
-    PlatformUtilities::instance()->open( mProject->homePath() );
-#endif
-  }
-  return success;
+  return started;
 }
 
-bool QgisMobileapp::printAtlas( QgsPrintLayout *layoutToPrint, const QString &destination )
+void QgisMobileapp::cancelPrint()
 {
-  QString error;
+  if ( mPrintLayoutExportJob )
+    mPrintLayoutExportJob->cancel();
+}
+
+void QgisMobileapp::abortPrint()
+{
+  if ( !mPrintLayoutExportJob )
+    return;
+
+  PrintLayoutExportJob *job = mPrintLayoutExportJob.release();
+  disconnect( job, nullptr, nullptr, nullptr );
+  job->cancel();
+
+  // the export runs on the main thread, when events are being processed from within the export it stops as soon
+  // as it gets control back and is deleted once it returned to the event loop
+  if ( job->isExporting() )
+    job->deleteLater();
+  else
+    delete job;
+
+  emit mIface->printFinished( false, tr( "The export was canceled" ) );
+}
+
+bool QgisMobileapp::startPrint( QgsPrintLayout *layoutToPrint, const QString &destination )
+{
+  const bool hasAtlas = layoutToPrint->atlas() && layoutToPrint->atlas()->enabled();
 
-  QVector<double> mapScales = layoutToPrint->project()->viewSettings()->mapScales();
-  bool hasProjectScales( layoutToPrint->project()->viewSettings()->useProjectScales() );
-  if ( !hasProjectScales || mapScales.isEmpty() )
+  mPrintLayoutExportJob = std::make_unique<PrintLayoutExportJob>( layoutToPrint, destination );
+
+#ifndef QT_NO_PRINTER
+  mPrintLayoutExportJob->exportToPdf = true;
+  mPrintLayoutExportJob->singleFile = layoutToPrint->customProperty( QStringLiteral( "singleFile" ), true ).toBool();
+  mPrintLayoutExportJob->pdfSettings.rasterizeWholeImage = layoutToPrint->customProperty( QStringLiteral( "rasterize" ), false ).toBool();
+  mPrintLayoutExportJob->pdfSettings.dpi = layoutToPrint->renderContext().dpi();
+  mPrintLayoutExportJob->pdfSettings.appendGeoreference = true;
+  mPrintLayoutExportJob->pdfSettings.exportMetadata = true;
+  mPrintLayoutExportJob->pdfSettings.simplifyGeometries = true;
+#else
+  mPrintLayoutExportJob->exportToPdf = false;
+  mPrintLayoutExportJob->singleFile = !hasAtlas;
+  mPrintLayoutExportJob->imageSettings.dpi = layoutToPrint->renderContext().dpi();
+  mPrintLayoutExportJob->imageSettings.exportMetadata = true;
+  mPrintLayoutExportJob->imageExtension = layoutToPrint->customProperty( QStringLiteral( "atlasRasterFormat" ), QStringLiteral( "JPG" ) ).toString();
+#endif
+
+  if ( hasAtlas )
   {
-    // default to global map tool scales
-    const QStringList scales = Qgis::defaultProjectScales().split( ',' );
-    for ( const QString &scale : scales )
+    QVector<double> mapScales = layoutToPrint->project()->viewSettings()->mapScales();
+    bool hasProjectScales( layoutToPrint->project()->viewSettings()->useProjectScales() );
+    if ( !hasProjectScales || mapScales.isEmpty() )
     {
-      QStringList parts( scale.split( ':' ) );
-      if ( parts.size() == 2 )
+      // default to global map tool scales
+      const QStringList scales = Qgis::defaultProjectScales().split( ',' );
+      for ( const QString &scale : scales )
       {
-        mapScales.push_back( parts[1].toDouble() );
+        QStringList parts( scale.split( ':' ) );
+        if ( parts.size() == 2 )
+        {
+          mapScales.push_back( parts[1].toDouble() );
+        }
       }
     }
+    mPrintLayoutExportJob->pdfSettings.predefinedMapScales = mapScales;
   }
 
-#ifndef QT_NO_PRINTER
-  QgsLayoutExporter::PdfExportSettings pdfSettings;
-  pdfSettings.rasterizeWholeImage = layoutToPrint->customProperty( QStringLiteral( "rasterize" ), false ).toBool();
-  pdfSettings.dpi = layoutToPrint->renderContext().dpi();
-  pdfSettings.appendGeoreference = true;
-  pdfSettings.exportMetadata = true;
-  pdfSettings.simplifyGeometries = true;
-  pdfSettings.predefinedMapScales = mapScales;
-#else
-  QgsLayoutExporter::ImageExportSettings imageSettings;
-  imageSettings.dpi = layoutToPrint->renderContext().dpi();
-  imageSettings.exportMetadata = true;
-#endif
+  // single files are opened once exported, the project folder is opened when atlas pages land in separate files
+  const QString openPath = !hasAtlas || mPrintLayoutExportJob->singleFile ? destination : mProject->homePath();
 
-  if ( layoutToPrint->atlas()->updateFeatures() )
-  {
-    QgsLayoutExporter exporter = QgsLayoutExporter( layoutToPrint );
-    QgsLayoutExporter::ExportResult result;
+  connect( mPrintLayoutExportJob.get(), &PrintLayoutExportJob::progressChanged, mIface, &AppInterface::printProgressChanged );
+  QPointer<PrintLayoutExportJob> job = mPrintLayoutExportJob.get();
+  connect( job, &PrintLayoutExportJob::finished, this, [=]( bool success, const QString &error ) {
+    if ( success )
+      PlatformUtilities::instance()->open( openPath );
 
-#ifndef QT_NO_PRINTER
-    if ( layoutToPrint->customProperty( QStringLiteral( "singleFile" ), true ).toBool() )
-    {
-      result = exporter.exportToPdf( layoutToPrint->atlas(), destination, pdfSettings, error );
-    }
-    else
-    {
-      result = exporter.exportToPdfs( layoutToPrint->atlas(), destination, pdfSettings, error );
-    }
-#else
-    const QString extension = layoutToPrint->customProperty( QStringLiteral( "atlasRasterFormat" ), QStringLiteral( "JPG" ) ).toString();
-    result = exporter.exportToImage( layoutToPrint->atlas(), destination, extension, imageSettings, error );
-#endif
+    emit mIface->printFinished( success, error );
 
-    return result == QgsLayoutExporter::Success ? true : false;
+    // the job emitting the signal can't be deleted right away, by then it may have been aborted and replaced
+    QMetaObject::invokeMethod(
+      this, [=]() {
+        if ( job && mPrintLayoutExportJob.get() == job )
+          mPrintLayoutExportJob.reset();
+      },
+      Qt::QueuedConnection );
+  } );
+
+  if ( !mPrintLayoutExportJob->start() )
+  {
+    mPrintLayoutExportJob.reset();
+    return false;
   }
 
-  return false;
+  return true;
 }
 
 void QgisMobileapp::setScreenDimmerTimeout( int timeoutSeconds )
@@ -1402,6 +1396,7 @@ void QgisMobileapp::requestQuit()
 
 QgisMobileapp::~QgisMobileapp()
 {
+  abortPrint();
   delete mOfflineEditing;
   mProject->removeAllMapLayers();
   delete mProject;
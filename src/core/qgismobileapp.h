@@ -34,6 +34,7 @@
 #include "geometryeditorsmodel.h"
 #include "multifeaturelistmodel.h"
 #include "platformutilities.h"
+#include "printlayoutexportjob.h"
 #include "qfield_core_export.h"
 #include "qfieldappauthrequesthandler.h"
 #include "qgsgpkgflusher.h"
@@ -147,7 +148,7 @@ class QFIELD_CORE_EXPORT QgisMobileapp : public QQmlApplicationEngine
     /**
      * Prints a given layout from the currently opened project to a PDF file
      * \param layoutName the layout name that will be printed
-     * \return TRUE if the layout was successfully printed
+     * \return TRUE if the layout export was started, progress and outcome are reported through the app interface
      */
     bool print( const QString &layoutName );
 
@@ -155,10 +156,15 @@ class QFIELD_CORE_EXPORT QgisMobileapp : public QQmlApplicationEngine
      * Prints a given atlas-driven layout from the currently opened project to one or more PDF files
      * \param layoutName the layout name that will be printed
      * \param featureIds the features from the atlas coverage vector layer that will be used to print the layout
-     * \return TRUE if the layout was successfully printed
+     * \return TRUE if the layout export was started, progress and outcome are reported through the app interface
      */
     bool printAtlasFeatures( const QString &layoutName, const QList<long long> &featureIds );
 
+    /**
+     * Cancels the ongoing layout export, if any
+     */
+    void cancelPrint();
+
     /**
      * Sets the screen dimmer timeout in seconds
      * \note setting the timeout value to 0 will disable the screen dimmer
@@ -202,7 +208,9 @@ class QFIELD_CORE_EXPORT QgisMobileapp : public QQmlApplicationEngine
   private:
     void initDeclarative();
     void loadProjectQuirks();
-    bool printAtlas( QgsPrintLayout *layoutToPrint, const QString &destination );
+    bool startPrint( QgsPrintLayout *layoutToPrint, const QString &destination );
+    //! Cancels the ongoing layout export, if any, and drops it right away rather than once finished
+    void abortPrint();
 
     QgsOfflineEditing *mOfflineEditing = nullptr;
     LayerTreeMapCanvasBridge *mLayerTreeCanvasBridge = nullptr;
@@ -236,6 +244,7 @@ class QFIELD_CORE_EXPORT QgisMobileapp : public QQmlApplicationEngine
     AppMissingGridHandler *mAppMissingGridHandler = nullptr;
 
     std::unique_ptr<ScreenDimmer> mScreenDimmer;
+    std::unique_ptr<PrintLayoutExportJob> mPrintLayoutExportJob;
     QgsApplication *mApp;
 };
 
@@ -118,6 +118,17 @@ class QgsElevationProfilePlotItem : public Qgs2DPlot
       if ( !mRenderer )
         return;
 
+      // cached source images are only valid for the plot transform they were rendered with
+      const QgsDoubleRange distanceRange( xMinimum(), xMaximum() );
+      const QgsDoubleRange elevationRange( yMinimum(), yMaximum() );
+      if ( distanceRange != mCachedDistanceRange || elevationRange != mCachedElevationRange || plotArea.size() != mCachedPlotAreaSize )
+      {
+        mCachedImages.clear();
+        mCachedDistanceRange = distanceRange;
+        mCachedElevationRange = elevationRange;
+        mCachedPlotAreaSize = plotArea.size();
+      }
+
       const QStringList sourceIds = mRenderer->sourceIds();
       for ( const QString &source : sourceIds )
       {
@@ -153,6 +164,9 @@ class QgsElevationProfilePlotItem : public Qgs2DPlot
 
     QRectF mPlotArea;
     QMap<QString, QImage> mCachedImages;
+    QgsDoubleRange mCachedDistanceRange;
+    QgsDoubleRange mCachedElevationRange;
+    QSizeF mCachedPlotAreaSize;
 };
 
 
@@ -258,10 +272,29 @@ void QgsQuickElevationProfileCanvas::refresh()
   if ( !mCrs.isValid() || !mProject || mProfileCurve.isEmpty() )
     return;
 
+  const QList<QgsMapLayer *> layersToGenerate = layers();
+  if ( mCurrentJob
+       && !mCurrentJob->isActive()
+       && mCurrentJobCrs == mCrs
+       && mCurrentJobTolerance == mTolerance
+       && mCurrentJobLayers == layersToGenerate
+       && mCurrentJobProfileCurve.equals( mProfileCurve ) )
+  {
+    // The profile request is unchanged and the current job is idle, only regenerate what was invalidated.
+    // An active job cannot be restarted in place, it is replaced by a new one below.
+    mPlotItem->updatePlot();
+    mCurrentJob->regenerateInvalidatedResults();
+
+    emit activeJobCountChanged( 1 );
+    emit isRenderingChanged();
+    return;
+  }
+
   if ( mCurrentJob )
   {
     mPlotItem->setRenderer( nullptr );
     disconnect( mCurrentJob, &QgsProfilePlotRenderer::generationFinished, this, &QgsQuickElevationProfileCanvas::generationFinished );
+    mCurrentJob->cancelGenerationWithoutBlocking();
     mCurrentJob->deleteLater();
     mCurrentJob = nullptr;
   }
@@ -277,7 +310,6 @@ void QgsQuickElevationProfileCanvas::refresh()
   context.appendScope( QgsExpressionContextUtils::projectScope( mProject ) );
   request.setExpressionContext( context );
 
-  const QList<QgsMapLayer *> layersToGenerate = layers();
   QList<QgsAbstractProfileSource *> sources;
   sources.reserve( layersToGenerate.size() );
   for ( QgsMapLayer *layer : layersToGenerate )
@@ -287,6 +319,10 @@ void QgsQuickElevationProfileCanvas::refresh()
   }
 
   mCurrentJob = new QgsProfilePlotRenderer( sources, request );
+  mCurrentJobProfileCurve = mProfileCurve;
+  mCurrentJobCrs = mCrs;
+  mCurrentJobTolerance = mTolerance;
+  mCurrentJobLayers = layersToGenerate;
   connect( mCurrentJob, &QgsProfilePlotRenderer::generationFinished, this, &QgsQuickElevationProfileCanvas::generationFinished );
 
   QgsProfileGenerationContext generationContext;
@@ -316,10 +352,41 @@ void QgsQuickElevationProfileCanvas::generationFinished()
     zoomFull();
   }
 
-  QRectF rect = boundingRect();
+  redraw();
+
+  if ( mForceRegenerationAfterCurrentJobCompletes )
+  {
+    mForceRegenerationAfterCurrentJobCompletes = false;
+    mCurrentJob->invalidateAllRefinableSources();
+    scheduleDeferredRegeneration();
+  }
+  else
+  {
+    emit isRenderingChanged();
+  }
+}
+
+void QgsQuickElevationProfileCanvas::redraw()
+{
+  mDeferredRedrawTimer->stop();
+  mDeferredRedrawScheduled = false;
+
+  if ( !mCurrentJob || !window() )
+    return;
+
+  const QRectF rect = boundingRect();
   const double devicePixelRatio = window()->screen()->devicePixelRatio();
-  mImage = QImage( rect.width() * devicePixelRatio, rect.height() * devicePixelRatio, QImage::Format_ARGB32_Premultiplied );
-  mImage.setDevicePixelRatio( devicePixelRatio );
+  const QSize imageSize( rect.width() * devicePixelRatio, rect.height() * devicePixelRatio );
+  if ( imageSize.isEmpty() )
+    return;
+
+  // Recycle the image buffer when its size is unchanged, the scene graph texture releases its
+  // reference to the image once uploaded
+  if ( mImage.size() != imageSize || !qgsDoubleNear( mImage.devicePixelRatio(), devicePixelRatio ) )
+  {
+    mImage = QImage( imageSize, QImage::Format_ARGB32_Premultiplied );
+    mImage.setDevicePixelRatio( devicePixelRatio );
+  }
   mImage.fill( Qt::transparent );
 
   QPainter imagePainter( &mImage );
@@ -336,17 +403,6 @@ void QgsQuickElevationProfileCanvas::generationFinished()
 
   mDirty = true;
   update();
-
-  if ( mForceRegenerationAfterCurrentJobCompletes )
-  {
-    mForceRegenerationAfterCurrentJobCompletes = false;
-    mCurrentJob->invalidateAllRefinableSources();
-    scheduleDeferredRegeneration();
-  }
-  else
-  {
-    emit isRenderingChanged();
-  }
 }
 
 void QgsQuickElevationProfileCanvas::onLayerProfileGenerationPropertyChanged()
@@ -440,8 +496,8 @@ void QgsQuickElevationProfileCanvas::startDeferredRegeneration()
 
 void QgsQuickElevationProfileCanvas::startDeferredRedraw()
 {
-  refresh();
-  mDeferredRedrawScheduled = false;
+  // Redrawing only re-renders existing results with the current plot transform, without regenerating the profile
+  redraw();
 }
 
 void QgsQuickElevationProfileCanvas::refineResults()
@@ -568,17 +624,25 @@ void QgsQuickElevationProfileCanvas::geometryChange( const QRectF &newGeometry,
   QQuickItem::geometryChange( newGeometry, oldGeometry );
 #endif
   mPlotItem->updateRect();
-  mDirty = true;
-  refresh();
+  if ( mCurrentJob )
+  {
+    // Generated results do not depend on the canvas size, only refine them for the new resolution
+    refineResults();
+    scheduleDeferredRedraw();
+  }
+  else
+  {
+    refresh();
+  }
 }
 
 QSGNode *QgsQuickElevationProfileCanvas::updatePaintNode( QSGNode *oldNode, QQuickItem::UpdatePaintNodeData * )
 {
-  if ( mDirty )
+  // The old node can only be reused when it is of the type matching the current image state
+  if ( oldNode && ( mImage.isNull() != !dynamic_cast<QSGSimpleTextureNode *>( oldNode ) ) )
   {
     delete oldNode;
     oldNode = nullptr;
-    mDirty = false;
   }
 
   QSGNode *newNode = nullptr;
@@ -588,9 +652,15 @@ QSGNode *QgsQuickElevationProfileCanvas::updatePaintNode( QSGNode *oldNode, QQui
     if ( !node )
     {
       node = new QSGSimpleTextureNode();
-      QSGTexture *texture = window()->createTextureFromImage( mImage );
-      node->setTexture( texture );
       node->setOwnsTexture( true );
+      mDirty = true;
+    }
+
+    if ( mDirty )
+    {
+      // Swapping the texture of an owning node deletes the previous texture
+      node->setTexture( window()->createTextureFromImage( mImage ) );
+      mDirty = false;
     }
 
     QRectF rect( boundingRect() );
@@ -661,6 +731,7 @@ void QgsQuickElevationProfileCanvas::zoomFull()
   mPlotItem->setXMaximum( profileLength * 1.02 );
 
   refineResults();
+  scheduleDeferredRedraw();
 }
 
 void QgsQuickElevationProfileCanvas::zoomFullInRatio()
@@ -714,6 +785,7 @@ void QgsQuickElevationProfileCanvas::zoomFullInRatio()
   }
 
   refineResults();
+  scheduleDeferredRedraw();
 }
 
 void QgsQuickElevationProfileCanvas::setVisiblePlotRange( double minimumDistance, double maximumDistance, double minimumElevation, double maximumElevation )
@@ -723,6 +795,7 @@ void QgsQuickElevationProfileCanvas::setVisiblePlotRange( double minimumDistance
   mPlotItem->setXMinimum( minimumDistance );
   mPlotItem->setXMaximum( maximumDistance );
   refineResults();
+  scheduleDeferredRedraw();
 }
 
 QgsDoubleRange QgsQuickElevationProfileCanvas::visibleDistanceRange() const
@@ -742,6 +815,7 @@ void QgsQuickElevationProfileCanvas::clear()
   {
     mPlotItem->setRenderer( nullptr );
     disconnect( mCurrentJob, &QgsProfilePlotRenderer::generationFinished, this, &QgsQuickElevationProfileCanvas::generationFinished );
+    mCurrentJob->cancelGenerationWithoutBlocking();
     mCurrentJob->deleteLater();
     mCurrentJob = nullptr;
   }
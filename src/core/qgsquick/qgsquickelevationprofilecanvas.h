@@ -228,6 +228,12 @@ class QgsQuickElevationProfileCanvas : public QQuickItem
   private:
     void setupLayerConnections( QgsMapLayer *layer, bool isDisconnect );
 
+    /**
+     * Re-renders the plot image from the current job's generated results using the
+     * current plot transform, without regenerating the profile.
+     */
+    void redraw();
+
     QgsCoordinateReferenceSystem mCrs;
     QgsProject *mProject = nullptr;
 
@@ -237,6 +243,10 @@ class QgsQuickElevationProfileCanvas : public QQuickItem
 
     QgsElevationProfilePlotItem *mPlotItem = nullptr;
     QgsProfilePlotRenderer *mCurrentJob = nullptr;
+    QgsGeometry mCurrentJobProfileCurve;
+    QgsCoordinateReferenceSystem mCurrentJobCrs;
+    double mCurrentJobTolerance = 0;
+    QList<QgsMapLayer *> mCurrentJobLayers;
 
     QTimer *mDeferredRegenerationTimer = nullptr;
     bool mDeferredRegenerationScheduled = false;
@@ -19,6 +19,8 @@
 #include <qgsmessagelog.h>
 #include <qgsproject.h>
 
+#define REFERENCING_FEATURES_PAGE_SIZE 100
+
 ReferencingFeatureListModel::ReferencingFeatureListModel( QObject *parent )
   : QAbstractItemModel( parent )
 {
@@ -65,17 +67,121 @@ int ReferencingFeatureListModel::columnCount( const QModelIndex &parent ) const
 
 QVariant ReferencingFeatureListModel::data( const QModelIndex &index, int role ) const
 {
+  if ( index.row() < 0 || index.row() >= mEntries.size() )
+    return QVariant();
+
   if ( role == DisplayString )
-    return mEntries.value( index.row() ).displayString;
+    return mEntries.at( index.row() ).displayString;
   if ( role == ReferencingFeature )
-    return mEntries.value( index.row() ).referencingFeature;
+  {
+    QgsVectorLayer *referencingLayer = mRelation.referencingLayer();
+    return referencingLayer ? referencingLayer->getFeature( mEntries.at( index.row() ).referencingFeature.id() ) : QgsFeature();
+  }
   if ( role == NmReferencedFeature )
-    return mEntries.value( index.row() ).nmReferencedFeature;
+  {
+    QgsVectorLayer *nmReferencedLayer = mNmRelation.isValid() ? mNmRelation.referencedLayer() : nullptr;
+    return nmReferencedLayer ? nmReferencedLayer->getFeature( mEntries.at( index.row() ).nmReferencedFeatureId ) : QgsFeature();
+  }
   if ( role == NmDisplayString )
-    return mEntries.value( index.row() ).nmDisplayString;
+    return mEntries.at( index.row() ).nmDisplayString;
   return QVariant();
 }
 
+bool ReferencingFeatureListModel::canFetchMore( const QModelIndex &parent ) const
+{
+  return !parent.isValid() && !mPendingFeatureIds.isEmpty();
+}
+
+void ReferencingFeatureListModel::fetchMore( const QModelIndex &parent )
+{
+  if ( parent.isValid() || mPendingFeatureIds.isEmpty() )
+    return;
+
+  const QList<QgsFeatureId> featureIds = mPendingFeatureIds.mid( 0, REFERENCING_FEATURES_PAGE_SIZE );
+  mPendingFeatureIds = mPendingFeatureIds.mid( featureIds.size() );
+
+  const QList<Entry> entries = collectEntries( mRelation, mNmRelation, featureIds, entryAttributes(), entryNeedsGeometry() );
+  if ( entries.isEmpty() )
+    return;
+
+  beginInsertRows( QModelIndex(), mEntries.size(), mEntries.size() + entries.size() - 1 );
+  mEntries << entries;
+  endInsertRows();
+}
+
+QList<ReferencingFeatureListModel::Entry> ReferencingFeatureListModel::collectEntries( const QgsRelation &relation, const QgsRelation &nmRelation, const QList<QgsFeatureId> &featureIds, const QSet<QString> &attributes, bool needsGeometry )
+{
+  QgsVectorLayer *referencingLayer = relation.referencingLayer();
+  if ( !referencingLayer || featureIds.isEmpty() )
+    return QList<Entry>();
+
+  QgsExpressionContext context = referencingLayer->createExpressionContext();
+  QgsExpression expression( referencingLayer->displayExpression() );
+  expression.prepare( &context );
+
+  QgsVectorLayer *nmReferencedLayer = nmRelation.isValid() ? nmRelation.referencedLayer() : nullptr;
+  QgsExpressionContext nmContext;
+  QgsExpression nmExpression;
+  if ( nmReferencedLayer )
+  {
+    nmContext = nmReferencedLayer->createExpressionContext();
+    nmExpression = QgsExpression( nmReferencedLayer->displayExpression() );
+    nmExpression.prepare( &nmContext );
+  }
+
+  QSet<QString> requestAttributes = attributes;
+  requestAttributes.unite( expression.referencedColumns() );
+  if ( nmReferencedLayer )
+  {
+    const QList<QgsRelation::FieldPair> fieldPairs = nmRelation.fieldPairs();
+    for ( const QgsRelation::FieldPair &fieldPair : fieldPairs )
+      requestAttributes << fieldPair.referencingField();
+  }
+
+  QgsFeatureRequest request( qgis::listToSet( featureIds ) );
+  if ( !needsGeometry && !expression.needsGeometry() )
+    request.setFlags( QgsFeatureRequest::NoGeometry );
+  if ( !requestAttributes.contains( QgsFeatureRequest::ALL_ATTRIBUTES ) )
+    request.setSubsetOfAttributes( requestAttributes, referencingLayer->fields() );
+
+  QHash<QgsFeatureId, Entry> entries;
+  QgsFeatureIterator it = referencingLayer->getFeatures( request );
+  QgsFeature feature;
+  while ( it.nextFeature( feature ) )
+  {
+    context.setFeature( feature );
+
+    QString nmDisplayString;
+    QgsFeatureId nmReferencedFeatureId = FID_NULL;
+    if ( nmReferencedLayer )
+    {
+      const QgsFeature nmFeature = nmRelation.getReferencedFeature( feature );
+      nmContext.setFeature( nmFeature );
+      nmDisplayString = nmExpression.evaluate( &nmContext ).toString();
+      nmReferencedFeatureId = nmFeature.id();
+    }
+
+    // entries only keep the attributes and geometry the model needs
+    QgsFeature referencingFeature = attributes.isEmpty() && !needsGeometry ? QgsFeature( feature.id() ) : feature;
+    if ( !needsGeometry )
+      referencingFeature.clearGeometry();
+
+    entries.insert( feature.id(), Entry( expression.evaluate( &context ).toString(), referencingFeature, nmDisplayString, nmReferencedFeatureId ) );
+  }
+
+  // features requested by id come in no particular order
+  QList<Entry> orderedEntries;
+  orderedEntries.reserve( entries.size() );
+  for ( const QgsFeatureId featureId : featureIds )
+  {
+    auto entry = entries.constFind( featureId );
+    if ( entry != entries.constEnd() )
+      orderedEntries << entry.value();
+  }
+
+  return orderedEntries;
+}
+
 void ReferencingFeatureListModel::setFeature( const QgsFeature &feature )
 {
   mFeature = feature;
@@ -153,9 +259,10 @@ void ReferencingFeatureListModel::updateModel()
   beginResetModel();
 
   if ( mGatherer )
+  {
     mEntries = mGatherer->entries();
-
-  sortEntries();
+    mPendingFeatureIds = mGatherer->pendingFeatureIds();
+  }
 
   endResetModel();
   emit modelUpdated();
@@ -192,7 +299,7 @@ void ReferencingFeatureListModel::reload()
       wasLoading = true;
     }
 
-    mGatherer = new FeatureGatherer( mFeature, mRelation, mNmRelation );
+    mGatherer = new FeatureGatherer( mFeature, mRelation, mNmRelation, orderBy(), entryAttributes(), entryNeedsGeometry(), REFERENCING_FEATURES_PAGE_SIZE );
 
     connect( mGatherer, &FeatureGatherer::collectedValues, this, &ReferencingFeatureListModel::updateModel );
     connect( mGatherer, &FeatureGatherer::finished, this, &ReferencingFeatureListModel::gathererThreadFinished );
@@ -206,6 +313,7 @@ void ReferencingFeatureListModel::reload()
     //clear model entries
     beginResetModel();
     mEntries.clear();
+    mPendingFeatureIds.clear();
     endResetModel();
   }
 
@@ -263,11 +371,25 @@ int ReferencingFeatureListModel::getFeatureIdRow( QgsFeatureId featureId )
   for ( const Entry &entry : mEntries )
   {
     if ( entry.referencingFeature.id() == featureId )
-      break;
+      return row;
     row++;
   }
 
-  return row < mEntries.size() ? row : -1;
+  if ( !mPendingFeatureIds.contains( featureId ) )
+    return -1;
+
+  // load the pages up to the feature
+  while ( canFetchMore( QModelIndex() ) )
+  {
+    fetchMore( QModelIndex() );
+    for ( ; row < mEntries.size(); row++ )
+    {
+      if ( mEntries.at( row ).referencingFeature.id() == featureId )
+        return row;
+    }
+  }
+
+  return -1;
 }
 
 bool ReferencingFeatureListModel::isLoading() const
@@ -296,9 +418,21 @@ bool ReferencingFeatureListModel::beforeDeleteFeature( QgsVectorLayer *referenci
   return true;
 }
 
-void ReferencingFeatureListModel::sortEntries()
+QgsFeatureRequest::OrderBy ReferencingFeatureListModel::orderBy() const
+{
+  QgsVectorLayer *referencingLayer = mRelation.referencingLayer();
+  if ( !referencingLayer )
+    return QgsFeatureRequest::OrderBy();
+
+  return QgsFeatureRequest::OrderBy( { QgsFeatureRequest::OrderByClause( referencingLayer->displayExpression() ) } );
+}
+
+QSet<QString> ReferencingFeatureListModel::entryAttributes() const
+{
+  return QSet<QString>();
+}
+
+bool ReferencingFeatureListModel::entryNeedsGeometry() const
 {
-  std::sort( mEntries.begin(), mEntries.end(), []( const Entry &e1, const Entry &e2 ) {
-    return e1.displayString < e2.displayString;
-  } );
+  return false;
 }
@@ -17,6 +17,7 @@
 #define REFERENCINGFEATURELISTMODEL_H
 
 #include "attributeformmodel.h"
+#include "qgsfeaturerequest.h"
 #include "qgsvectorlayer.h"
 
 #include <QAbstractItemModel>
@@ -61,6 +62,13 @@ class QFIELD_CORE_EXPORT ReferencingFeatureListModel : public QAbstractItemModel
     int columnCount( const QModelIndex &parent = QModelIndex() ) const override;
     QVariant data( const QModelIndex &index, int role = Qt::DisplayRole ) const override;
 
+    /**
+     * Returns TRUE if children sorted after the loaded ones are left to be loaded.
+     * Children are loaded by pages, the first one when the model is reloaded and the next ones through fetchMore().
+     */
+    bool canFetchMore( const QModelIndex &parent ) const override;
+    void fetchMore( const QModelIndex &parent ) override;
+
     //! Returns the id of the relation connecting the parent feature with the children in this model
     QString currentRelationId() const;
 
@@ -143,7 +151,7 @@ class QFIELD_CORE_EXPORT ReferencingFeatureListModel : public QAbstractItemModel
     Q_INVOKABLE bool deleteFeature( QgsFeatureId referencingFeatureId );
 
     /**
-     * Returns the row number for a given feature id
+     * Returns the row number for a given feature id, loading the pages up to it if needed
      * \param featureId the feature id
      */
     Q_INVOKABLE int getFeatureIdRow( QgsFeatureId featureId );
@@ -167,24 +175,37 @@ class QFIELD_CORE_EXPORT ReferencingFeatureListModel : public QAbstractItemModel
     void gathererThreadFinished();
 
   private:
+    /**
+     * A lightweight child entry, full features are fetched on demand through the ReferencingFeature and NmReferencedFeature roles.
+     */
     struct Entry
     {
-        Entry( const QString &displayString, const QgsFeature &referencingFeature, const QString &nmDisplayString = QString(), const QgsFeature &nmReferencedFeature = QgsFeature() )
+        Entry( const QString &displayString, const QgsFeature &referencingFeature, const QString &nmDisplayString = QString(), QgsFeatureId nmReferencedFeatureId = FID_NULL )
           : displayString( displayString )
           , referencingFeature( referencingFeature )
           , nmDisplayString( nmDisplayString )
-          , nmReferencedFeature( nmReferencedFeature )
+          , nmReferencedFeatureId( nmReferencedFeatureId )
         {}
 
         Entry() = default;
 
         QString displayString;
+        //! The referencing feature id, along with the attributes listed by entryAttributes()
         QgsFeature referencingFeature;
         QString nmDisplayString;
-        QgsFeature nmReferencedFeature;
+        QgsFeatureId nmReferencedFeatureId = FID_NULL;
     };
 
+    /**
+     * Collects the entries of the referencing features \a featureIds, in the same order.
+     * The entries keep the referencing feature \a attributes, and its geometry when \a needsGeometry is TRUE.
+     * \note Also called from the gatherer thread
+     */
+    static QList<Entry> collectEntries( const QgsRelation &relation, const QgsRelation &nmRelation, const QList<QgsFeatureId> &featureIds, const QSet<QString> &attributes, bool needsGeometry );
+
     QList<Entry> mEntries;
+    //! Sorted ids of the children left to be loaded
+    QList<QgsFeatureId> mPendingFeatureIds;
     QgsFeature mFeature;
     QgsRelation mRelation;
     QgsRelation mNmRelation;
@@ -195,7 +216,12 @@ class QFIELD_CORE_EXPORT ReferencingFeatureListModel : public QAbstractItemModel
     //! Checks if the parent pk(s) is not null
     bool checkParentPrimaries();
     virtual bool beforeDeleteFeature( QgsVectorLayer *referencingLayer, QgsFeatureId referencingFeatureId );
-    virtual void sortEntries();
+    //! Returns the order of the children, applied by the provider whenever possible
+    virtual QgsFeatureRequest::OrderBy orderBy() const;
+    //! Returns the attributes of the referencing features kept in the entries, none by default
+    virtual QSet<QString> entryAttributes() const;
+    //! Returns whether the geometry of the referencing features is kept in the entries, FALSE by default
+    virtual bool entryNeedsGeometry() const;
 
     friend class FeatureGatherer;
     friend class OrderedRelationModel;
@@ -207,10 +233,14 @@ class FeatureGatherer : public QThread
     Q_OBJECT
 
   public:
-    FeatureGatherer( QgsFeature &feature, QgsRelation relation, QgsRelation nmRelation = QgsRelation() )
+    FeatureGatherer( QgsFeature &feature, QgsRelation relation, QgsRelation nmRelation, const QgsFeatureRequest::OrderBy &orderBy, const QSet<QString> &entryAttributes, bool entryNeedsGeometry, int firstPageSize )
       : mFeature( feature )
       , mRelation( relation )
       , mNmRelation( nmRelation )
+      , mOrderBy( orderBy )
+      , mEntryAttributes( entryAttributes )
+      , mEntryNeedsGeometry( entryNeedsGeometry )
+      , mFirstPageSize( firstPageSize )
     {
     }
 
@@ -218,36 +248,31 @@ class FeatureGatherer : public QThread
     {
       mWasCanceled = false;
 
-      QgsFeatureIterator relatedFeaturesIt = mRelation.getRelatedFeatures( mFeature );
-      QgsExpressionContext context = mRelation.referencingLayer()->createExpressionContext();
-      QgsExpression expression( mRelation.referencingLayer()->displayExpression() );
+      QgsVectorLayer *referencingLayer = mRelation.referencingLayer();
+      if ( !referencingLayer )
+        return;
 
+      // only the sorted ids of the children are gathered, entries are collected for the first page
+      QgsFeatureRequest request = mRelation.getRelatedFeaturesRequest( mFeature );
+      request.setOrderBy( mOrderBy );
+      request.setFlags( QgsFeatureRequest::NoGeometry );
+      request.setSubsetOfAttributes( mOrderBy.usedAttributes(), referencingLayer->fields() );
+
+      QgsFeatureIterator relatedFeaturesIt = referencingLayer->getFeatures( request );
       QgsFeature childFeature;
-      QString displayString;
       while ( relatedFeaturesIt.nextFeature( childFeature ) )
       {
-        context.setFeature( childFeature );
-        displayString = expression.evaluate( &context ).toString();
-
-        QgsFeature nmFeature;
-        QString nmDisplayString;
-        if ( mNmRelation.isValid() )
-        {
-          QgsExpressionContext nmContext = mNmRelation.referencedLayer()->createExpressionContext();
-          QgsExpression nmExpression( mNmRelation.referencedLayer()->displayExpression() );
-
-          nmFeature = mNmRelation.getReferencedFeature( childFeature );
-          nmContext.setFeature( nmFeature );
-          nmDisplayString = nmExpression.evaluate( &nmContext ).toString();
-        }
-
-        //test sleep(1);
-        mEntries.append( ReferencingFeatureListModel::Entry( displayString, childFeature, nmDisplayString, nmFeature ) );
+        mFeatureIds << childFeature.id();
 
         if ( mWasCanceled )
           return;
       }
 
+      mEntries = ReferencingFeatureListModel::collectEntries( mRelation, mNmRelation, mFeatureIds.mid( 0, mFirstPageSize ), mEntryAttributes, mEntryNeedsGeometry );
+
+      if ( mWasCanceled )
+        return;
+
       emit collectedValues();
     }
 
@@ -260,9 +285,12 @@ class FeatureGatherer : public QThread
     //! \returns true if collection was canceled before completion
     bool wasCanceled() const { return mWasCanceled; }
 
-    //! \returns the list of entries
+    //! \returns the list of entries of the first page
     QList<ReferencingFeatureListModel::Entry> entries() const { return mEntries; }
 
+    //! \returns the sorted ids of the children following the first page
+    QList<QgsFeatureId> pendingFeatureIds() const { return mFeatureIds.mid( mFirstPageSize ); }
+
   signals:
 
     /**
@@ -273,12 +301,16 @@ class FeatureGatherer : public QThread
 
   private:
     QList<ReferencingFeatureListModel::Entry> mEntries;
+    QList<QgsFeatureId> mFeatureIds;
 
     QgsFeature mFeature;
     QgsRelation mRelation;
     QgsRelation mNmRelation;
+    QgsFeatureRequest::OrderBy mOrderBy;
+    QSet<QString> mEntryAttributes;
+    bool mEntryNeedsGeometry = false;
+    int mFirstPageSize = 0;
 
-    QgsFeatureRequest mRequest;
     bool mWasCanceled = false;
 };
 
@@ -0,0 +1,223 @@
+/***************************************************************************
+ filechecksumcache.cpp
+
+ ---------------------
+ begin                : October 2026
+ copyright            : (C) 2026 by OPENGIS.ch
+ email                : info at opengis dot ch
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "filechecksumcache.h"
+#include "fileutils.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+#include <qgsmessagelog.h>
+
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+#define FILE_CHECKSUM_CACHE_VERSION 1
+#define FILE_CHECKSUM_CACHE_MAX_THREADS 4
+
+FileChecksumCache::FileChecksumCache( const QString &cacheFilePath )
+  : mCacheFilePath( cacheFilePath )
+{
+  load();
+}
+
+FileChecksumCache::~FileChecksumCache()
+{
+  if ( mDirty )
+    save();
+}
+
+bool FileChecksumCache::fileEntry( const QString &fileName, Entry &entry )
+{
+#ifdef Q_OS_UNIX
+  struct stat fileStat;
+  if ( ::stat( QFile::encodeName( fileName ).constData(), &fileStat ) != 0 || !S_ISREG( fileStat.st_mode ) )
+    return false;
+
+  entry.size = static_cast<qint64>( fileStat.st_size );
+  entry.inode = static_cast<quint64>( fileStat.st_ino );
+  entry.lastModified = QFileInfo( fileName ).lastModified().toMSecsSinceEpoch();
+#else
+  const QFileInfo fileInfo( fileName );
+  if ( !fileInfo.isFile() )
+    return false;
+
+  entry.size = fileInfo.size();
+  entry.inode = 0;
+  entry.lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+#endif
+  return true;
+}
+
+QByteArray FileChecksumCache::checksum( const QString &fileName )
+{
+  return checksums( QStringList() << fileName ).value( fileName );
+}
+
+QHash<QString, QByteArray> FileChecksumCache::checksums( const QStringList &fileNames )
+{
+  QHash<QString, QByteArray> result;
+  QList<QPair<QString, Entry>> staleEntries;
+
+  {
+    QMutexLocker locker( &mMutex );
+    for ( const QString &fileName : fileNames )
+    {
+      const QString absoluteFileName = QFileInfo( fileName ).absoluteFilePath();
+      Entry entry;
+      if ( !fileEntry( absoluteFileName, entry ) )
+        continue;
+
+      auto it = mEntries.constFind( absoluteFileName );
+      if ( it != mEntries.constEnd() && it->size == entry.size && it->lastModified == entry.lastModified && it->inode == entry.inode && !it->checksum.isEmpty() )
+      {
+        result.insert( fileName, it->checksum );
+        continue;
+      }
+
+      staleEntries << qMakePair( absoluteFileName, entry );
+    }
+  }
+
+  if ( staleEntries.isEmpty() )
+    return result;
+
+  // Only the files that changed since they were last hashed are read, spread over a few threads
+  QThreadPool pool;
+  pool.setMaxThreadCount( std::min( FILE_CHECKSUM_CACHE_MAX_THREADS, std::max( 1, QThread::idealThreadCount() ) ) );
+  QtConcurrent::blockingMap( &pool, staleEntries, []( QPair<QString, Entry> &staleEntry ) {
+    staleEntry.second.checksum = FileUtils::fileChecksum( staleEntry.first, QCryptographicHash::Sha256 );
+  } );
+
+  QMutexLocker locker( &mMutex );
+  for ( const QPair<QString, Entry> &staleEntry : std::as_const( staleEntries ) )
+  {
+    if ( staleEntry.second.checksum.isEmpty() )
+      continue;
+
+    mEntries.insert( staleEntry.first, staleEntry.second );
+    mDirty = true;
+  }
+
+  for ( const QString &fileName : fileNames )
+  {
+    if ( result.contains( fileName ) )
+      continue;
+
+    auto it = mEntries.constFind( QFileInfo( fileName ).absoluteFilePath() );
+    if ( it != mEntries.constEnd() )
+      result.insert( fileName, it->checksum );
+  }
+
+  return result;
+}
+
+void FileChecksumCache::insert( const QString &fileName, const QByteArray &checksum )
+{
+  const QString absoluteFileName = QFileInfo( fileName ).absoluteFilePath();
+  Entry entry;
+
+  QMutexLocker locker( &mMutex );
+  if ( checksum.isEmpty() || !fileEntry( absoluteFileName, entry ) )
+  {
+    mDirty |= mEntries.remove( absoluteFileName ) > 0;
+    return;
+  }
+
+  entry.checksum = checksum;
+  mEntries.insert( absoluteFileName, entry );
+  mDirty = true;
+}
+
+void FileChecksumCache::remove( const QString &fileName )
+{
+  QMutexLocker locker( &mMutex );
+  mDirty |= mEntries.remove( QFileInfo( fileName ).absoluteFilePath() ) > 0;
+}
+
+void FileChecksumCache::load()
+{
+  QFile cacheFile( mCacheFilePath );
+  if ( !cacheFile.open( QIODevice::ReadOnly ) )
+    return;
+
+  QDataStream stream( &cacheFile );
+  qint32 version = 0;
+  quint32 count = 0;
+  stream >> version >> count;
+  if ( version != FILE_CHECKSUM_CACHE_VERSION )
+    return;
+
+  mEntries.reserve( static_cast<int>( count ) );
+  for ( quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++ )
+  {
+    QString fileName;
+    Entry entry;
+    stream >> fileName >> entry.size >> entry.lastModified >> entry.inode >> entry.checksum;
+    if ( stream.status() == QDataStream::Ok )
+      mEntries.insert( fileName, entry );
+  }
+
+  if ( stream.status() != QDataStream::Ok )
+  {
+    // a truncated cache is simply rebuilt as files get hashed again
+    mEntries.clear();
+  }
+}
+
+bool FileChecksumCache::save()
+{
+  QMutexLocker locker( &mMutex );
+
+  for ( auto it = mEntries.begin(); it != mEntries.end(); )
+  {
+    if ( !QFileInfo::exists( it.key() ) )
+      it = mEntries.erase( it );
+    else
+      ++it;
+  }
+
+  QDir().mkpath( QFileInfo( mCacheFilePath ).absolutePath() );
+
+  QSaveFile cacheFile( mCacheFilePath );
+  if ( !cacheFile.open( QIODevice::WriteOnly ) )
+  {
+    QgsMessageLog::logMessage( QObject::tr( "Failed to write the file checksum cache, reason:\n%1" ).arg( cacheFile.errorString() ) );
+    return false;
+  }
+
+  QDataStream stream( &cacheFile );
+  stream << static_cast<qint32>( FILE_CHECKSUM_CACHE_VERSION ) << static_cast<quint32>( mEntries.size() );
+  for ( auto it = mEntries.constBegin(); it != mEntries.constEnd(); ++it )
+  {
+    stream << it.key() << it->size << it->lastModified << it->inode << it->checksum;
+  }
+
+  if ( !cacheFile.commit() )
+    return false;
+
+  mDirty = false;
+  return true;
+}
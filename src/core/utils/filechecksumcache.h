@@ -0,0 +1,85 @@
+/***************************************************************************
+ filechecksumcache.h
+
+ ---------------------
+ begin                : October 2026
+ copyright            : (C) 2026 by OPENGIS.ch
+ email                : info at opengis dot ch
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef FILECHECKSUMCACHE_H
+#define FILECHECKSUMCACHE_H
+
+#include "qfield_core_export.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+/**
+ * A persistent cache of SHA-256 file checksums, safe to share across threads.
+ *
+ * Entries are keyed by the absolute file path and are only considered valid as long
+ * as the file size, modification time and inode are unchanged, which allows unchanged
+ * files to be skipped without reading them.
+ */
+class QFIELD_CORE_EXPORT FileChecksumCache
+{
+  public:
+    //! Creates a checksum cache persisted at \a cacheFilePath, existing entries are loaded right away
+    explicit FileChecksumCache( const QString &cacheFilePath );
+
+    //! The cache is saved on destruction if it has been modified
+    ~FileChecksumCache();
+
+    /**
+     * Returns the SHA-256 checksum of \a fileName, reusing the cached value when the file is unchanged.
+     * Returns a null QByteArray if the file cannot be read.
+     */
+    QByteArray checksum( const QString &fileName );
+
+    /**
+     * Returns the SHA-256 checksums of \a fileNames, keyed by file name.
+     * Files missing from the cache or modified since they were cached are hashed in parallel.
+     * Files which cannot be read are omitted.
+     * \note this blocks until all stale files are hashed, call it from a worker thread rather than the main thread
+     */
+    QHash<QString, QByteArray> checksums( const QStringList &fileNames );
+
+    //! Records the known \a checksum of \a fileName, typically after having written the file
+    void insert( const QString &fileName, const QByteArray &checksum );
+
+    //! Removes any cached checksum of \a fileName
+    void remove( const QString &fileName );
+
+    //! Writes the cache to disk, entries for files which no longer exist are dropped
+    bool save();
+
+  private:
+    struct Entry
+    {
+        qint64 size = -1;
+        qint64 lastModified = 0;
+        quint64 inode = 0;
+        QByteArray checksum;
+    };
+
+    static bool fileEntry( const QString &fileName, Entry &entry );
+    void load();
+
+    QString mCacheFilePath;
+    QHash<QString, Entry> mEntries;
+    bool mDirty = false;
+    QMutex mMutex;
+};
+
+#endif // FILECHECKSUMCACHE_H
@@ -0,0 +1,375 @@
+/***************************************************************************
+ filedeltautils.cpp
+
+ ---------------------
+ begin                : October 2026
+ copyright            : (C) 2026 by OPENGIS.ch
+ email                : info at opengis dot ch
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "filedeltautils.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+#include <QObject>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+
+#define FILE_SIGNATURE_MAGIC 0x51465347 // QFSG
+#define FILE_DELTA_MAGIC 0x5146444C     // QFDL
+#define FILE_DELTA_VERSION 1
+#define FILE_DELTA_MIN_BLOCK_SIZE 2048
+#define FILE_DELTA_MAX_BLOCK_SIZE ( 1024 * 1024 )
+#define FILE_DELTA_MAX_CHUNK_SIZE ( 1024 * 1024 )
+#define FILE_DELTA_STRONG_CHECKSUM_SIZE 16
+
+namespace
+{
+  enum DeltaOperation : quint8
+  {
+    DeltaEnd = 0,
+    DeltaCopy = 1,
+    DeltaData = 2,
+  };
+
+  struct Signature
+  {
+      int blockSize = 0;
+      qint64 fileSize = 0;
+      QVector<quint32> weakChecksums;
+      QVector<QByteArray> strongChecksums;
+  };
+
+  bool readSignature( const QByteArray &data, Signature &signature )
+  {
+    QDataStream stream( data );
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint32 blockSize = 0;
+    quint32 blockCount = 0;
+    stream >> magic >> version >> blockSize >> signature.fileSize >> blockCount;
+    if ( stream.status() != QDataStream::Ok || magic != FILE_SIGNATURE_MAGIC || version != FILE_DELTA_VERSION || blockSize == 0 || blockSize > FILE_DELTA_MAX_BLOCK_SIZE )
+      return false;
+
+    signature.blockSize = static_cast<int>( blockSize );
+    signature.weakChecksums.reserve( static_cast<int>( blockCount ) );
+    signature.strongChecksums.reserve( static_cast<int>( blockCount ) );
+    for ( quint32 i = 0; i < blockCount; i++ )
+    {
+      quint32 weak = 0;
+      QByteArray strong( FILE_DELTA_STRONG_CHECKSUM_SIZE, Qt::Uninitialized );
+      stream >> weak;
+      if ( stream.readRawData( strong.data(), FILE_DELTA_STRONG_CHECKSUM_SIZE ) != FILE_DELTA_STRONG_CHECKSUM_SIZE )
+        return false;
+
+      signature.weakChecksums << weak;
+      signature.strongChecksums << strong;
+    }
+    return stream.status() == QDataStream::Ok;
+  }
+
+  //! Accumulates consecutive block references and literal data before writing them as delta operations
+  class DeltaWriter
+  {
+    public:
+      explicit DeltaWriter( QDataStream &stream )
+        : mStream( stream )
+      {}
+
+      void copy( quint32 block )
+      {
+        if ( mCopyCount > 0 && mCopyFirstBlock + mCopyCount == block )
+        {
+          mCopyCount++;
+          return;
+        }
+
+        flushCopy();
+        mCopyFirstBlock = block;
+        mCopyCount = 1;
+      }
+
+      void data( const uchar *data, qint64 length )
+      {
+        flushCopy();
+        while ( length > 0 )
+        {
+          const int chunkLength = static_cast<int>( std::min<qint64>( length, FILE_DELTA_MAX_CHUNK_SIZE ) );
+          mStream << static_cast<quint8>( DeltaData ) << static_cast<quint32>( chunkLength );
+          mStream.writeRawData( reinterpret_cast<const char *>( data ), chunkLength );
+          data += chunkLength;
+          length -= chunkLength;
+        }
+      }
+
+      void finish()
+      {
+        flushCopy();
+        mStream << static_cast<quint8>( DeltaEnd );
+      }
+
+    private:
+      void flushCopy()
+      {
+        if ( mCopyCount == 0 )
+          return;
+
+        mStream << static_cast<quint8>( DeltaCopy ) << mCopyFirstBlock << mCopyCount;
+        mCopyCount = 0;
+      }
+
+      QDataStream &mStream;
+      quint32 mCopyFirstBlock = 0;
+      quint32 mCopyCount = 0;
+  };
+} // namespace
+
+int FileDeltaUtils::blockSizeForFileSize( qint64 fileSize )
+{
+  // like rsync, grow the block size with the square root of the file size to keep signatures small
+  const qint64 blockSize = static_cast<qint64>( std::sqrt( static_cast<double>( std::max<qint64>( fileSize, 0 ) ) ) ) & ~static_cast<qint64>( 7 );
+  return static_cast<int>( std::clamp<qint64>( blockSize, FILE_DELTA_MIN_BLOCK_SIZE, FILE_DELTA_MAX_BLOCK_SIZE ) );
+}
+
+quint32 FileDeltaUtils::weakChecksum( const uchar *data, int length )
+{
+  quint32 a = 0;
+  quint32 b = 0;
+  for ( int i = 0; i < length; i++ )
+  {
+    a += data[i];
+    b += static_cast<quint32>( length - i ) * data[i];
+  }
+  return ( a & 0xffff ) | ( ( b & 0xffff ) << 16 );
+}
+
+QByteArray FileDeltaUtils::signature( const QString &fileName, int blockSize )
+{
+  QFile file( fileName );
+  if ( !file.open( QIODevice::ReadOnly ) )
+    return QByteArray();
+
+  const qint64 fileSize = file.size();
+  if ( blockSize <= 0 )
+    blockSize = blockSizeForFileSize( fileSize );
+  blockSize = std::min( blockSize, FILE_DELTA_MAX_BLOCK_SIZE );
+
+  const quint32 blockCount = static_cast<quint32>( ( fileSize + blockSize - 1 ) / blockSize );
+
+  QByteArray result;
+  result.reserve( 22 + static_cast<int>( blockCount ) * ( 4 + FILE_DELTA_STRONG_CHECKSUM_SIZE ) );
+  QDataStream stream( &result, QIODevice::WriteOnly );
+  stream << static_cast<quint32>( FILE_SIGNATURE_MAGIC ) << static_cast<quint16>( FILE_DELTA_VERSION ) << static_cast<quint32>( blockSize ) << fileSize << blockCount;
+
+  QByteArray block( blockSize, Qt::Uninitialized );
+  for ( quint32 i = 0; i < blockCount; i++ )
+  {
+    const qint64 length = file.read( block.data(), blockSize );
+    if ( length <= 0 )
+      return QByteArray();
+
+    const QByteArray strong = QCryptographicHash::hash( QByteArray::fromRawData( block.constData(), static_cast<int>( length ) ), QCryptographicHash::Md5 );
+    stream << weakChecksum( reinterpret_cast<const uchar *>( block.constData() ), static_cast<int>( length ) );
+    stream.writeRawData( strong.constData(), FILE_DELTA_STRONG_CHECKSUM_SIZE );
+  }
+
+  return result;
+}
+
+bool FileDeltaUtils::createDelta( const QByteArray &signatureData, const QString &fileName, QIODevice *output, QString *errorString )
+{
+  Signature signature;
+  if ( !readSignature( signatureData, signature ) )
+  {
+    if ( errorString )
+      *errorString = QObject::tr( "Invalid file signature" );
+    return false;
+  }
+
+  QFile file( fileName );
+  if ( !file.open( QIODevice::ReadOnly ) )
+  {
+    if ( errorString )
+      *errorString = file.errorString();
+    return false;
+  }
+
+  const qint64 size = file.size();
+  QByteArray content;
+  const uchar *data = size > 0 ? file.map( 0, size ) : nullptr;
+  if ( !data && size > 0 )
+  {
+    content = file.readAll();
+    data = reinterpret_cast<const uchar *>( content.constData() );
+  }
+
+  // only full blocks are looked up, a shorter trailing block ends up as literal data
+  const int blockSize = signature.blockSize;
+  const int fullBlockCount = static_cast<int>( signature.fileSize / blockSize );
+  QHash<quint32, QVector<int>> blocksByWeakChecksum;
+  for ( int i = 0; i < fullBlockCount; i++ )
+    blocksByWeakChecksum[signature.weakChecksums.at( i )] << i;
+
+  QDataStream stream( output );
+  stream << static_cast<quint32>( FILE_DELTA_MAGIC ) << static_cast<quint16>( FILE_DELTA_VERSION ) << static_cast<quint32>( blockSize );
+  DeltaWriter writer( stream );
+
+  qint64 position = 0;
+  qint64 literalStart = 0;
+  quint32 a = 0;
+  quint32 b = 0;
+  if ( size >= blockSize )
+  {
+    const quint32 weak = weakChecksum( data, blockSize );
+    a = weak & 0xffff;
+    b = weak >> 16;
+  }
+
+  while ( position + blockSize <= size )
+  {
+    int matchingBlock = -1;
+    auto it = blocksByWeakChecksum.constFind( ( a & 0xffff ) | ( ( b & 0xffff ) << 16 ) );
+    if ( it != blocksByWeakChecksum.constEnd() )
+    {
+      const QByteArray strong = QCryptographicHash::hash( QByteArray::fromRawData( reinterpret_cast<const char *>( data + position ), blockSize ), QCryptographicHash::Md5 );
+      for ( int block : it.value() )
+      {
+        if ( signature.strongChecksums.at( block ) == strong )
+        {
+          matchingBlock = block;
+          break;
+        }
+      }
+    }
+
+    if ( matchingBlock >= 0 )
+    {
+      writer.data( data + literalStart, position - literalStart );
+      writer.copy( static_cast<quint32>( matchingBlock ) );
+      position += blockSize;
+      literalStart = position;
+
+      if ( position + blockSize <= size )
+      {
+        const quint32 weak = weakChecksum( data + position, blockSize );
+        a = weak & 0xffff;
+        b = weak >> 16;
+      }
+      continue;
+    }
+
+    // roll the checksum window by one byte
+    if ( position + blockSize < size )
+    {
+      const quint32 removed = data[position];
+      const quint32 added = data[position + blockSize];
+      a = ( a - removed + added ) & 0xffff;
+      b = ( b - static_cast<quint32>( blockSize ) * removed + a ) & 0xffff;
+    }
+    position++;
+  }
+
+  writer.data( data + literalStart, size - literalStart );
+  writer.finish();
+
+  if ( stream.status() != QDataStream::Ok )
+  {
+    if ( errorString )
+      *errorString = output->errorString();
+    return false;
+  }
+
+  return true;
+}
+
+bool FileDeltaUtils::applyDelta( const QString &baseFileName, QIODevice *delta, QIODevice *output, QCryptographicHash *hash, QString *errorString )
+{
+  auto fail = [errorString]( const QString &message ) {
+    if ( errorString )
+      *errorString = message;
+    return false;
+  };
+
+  QFile baseFile( baseFileName );
+  if ( !baseFile.open( QIODevice::ReadOnly ) )
+    return fail( baseFile.errorString() );
+
+  QDataStream stream( delta );
+  quint32 magic = 0;
+  quint16 version = 0;
+  quint32 blockSize = 0;
+  stream >> magic >> version >> blockSize;
+  if ( stream.status() != QDataStream::Ok || magic != FILE_DELTA_MAGIC || version != FILE_DELTA_VERSION || blockSize == 0 || blockSize > FILE_DELTA_MAX_BLOCK_SIZE )
+    return fail( QObject::tr( "Invalid file delta" ) );
+
+  auto write = [output, hash]( const char *data, qint64 length ) {
+    if ( output->write( data, length ) != length )
+      return false;
+    if ( hash )
+      hash->addData( QByteArray::fromRawData( data, static_cast<int>( length ) ) );
+    return true;
+  };
+
+  QByteArray buffer;
+  while ( true )
+  {
+    quint8 operation = DeltaEnd;
+    stream >> operation;
+    if ( stream.status() != QDataStream::Ok )
+      return fail( QObject::tr( "Truncated file delta" ) );
+
+    if ( operation == DeltaEnd )
+      return true;
+
+    if ( operation == DeltaCopy )
+    {
+      quint32 firstBlock = 0;
+      quint32 blockCount = 0;
+      stream >> firstBlock >> blockCount;
+      if ( stream.status() != QDataStream::Ok )
+        return fail( QObject::tr( "Truncated file delta" ) );
+
+      qint64 remaining = static_cast<qint64>( blockCount ) * blockSize;
+      if ( !baseFile.seek( static_cast<qint64>( firstBlock ) * blockSize ) || baseFile.pos() + remaining > baseFile.size() )
+        return fail( QObject::tr( "File delta references blocks missing from the local file" ) );
+
+      while ( remaining > 0 )
+      {
+        buffer.resize( static_cast<int>( std::min<qint64>( remaining, FILE_DELTA_MAX_CHUNK_SIZE ) ) );
+        const qint64 length = baseFile.read( buffer.data(), buffer.size() );
+        if ( length != buffer.size() )
+          return fail( baseFile.errorString() );
+        if ( !write( buffer.constData(), length ) )
+          return fail( output->errorString() );
+        remaining -= length;
+      }
+    }
+    else if ( operation == DeltaData )
+    {
+      quint32 length = 0;
+      stream >> length;
+      if ( stream.status() != QDataStream::Ok || length > FILE_DELTA_MAX_CHUNK_SIZE )
+        return fail( QObject::tr( "Invalid file delta" ) );
+
+      buffer.resize( static_cast<int>( length ) );
+      if ( stream.readRawData( buffer.data(), buffer.size() ) != buffer.size() )
+        return fail( QObject::tr( "Truncated file delta" ) );
+      if ( !write( buffer.constData(), length ) )
+        return fail( output->errorString() );
+    }
+    else
+    {
+      return fail( QObject::tr( "Invalid file delta" ) );
+    }
+  }
+}
@@ -0,0 +1,67 @@
+/***************************************************************************
+ filedeltautils.h
+
+ ---------------------
+ begin                : October 2026
+ copyright            : (C) 2026 by OPENGIS.ch
+ email                : info at opengis dot ch
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef FILEDELTAUTILS_H
+#define FILEDELTAUTILS_H
+
+#include "qfield_core_export.h"
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QString>
+
+class QIODevice;
+
+/**
+ * Block-level differential transfer of files, following the rsync algorithm.
+ *
+ * The receiver computes a signature of its local copy made of a rolling (weak) and
+ * an MD5 (strong) checksum per block. The sender looks up every block of the new file
+ * version in that signature and produces a delta made of references to matching local
+ * blocks and literal data for everything else. The receiver finally rebuilds the new
+ * file version out of its local copy and the delta.
+ */
+class QFIELD_CORE_EXPORT FileDeltaUtils
+{
+  public:
+    //! Returns a block size suited to a file of \a fileSize bytes
+    static int blockSizeForFileSize( qint64 fileSize );
+
+    //! Returns the rolling checksum of \a length bytes of \a data
+    static quint32 weakChecksum( const uchar *data, int length );
+
+    /**
+     * Returns the serialized signature of \a fileName split in blocks of \a blockSize bytes.
+     * When \a blockSize is 0, a block size is picked using blockSizeForFileSize().
+     * Returns an empty QByteArray if the file cannot be read.
+     */
+    static QByteArray signature( const QString &fileName, int blockSize = 0 );
+
+    /**
+     * Writes into \a output the delta turning the file described by \a signature into \a fileName.
+     * \returns TRUE on success, otherwise FALSE and \a errorString is set.
+     */
+    static bool createDelta( const QByteArray &signature, const QString &fileName, QIODevice *output, QString *errorString = nullptr );
+
+    /**
+     * Rebuilds a file version into \a output out of the \a delta against the local \a baseFileName.
+     * The written content is fed to \a hash when provided.
+     * \returns TRUE on success, otherwise FALSE and \a errorString is set.
+     */
+    static bool applyDelta( const QString &baseFileName, QIODevice *delta, QIODevice *output, QCryptographicHash *hash = nullptr, QString *errorString = nullptr );
+};
+
+#endif // FILEDELTAUTILS_H
@@ -24,6 +24,10 @@
 #include <qgis.h>
 #include <qgsfileutils.h>
 
+#include <algorithm>
+
+#define FILE_CHECKSUM_MAP_WINDOW_SIZE ( 64 * 1024 * 1024 )
+
 FileUtils::FileUtils( QObject *parent )
   : QObject( parent )
 {
@@ -154,6 +158,28 @@ QByteArray FileUtils::fileChecksum( const QString &fileName, const QCryptographi
 
   QCryptographicHash hash( hashAlgorithm );
 
+  // Hash memory-mapped windows of the file to avoid copying its content through read buffers,
+  // fall back to regular reads where mapping is not supported
+  const qint64 size = f.size();
+  qint64 offset = 0;
+  while ( offset < size )
+  {
+    const qint64 length = std::min<qint64>( FILE_CHECKSUM_MAP_WINDOW_SIZE, size - offset );
+    uchar *data = f.map( offset, length );
+    if ( !data )
+      break;
+
+    hash.addData( reinterpret_cast<const char *>( data ), static_cast<int>( length ) );
+    f.unmap( data );
+    offset += length;
+  }
+
+  if ( offset >= size )
+    return hash.result();
+
+  if ( !f.seek( offset ) )
+    return QByteArray();
+
   if ( hash.addData( &f ) )
     return hash.result();
 
@@ -225,6 +225,11 @@ QString LayerUtils::fieldType( const QgsField &field )
 }
 
 bool LayerUtils::deleteFeature( QgsProject *project, QgsVectorLayer *layer, const QgsFeatureId fid, bool shouldWriteChanges )
+{
+  return deleteFeatures( project, layer, QgsFeatureIds() << fid, shouldWriteChanges );
+}
+
+bool LayerUtils::deleteFeatures( QgsProject *project, QgsVectorLayer *layer, const QgsFeatureIds &fids, bool shouldWriteChanges )
 {
   if ( !project )
     return false;
@@ -253,17 +258,20 @@ bool LayerUtils::deleteFeature( QgsProject *project, QgsVectorLayer *layer, cons
 
   bool isSuccess = true;
 
-  // delete parent and related features
+  // delete parent and related features, all at once within a single edit command
   QgsVectorLayer::DeleteContext deleteContext( true, project );
-  if ( layer->deleteFeature( fid, &deleteContext ) )
+  layer->beginEditCommand( tr( "Delete features" ) );
+  if ( layer->deleteFeatures( fids, &deleteContext ) )
   {
+    layer->endEditCommand();
+
     if ( !shouldWriteChanges )
     {
       // commit changes
       if ( !layer->commitChanges() )
       {
         const QString msgs = layer->commitErrors().join( QStringLiteral( "\n" ) );
-        QgsMessageLog::logMessage( tr( "Cannot commit deletion of feature %2 in layer \"%1\". Reason:\n%3" ).arg( layer->name() ).arg( fid ).arg( msgs ), QStringLiteral( "QField" ), Qgis::Warning );
+        QgsMessageLog::logMessage( tr( "Cannot commit deletion of features in layer \"%1\". Reason:\n%2" ).arg( layer->name(), msgs ), QStringLiteral( "QField" ), Qgis::Warning );
         isSuccess = false;
       }
     }
@@ -283,7 +291,7 @@ bool LayerUtils::deleteFeature( QgsProject *project, QgsVectorLayer *layer, cons
         if ( !vl->commitChanges() )
         {
           const QString msgs = vl->commitErrors().join( QStringLiteral( "\n" ) );
-          QgsMessageLog::logMessage( tr( "Cannot commit deletion in layer \"%1\". Reason:\n%3" ).arg( vl->name() ).arg( msgs ), QStringLiteral( "QField" ), Qgis::Warning );
+          QgsMessageLog::logMessage( tr( "Cannot commit deletion in layer \"%1\". Reason:\n%2" ).arg( vl->name(), msgs ), QStringLiteral( "QField" ), Qgis::Warning );
           isSuccess = false;
           break;
         }
@@ -292,7 +300,8 @@ bool LayerUtils::deleteFeature( QgsProject *project, QgsVectorLayer *layer, cons
   }
   else
   {
-    QgsMessageLog::logMessage( tr( "Cannot delete feature %1" ).arg( fid ), "QField", Qgis::Warning );
+    layer->destroyEditCommand();
+    QgsMessageLog::logMessage( tr( "Cannot delete features in layer \"%1\"" ).arg( layer->name() ), "QField", Qgis::Warning );
 
     isSuccess = false;
   }
@@ -315,6 +324,65 @@ bool LayerUtils::deleteFeature( QgsProject *project, QgsVectorLayer *layer, cons
   return isSuccess;
 }
 
+QgsFeatureList LayerUtils::duplicateFeatures( QgsVectorLayer *layer, const QgsFeatureList &features )
+{
+  if ( !layer )
+  {
+    QgsMessageLog::logMessage( tr( "Cannot start editing, no layer" ), "QField", Qgis::Warning );
+    return QgsFeatureList();
+  }
+
+  QgsVectorLayerUtils::QgsFeaturesDataList featuresData;
+  for ( const QgsFeature &feature : features )
+  {
+    if ( !feature.isValid() )
+    {
+      QgsMessageLog::logMessage( tr( "Cannot copy invalid feature" ), "QField", Qgis::Warning );
+      return QgsFeatureList();
+    }
+
+    featuresData << QgsVectorLayerUtils::QgsFeatureData( feature.geometry(), feature.attributes().toMap() );
+  }
+
+  if ( !layer->startEditing() || !layer->editBuffer() )
+  {
+    QgsMessageLog::logMessage( tr( "Cannot start editing" ), "QField", Qgis::Warning );
+    return QgsFeatureList();
+  }
+
+  // the committed features carry the ids and values saved into the layer dataset
+  QgsFeatureList duplicatedFeatures;
+  QMetaObject::Connection connection = connect( layer, &QgsVectorLayer::committedFeaturesAdded, [&duplicatedFeatures]( const QString &, const QgsFeatureList &addedFeatures ) {
+    duplicatedFeatures << addedFeatures;
+  } );
+  auto sweaper = qScopeGuard( [layer, connection] { layer->disconnect( connection ); } );
+
+  QgsFeatureList newFeatures = QgsVectorLayerUtils::createFeatures( layer, featuresData );
+  layer->beginEditCommand( tr( "Duplicate features" ) );
+  if ( layer->addFeatures( newFeatures ) )
+  {
+    layer->endEditCommand();
+
+    // commit changes
+    if ( !layer->commitChanges() )
+    {
+      const QString msgs = layer->commitErrors().join( QStringLiteral( "\n" ) );
+      QgsMessageLog::logMessage( tr( "Cannot add new features in layer \"%1\". Reason:\n%2" ).arg( layer->name(), msgs ), "QField", Qgis::Warning );
+      if ( !layer->rollBack() )
+        QgsMessageLog::logMessage( tr( "Cannot rollback layer changes in layer %1" ).arg( layer->name() ), "QField", Qgis::Critical );
+      return QgsFeatureList();
+    }
+  }
+  else
+  {
+    layer->destroyEditCommand();
+    QgsMessageLog::logMessage( tr( "Cannot add new features in layer \"%1\"." ).arg( layer->name() ), "QField", Qgis::Warning );
+    return QgsFeatureList();
+  }
+
+  return duplicatedFeatures;
+}
+
 QgsFeature LayerUtils::duplicateFeature( QgsVectorLayer *layer, const QgsFeature &feature )
 {
   if ( !layer )
@@ -349,6 +417,8 @@ QgsFeature LayerUtils::duplicateFeature( QgsVectorLayer *layer, const QgsFeature
     {
       const QString msgs = layer->commitErrors().join( QStringLiteral( "\n" ) );
       QgsMessageLog::logMessage( tr( "Cannot add new feature in layer \"%1\". Reason:\n%2" ).arg( layer->name(), msgs ), "QField", Qgis::Warning );
+      if ( !layer->rollBack() )
+        QgsMessageLog::logMessage( tr( "Cannot rollback layer changes in layer %1" ).arg( layer->name() ), "QField", Qgis::Critical );
       return QgsFeature();
     }
   }
@@ -72,6 +72,20 @@ class LayerUtils : public QObject
      */
     static QgsFeature duplicateFeature( QgsVectorLayer *layer, const QgsFeature &feature );
 
+    /**
+     * Deletes features \a fids and their related features from the vector \a layer within a single edit command.
+     * When \a shouldWriteChanges is FALSE, editing is started and changes are committed once for all features,
+     * otherwise the caller is in charge of the \a layer edit session.
+     */
+    static bool deleteFeatures( QgsProject *project, QgsVectorLayer *layer, const QgsFeatureIds &fids, bool shouldWriteChanges = true );
+
+    /**
+     * Duplicates given \a features within the provided vector \a layer using a single edit command and commit.
+     * If successful, the function will return the duplicated features as saved into the layer dataset,
+     * an empty list is returned otherwise.
+     */
+    static QgsFeatureList duplicateFeatures( QgsVectorLayer *layer, const QgsFeatureList &features );
+
     /**
      * Returns the QVariant typeName of a \a field.
      * This is a stable identifier (compared to the provider field name).
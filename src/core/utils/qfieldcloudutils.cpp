@@ -20,11 +20,15 @@
 #include <QDir>
 #include <QFile>
 #include <QLockFile>
+#include <QSaveFile>
 #include <QStandardPaths>
 #include <QString>
+#include <QTextStream>
 #include <qgsapplication.h>
 #include <qgsmessagelog.h>
 
+#define PENDING_ATTACHMENTS_JOURNAL_COMPACTION_THRESHOLD 200
+
 static QString sLocalCloudDirectory;
 
 void QFieldCloudUtils::setLocalCloudDirectory( const QString &path )
@@ -52,6 +56,11 @@ const QString QFieldCloudUtils::localProjectFilePath( const QString &username, c
   return QString();
 }
 
+const QString QFieldCloudUtils::localProjectDownloadDirectory( const QString &username, const QString &projectId )
+{
+  return QStringLiteral( "%1/%2/.downloads/%3" ).arg( QFieldCloudUtils::localCloudDirectory(), username, projectId );
+}
+
 bool QFieldCloudUtils::isCloudAction( const QgsMapLayer *layer )
 {
   Q_ASSERT( layer );
@@ -90,50 +99,120 @@ const QVariant QFieldCloudUtils::projectSetting( const QString &projectId, const
   return settings.value( QStringLiteral( "%1/%2" ).arg( projectPrefix, setting ), defaultValue );
 }
 
-const QMultiMap<QString, QString> QFieldCloudUtils::getPendingAttachments()
+static QString pendingAttachmentsJournalPath()
 {
-  QMultiMap<QString, QString> files;
+  return QStringLiteral( "%1/attachments.journal" ).arg( QFieldCloudUtils::localCloudDirectory() );
+}
 
-  QLockFile attachmentsLock( QStringLiteral( "%1/attachments.lock" ).arg( QFieldCloudUtils::localCloudDirectory() ) );
-  if ( attachmentsLock.tryLock( 10000 ) )
+static bool appendPendingAttachmentsJournalEntry( const QString &operation, const QString &projectId, const QString &fileName )
+{
+  QFile journalFile( pendingAttachmentsJournalPath() );
+  if ( !journalFile.open( QFile::Append | QFile::Text ) )
   {
-    QFile attachmentsFile( QStringLiteral( "%1/attachments.csv" ).arg( QFieldCloudUtils::localCloudDirectory() ) );
-    QFileInfo fi( attachmentsFile );
-    if ( !fi.exists() || fi.size() == 0 )
-      return std::move( files );
+    QgsMessageLog::logMessage( QObject::tr( "Failed to write to the pending attachments journal, reason:\n%1" ).arg( journalFile.errorString() ) );
+    return false;
+  }
 
-    attachmentsFile.open( QFile::ReadWrite | QFile::Text );
+  QTextStream journalStream( &journalFile );
+  journalStream << StringUtils::stringListToCsv( QStringList() << operation << projectId << fileName )
+                << Qt::endl;
+  journalFile.close();
+  return true;
+}
+
+static void migrateLegacyPendingAttachments()
+{
+  // Pending attachments used to be stored in a CSV file which was fully rewritten on every removal,
+  // move any leftover entries into the journal
+  QFile attachmentsFile( QStringLiteral( "%1/attachments.csv" ).arg( QFieldCloudUtils::localCloudDirectory() ) );
+  if ( !attachmentsFile.exists() )
+    return;
+
+  if ( attachmentsFile.open( QFile::ReadOnly | QFile::Text ) )
+  {
     QTextStream attachmentsStream( &attachmentsFile );
     while ( !attachmentsStream.atEnd() )
     {
-      const QString line = attachmentsStream.readLine().trimmed();
-      const QStringList values = StringUtils::csvToStringList( line );
+      const QStringList values = StringUtils::csvToStringList( attachmentsStream.readLine().trimmed() );
 
       // The expected CSV format must have two columns:
       // project_id,file_path
       if ( values.size() >= 2 )
       {
-        files.insert( values.at( 0 ), values.at( 1 ) );
+        appendPendingAttachmentsJournalEntry( QStringLiteral( "+" ), values.at( 0 ), values.at( 1 ) );
       }
     }
+    attachmentsFile.close();
   }
-  return std::move( files );
+  attachmentsFile.remove();
 }
 
-void QFieldCloudUtils::addPendingAttachment( const QString &projectId, const QString &fileName )
+const QMultiMap<QString, QString> QFieldCloudUtils::getPendingAttachments()
 {
+  QMultiMap<QString, QString> files;
+
   QLockFile attachmentsLock( QStringLiteral( "%1/attachments.lock" ).arg( QFieldCloudUtils::localCloudDirectory() ) );
   if ( attachmentsLock.tryLock( 10000 ) )
   {
-    QStringList values = QStringList() << projectId << fileName;
+    migrateLegacyPendingAttachments();
 
-    QFile attachmentsFile( QStringLiteral( "%1/attachments.csv" ).arg( QFieldCloudUtils::localCloudDirectory() ) );
-    attachmentsFile.open( QFile::Append | QFile::Text );
-    QTextStream attachmentsStream( &attachmentsFile );
-    QFileInfo fi( attachmentsFile );
-    attachmentsStream << StringUtils::stringListToCsv( values )
-                      << Qt::endl;
-    attachmentsFile.close();
+    QFile journalFile( pendingAttachmentsJournalPath() );
+    if ( !journalFile.exists() || journalFile.size() == 0 )
+      return files;
+
+    if ( !journalFile.open( QFile::ReadOnly | QFile::Text ) )
+      return files;
+
+    // Replay the journal, each line is either an addition or a removal:
+    // +,project_id,file_path
+    // -,project_id,file_path
+    int entryCount = 0;
+    QTextStream journalStream( &journalFile );
+    while ( !journalStream.atEnd() )
+    {
+      const QStringList values = StringUtils::csvToStringList( journalStream.readLine().trimmed() );
+      if ( values.size() < 3 )
+        continue;
+
+      entryCount++;
+      if ( values.at( 0 ) == QLatin1String( "+" ) )
+      {
+        if ( !files.contains( values.at( 1 ), values.at( 2 ) ) )
+          files.insert( values.at( 1 ), values.at( 2 ) );
+      }
+      else if ( values.at( 0 ) == QLatin1String( "-" ) )
+      {
+        files.remove( values.at( 1 ), values.at( 2 ) );
+      }
+    }
+    journalFile.close();
+
+    // Compact the journal once removals dominate, so replaying stays cheap
+    if ( entryCount > PENDING_ATTACHMENTS_JOURNAL_COMPACTION_THRESHOLD && entryCount > files.size() * 2 )
+    {
+      QSaveFile compactedFile( pendingAttachmentsJournalPath() );
+      if ( compactedFile.open( QFile::WriteOnly | QFile::Text ) )
+      {
+        QTextStream compactedStream( &compactedFile );
+        for ( auto it = files.constBegin(); it != files.constEnd(); ++it )
+        {
+          compactedStream << StringUtils::stringListToCsv( QStringList() << QStringLiteral( "+" ) << it.key() << it.value() )
+                          << Qt::endl;
+        }
+        compactedStream.flush();
+        compactedFile.commit();
+      }
+    }
+  }
+  return files;
+}
+
+void QFieldCloudUtils::addPendingAttachment( const QString &projectId, const QString &fileName )
+{
+  QLockFile attachmentsLock( QStringLiteral( "%1/attachments.lock" ).arg( QFieldCloudUtils::localCloudDirectory() ) );
+  if ( attachmentsLock.tryLock( 10000 ) )
+  {
+    appendPendingAttachmentsJournalEntry( QStringLiteral( "+" ), projectId, fileName );
   }
 }
 
@@ -142,22 +221,6 @@ void QFieldCloudUtils::removePendingAttachment( const QString &projectId, const
   QLockFile attachmentsLock( QStringLiteral( "%1/attachments.lock" ).arg( QFieldCloudUtils::localCloudDirectory() ) );
   if ( attachmentsLock.tryLock( 10000 ) )
   {
-    const QString lineToRemove = StringUtils::stringListToCsv( QStringList() << projectId << fileName );
-    QString output;
-    QFile attachmentsFile( QStringLiteral( "%1/attachments.csv" ).arg( QFieldCloudUtils::localCloudDirectory() ) );
-    attachmentsFile.open( QFile::ReadWrite | QFile::Text );
-    QTextStream attachmentsStream( &attachmentsFile );
-    while ( !attachmentsStream.atEnd() )
-    {
-      const QString line = attachmentsStream.readLine();
-      if ( !line.isEmpty() && !line.startsWith( lineToRemove ) )
-      {
-        output += line + QChar( '\n' );
-      }
-    }
-    attachmentsFile.resize( 0 );
-    attachmentsStream.reset();
-    attachmentsStream << output;
-    attachmentsFile.close();
+    appendPendingAttachmentsJournalEntry( QStringLiteral( "-" ), projectId, fileName );
   }
 }
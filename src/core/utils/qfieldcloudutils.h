@@ -44,6 +44,12 @@ class QFieldCloudUtils : public QObject
 
     static const QString localProjectFilePath( const QString &username, const QString &projectId );
 
+    /**
+     * Returns the path to the directory where files of a project are downloaded to before being installed.
+     * The directory resides within the local cloud directory, i.e. on the same file system as the project.
+     */
+    static const QString localProjectDownloadDirectory( const QString &username, const QString &projectId );
+
     /**
      * Returns if the \layer action has do be handled with QFieldCloud.
      *
@@ -66,13 +72,16 @@ class QFieldCloudUtils : public QObject
     //! Gets a \a setting value for project with given \a projectId from the permanent storage. Return \a defaultValue if not present.
     static const QVariant projectSetting( const QString &projectId, const QString &setting, const QVariant &defaultValue = QVariant() );
 
-    //! Returns the list of attachments that have not yet been uploaded to the cloud.
+    /**
+     * Returns the list of attachments that have not yet been uploaded to the cloud.
+     * The pending attachments journal is replayed and compacted when needed.
+     */
     static const QMultiMap<QString, QString> getPendingAttachments();
 
-    //! Adds an \a fileName for a given \a projectId to the pending attachments list
+    //! Adds an \a fileName for a given \a projectId to the pending attachments journal
     static void addPendingAttachment( const QString &projectId, const QString &fileName );
 
-    //! Adds removes a \a fileName for a given \a projectId to the pending attachments list
+    //! Removes a \a fileName for a given \a projectId from the pending attachments journal
     static void removePendingAttachment( const QString &projectId, const QString &fileName );
 };
 
@@ -24,6 +24,8 @@
 #endif
 #include <qgsstringutils.h>
 
+#include <algorithm>
+
 StringUtils::StringUtils( QObject *parent )
   : QObject( parent )
 {
@@ -70,6 +72,26 @@ bool StringUtils::fuzzyMatch( const QString &source, const QString &term )
            : false;
 }
 
+double StringUtils::fuzzyMatchScore( const QString &source, const QString &term )
+{
+  const QString trimmedTerm = term.trimmed();
+  if ( source.isEmpty() || trimmedTerm.isEmpty() || !fuzzyMatch( source, trimmedTerm ) )
+    return 0.0;
+
+  if ( source.compare( trimmedTerm, Qt::CaseInsensitive ) == 0 )
+    return 1.0;
+
+  const double coverage = std::min( 1.0, static_cast<double>( trimmedTerm.length() ) / source.length() );
+  if ( source.startsWith( trimmedTerm, Qt::CaseInsensitive ) )
+    return 0.75 + 0.2 * coverage;
+
+  const int position = source.indexOf( trimmedTerm, 0, Qt::CaseInsensitive );
+  if ( position > 0 )
+    return ( source.at( position - 1 ).isLetterOrNumber() ? 0.3 : 0.5 ) + 0.2 * coverage;
+
+  return 0.1 + 0.2 * coverage;
+}
+
 QString StringUtils::pointInformation( const QgsPoint &point, const QgsCoordinateReferenceSystem &crs )
 {
   QString firstSuffix;
@@ -40,6 +40,13 @@ class QFIELD_CORE_EXPORT StringUtils : public QObject
     //! Checks whether the string \a term is part of \a source
     static bool fuzzyMatch( const QString &source, const QString &term );
 
+    /**
+     * Returns how well \a term matches \a source, from 0 when fuzzyMatch() fails to 1 for an identical string.
+     * Prefix matches score above 0.75, followed by matches starting a word, matches within a word and
+     * finally word prefixes matched in order. Within each tier, longer terms relative to the source score higher.
+     */
+    static double fuzzyMatchScore( const QString &source, const QString &term );
+
     //! Returns a string containing the \a point location and details of the \a crs
     static Q_INVOKABLE QString pointInformation( const QgsPoint &point, const QgsCoordinateReferenceSystem &crs );
 
@@ -21,7 +21,7 @@ Popup {
     Page {
         id: page
         width: parent.width
-        height: locatorfiltersList.height + 60
+        height: locatorfiltersList.height + indexAllFeaturesItem.height + 64
         padding: 10
         header: ToolBar {
           id: toolBar
@@ -116,6 +116,37 @@ Popup {
                     }
                 }
             }
+
+            ColumnLayout {
+                id: indexAllFeaturesItem
+                width: parent.width
+
+                CheckBox {
+                    Layout.fillWidth: true
+                    topPadding: 5
+                    bottomPadding: 5
+                    text: qsTr('Index all features')
+                    font: Theme.defaultFont
+                    indicator.height: 16
+                    indicator.width: 16
+                    indicator.implicitHeight: 24
+                    indicator.implicitWidth: 24
+                    checked: locatorFiltersModel.locatorModelSuperBridge ? locatorFiltersModel.locatorModelSuperBridge.indexAllFeatures : false
+                    onCheckedChanged: {
+                        if (locatorFiltersModel.locatorModelSuperBridge)
+                            locatorFiltersModel.locatorModelSuperBridge.indexAllFeatures = checked
+                    }
+                }
+                Text {
+                    Layout.fillWidth: true
+                    leftPadding: 5
+                    bottomPadding: 5
+                    text: qsTr('Keeps a search index of the features of the searchable layers on the device for faster feature searches. The index is built in the background when a project is opened and takes storage space.')
+                    font: Theme.tipFont
+                    color: Theme.gray
+                    wrapMode: Text.WordWrap
+                }
+            }
         }
     }
 }
@@ -70,8 +70,8 @@ Page {
             Text {
               id: tagtext
               objectName: 'tagText'
-              padding: MessageTag ? 5: 0
-              text: MessageTag
+              padding: MessageTag || MessageCount > 1 ? 5: 0
+              text: MessageTag + (MessageCount > 1 ? ' (×' + MessageCount + ')' : '')
               font.bold: true
             }
             Text {
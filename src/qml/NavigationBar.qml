@@ -781,6 +781,7 @@ Rectangle {
       id: timer
 
       property string printName: ''
+      property bool printing: false
 
       interval: 500
       repeat: false
@@ -794,6 +795,19 @@ Rectangle {
               ids.push(selection.focusedFeature.id)
           }
           if ( iface.printAtlasFeatures( printName, ids ) ) {
+              printing = true
+              printProgress.start()
+          }
+      }
+    }
+
+    Connections {
+      target: iface
+      enabled: timer.printing
+
+      function onPrintFinished(success, error) {
+          timer.printing = false
+          if ( success ) {
               displayToast( qsTr( 'Atlas feature(s) successfully printed and placed in your project folder' ) );
           }
       }
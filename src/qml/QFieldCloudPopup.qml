@@ -186,7 +186,11 @@ Popup {
                   case QFieldCloudProjectsModel.Downloading:
                     switch ( cloudProjectsModel.currentProjectData.PackagingStatus ) {
                       case QFieldCloudProjectsModel.PackagingFinishedStatus:
-                        return qsTr('Downloading %1%…').arg( parseInt(cloudProjectsModel.currentProjectData.DownloadProgress * 100) )
+                        var progressText = qsTr('Downloading %1%…').arg( parseInt(cloudProjectsModel.currentProjectData.DownloadProgress * 100) )
+                        if ( cloudProjectsModel.currentProjectData.DownloadSecondsRemaining >= 0 ) {
+                          progressText += ' ' + qsTr('(%1/s, about %2 min left)').arg( FileUtils.representFileSize(cloudProjectsModel.currentProjectData.DownloadBytesPerSecond) ).arg( Math.max(1, Math.ceil(cloudProjectsModel.currentProjectData.DownloadSecondsRemaining / 60)) )
+                        }
+                        return progressText
                       default:
                         return qsTr('QFieldCloud is preparing the latest data just for you. This might take some time, please hold tight…')
                     }
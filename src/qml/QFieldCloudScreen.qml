@@ -345,7 +345,9 @@ Page {
                                   case QFieldCloudProjectsModel.ProjectStatus.Downloading:
                                     switch (PackagingStatus) {
                                       case QFieldCloudProjectsModel.PackagingFinishedStatus:
-                                        status = qsTr( 'Downloading, %1% fetched…' ).arg( Math.round(DownloadProgress * 100) )
+                                        status = DownloadBytesPerSecond > 0
+                                            ? qsTr( 'Downloading, %1% fetched at %2/s…' ).arg( Math.round(DownloadProgress * 100) ).arg( FileUtils.representFileSize(DownloadBytesPerSecond) )
+                                            : qsTr( 'Downloading, %1% fetched…' ).arg( Math.round(DownloadProgress * 100) )
                                         break;
                                       default:
                                         status = qsTr('QFieldCloud is preparing the latest data just for you. This might take some time, please hold tight…')
@@ -320,6 +320,15 @@ Page {
         }
       }
 
+      BusyIndicator {
+        id: loadingIndicator
+        anchors.centerIn: parent
+        width: 36
+        height: 36
+        running: table.model.isLoading && table.count === 0
+        visible: running
+      }
+
       QfToolButton {
         id: importButton
         round: true
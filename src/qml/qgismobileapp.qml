@@ -2011,7 +2011,13 @@ ApplicationWindow {
 
       interval: 500
       repeat: false
-      onTriggered: iface.print( printName )
+      onTriggered: {
+        if ( iface.print( printName ) ) {
+          printProgress.start()
+        } else {
+          displayToast( qsTr( 'Printing failed' ), 'error' )
+        }
+      }
     }
   }
 
@@ -3241,6 +3247,66 @@ ApplicationWindow {
       }
   }
 
+  Popup {
+    id: printProgress
+    parent: mainWindow.contentItem
+    width: Math.min( 300, mainWindow.width - Theme.popupScreenEdgeMargin * 2 )
+    x: ( mainWindow.width - width ) / 2
+    y: ( mainWindow.height - height ) / 2
+    z: 10000
+    padding: 10
+    modal: true
+    closePolicy: Popup.NoAutoClose
+
+    property double progress: 0
+
+    function start() {
+      progress = 0
+      open()
+    }
+
+    Column {
+      width: parent.width
+      spacing: 10
+
+      Text {
+        width: parent.width
+        text: qsTr( 'Printing...' )
+        font: Theme.defaultFont
+        wrapMode: Text.WordWrap
+      }
+
+      ProgressBar {
+        width: parent.width
+        from: 0
+        to: 1
+        value: printProgress.progress
+        Material.accent: Theme.mainColor
+      }
+
+      QfButton {
+        width: parent.width
+        text: qsTr( 'Cancel' )
+        onClicked: iface.cancelPrint()
+      }
+    }
+  }
+
+  Connections {
+    target: iface
+
+    function onPrintProgressChanged(progress) {
+      printProgress.progress = progress
+    }
+
+    function onPrintFinished(success, error) {
+      printProgress.close()
+      if ( !success ) {
+        displayToast( error, 'error' )
+      }
+    }
+  }
+
   MouseArea {
     id: barcodeReaderCatcher
     anchors.fill: parent
@@ -14,11 +14,14 @@
  *                                                                         *
  ***************************************************************************/
 
+#include "platformutilities.h"
 #include "qfield_android.h"
 #include "qfieldcloudconnection.h"
+#include "qfieldcloudsyncengine.h"
 #include "qfieldservice.h"
 
 #include <QtAndroid>
+#include <qgsapplication.h>
 
 QFieldService::QFieldService( int &argc, char **argv )
   : QAndroidService( argc, argv )
@@ -33,6 +36,22 @@ QFieldService::QFieldService( int &argc, char **argv )
     loop.exec();
   }
 
+  // projects are fully synchronized in the background only when the user opted in
+  if ( settings.value( QStringLiteral( "/QFieldCloud/backgroundSync" ), false ).toBool() )
+  {
+    QgsApplication::init( PlatformUtilities::instance()->systemLocalDataLocation( QStringLiteral( "/qgis_profile" ) ) );
+    QgsApplication::initQgis();
+
+    QFieldCloudSyncEngine syncEngine( &connection );
+    QObject::connect( &syncEngine, &QFieldCloudSyncEngine::finished, &loop, &QEventLoop::quit );
+    if ( syncEngine.start() )
+    {
+      loop.exec();
+    }
+
+    QgsApplication::exitQgis();
+  }
+
   QtAndroid::androidService().callMethod<void>( "stopSelf" );
 
   exit( 0 );
@@ -0,0 +1,83 @@
+/***************************************************************************
+    main.cpp - qfield_sync
+
+ ---------------------
+ begin                : October 2026
+ copyright            : (C) 2026 by OPENGIS.ch
+ email                : info at opengis dot ch
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qfield.h"
+#include "qfieldcloudconnection.h"
+#include "qfieldcloudsyncengine.h"
+#include "qfieldcloudutils.h"
+
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <qgsapplication.h>
+#include <qgsmessagelog.h>
+
+int main( int argc, char **argv )
+{
+  QgsApplication app( argc, argv, false );
+
+  // share the settings of the app, holding the cloud url, user and token
+  QCoreApplication::setOrganizationName( "OPENGIS.ch" );
+  QCoreApplication::setOrganizationDomain( "opengis.ch" );
+  QCoreApplication::setApplicationName( qfield::appName );
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription( QStringLiteral( "Synchronizes the cloud projects of the user logged in QField." ) );
+  parser.addHelpOption();
+  const QCommandLineOption pushOnlyOption( QStringLiteral( "push-only" ), QStringLiteral( "Only push local changes, do not download the latest project packages." ) );
+  const QCommandLineOption cloudDirectoryOption( QStringLiteral( "cloud-directory" ), QStringLiteral( "Directory holding the local copies of the cloud projects." ), QStringLiteral( "path" ) );
+  parser.addOption( pushOnlyOption );
+  parser.addOption( cloudDirectoryOption );
+  parser.process( app );
+
+  if ( parser.isSet( cloudDirectoryOption ) )
+    QFieldCloudUtils::setLocalCloudDirectory( parser.value( cloudDirectoryOption ) );
+
+  QgsApplication::initQgis();
+
+  QTextStream out( stdout );
+  QObject::connect( QgsApplication::messageLog(), qOverload<const QString &, const QString &, Qgis::MessageLevel>( &QgsMessageLog::messageReceived ), &app, [&out]( const QString &message, const QString &tag, Qgis::MessageLevel ) {
+    out << tag << ": " << message << Qt::endl;
+  } );
+
+  QFieldCloudConnection connection;
+  QFieldCloudSyncEngine syncEngine( &connection );
+  syncEngine.setDownloadUpdates( !parser.isSet( pushOnlyOption ) );
+
+  int exitCode = 0;
+  QObject::connect( &syncEngine, &QFieldCloudSyncEngine::projectSynchronized, &app, [&out, &exitCode]( const QString &projectId, bool hasError, const QString &errorString ) {
+    if ( hasError )
+    {
+      out << "Failed to synchronize " << projectId << ": " << errorString << Qt::endl;
+      exitCode = 1;
+    }
+    else
+    {
+      out << "Synchronized " << projectId << Qt::endl;
+    }
+  } );
+  QObject::connect( &syncEngine, &QFieldCloudSyncEngine::finished, &app, &QCoreApplication::quit );
+
+  if ( !syncEngine.start() )
+  {
+    QgsApplication::exitQgis();
+    return 2;
+  }
+
+  app.exec();
+
+  QgsApplication::exitQgis();
+  return exitCode;
+}
@@ -79,4 +79,26 @@ TEST_CASE( "AttributeFormModel" )
     QgsFeature feature = layer->getFeature( fid );
     REQUIRE( feature.attributes().at( 2 ) == QStringLiteral( "edit_feature__" ) );
   }
+
+  SECTION( "ConstraintDependencies" )
+  {
+    // the constraint of str2 references str, editing str has to validate str2 again
+    layer->setConstraintExpression( 2, QStringLiteral( "\"str\" <> 'invalid'" ) );
+    layer->setFieldConstraint( 2, QgsFieldConstraints::ConstraintExpression, QgsFieldConstraints::ConstraintStrengthHard );
+
+    std::unique_ptr<AttributeFormModel> constrainedFormModel = std::make_unique<AttributeFormModel>();
+    std::unique_ptr<FeatureModel> constrainedFeatureModel = std::make_unique<FeatureModel>();
+    constrainedFormModel->setFeatureModel( constrainedFeatureModel.get() );
+    constrainedFeatureModel->setCurrentLayer( layer.get() );
+    constrainedFeatureModel->setFeature( layer->getFeature( 1 ) );
+    REQUIRE( constrainedFormModel->constraintsHardValid() );
+
+    constrainedFormModel->setData( constrainedFormModel->index( 1, 0 ), QString( "invalid" ), AttributeFormModel::AttributeValue );
+    REQUIRE( !constrainedFormModel->constraintsHardValid() );
+    REQUIRE( !constrainedFormModel->data( constrainedFormModel->index( 2, 0 ), AttributeFormModel::ConstraintHardValid ).toBool() );
+
+    constrainedFormModel->setData( constrainedFormModel->index( 1, 0 ), QString( "valid" ), AttributeFormModel::AttributeValue );
+    REQUIRE( constrainedFormModel->constraintsHardValid() );
+    REQUIRE( constrainedFormModel->data( constrainedFormModel->index( 2, 0 ), AttributeFormModel::ConstraintHardValid ).toBool() );
+  }
 }
@@ -28,6 +28,7 @@
 
 #include <QFileInfo>
 #include <qgsproject.h>
+#include <qgsziputils.h>
 
 QT_BEGIN_NAMESPACE
 std::ostream &operator<<( std::ostream &os, const QJsonDocument &value )
@@ -667,6 +668,44 @@ TEST_CASE( "DeltaFileWrapper" )
   }
 
 
+  SECTION( "ToFileForUpload" )
+  {
+    DeltaFileWrapper dfw( project, workDir.filePath( QUuid::createUuid().toString() ) );
+    QgsFields fields;
+    fields.append( QgsField( "fid", QVariant::Int, "integer" ) );
+
+    for ( int i = 0; i < 200; i++ )
+    {
+      QgsFeature feature( fields, 100 + i );
+      feature.setAttribute( "fid", 100 + i );
+      feature.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "LINESTRING(%1 %2, %3 %4, %5 %6)" ).arg( 2600000 + i ).arg( 1200000 + i ).arg( 2600010 + i ).arg( 1200010 + i ).arg( 2600020 + i ).arg( 1200020 + i ) ) );
+      dfw.addCreate( layer->id(), layer->id(), QStringLiteral( "fid" ), QStringLiteral( "fid" ), feature );
+    }
+
+    const QString fileName = dfw.toFileForUpload( workDir.filePath( QUuid::createUuid().toString() ) );
+    REQUIRE( !fileName.isEmpty() );
+
+    QFile deltaFile( fileName );
+    REQUIRE( deltaFile.open( QIODevice::ReadOnly ) );
+    const QByteArray uploadPayload = deltaFile.readAll();
+    const QJsonDocument uploadDoc = QJsonDocument::fromJson( uploadPayload );
+    REQUIRE( uploadDoc.object().value( QStringLiteral( "deltas" ) ).toArray().size() == 200 );
+
+    // the payload is written without indentation
+    REQUIRE( uploadPayload.size() < uploadDoc.toJson( QJsonDocument::Indented ).size() );
+    REQUIRE( !uploadPayload.contains( '\n' ) );
+
+    // and deltas are repetitive enough for gzip to shrink them considerably
+    QByteArray compressedPayload;
+    REQUIRE( QgsZipUtils::encodeGzip( uploadPayload, compressedPayload ) );
+    REQUIRE( compressedPayload.size() * 4 < uploadPayload.size() );
+
+    QByteArray decompressedPayload;
+    REQUIRE( QgsZipUtils::decodeGzip( compressedPayload, decompressedPayload ) );
+    REQUIRE( decompressedPayload == uploadPayload );
+  }
+
+
   SECTION( "Append" )
   {
     DeltaFileWrapper dfw1( project, workDir.filePath( QUuid::createUuid().toString() ) );
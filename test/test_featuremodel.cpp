@@ -19,6 +19,7 @@
 #include "featuremodel.h"
 #include "gnsspositioninformation.h"
 
+#include <qgsvectordataprovider.h>
 #include <qgsvectorlayer.h>
 
 TEST_CASE( "FeatureModel" )
@@ -50,4 +51,82 @@ TEST_CASE( "FeatureModel" )
   REQUIRE( feature.attribute( 0 ).toString() == QStringLiteral( "updated" ) );
   REQUIRE( feature.attribute( 1 ).toDouble() == 5.5 );
   REQUIRE( feature.attribute( 2 ).toDouble() == 10.5 );
+
+  // position scope refreshed once the position changed
+  GnssPositionInformation updatedPosition( 1.1, 2.2, 50.0, 50.0, 0.0, QList<QgsSatelliteInfo>(), 0, 0, 0, 3.5, 7.5, QDateTime(), QChar(), 0, 100 );
+  featureModel->setPositionInformation( updatedPosition );
+  featureModel->save();
+
+  feature = featureModel->feature();
+  REQUIRE( feature.attribute( 1 ).toDouble() == 3.5 );
+  REQUIRE( feature.attribute( 2 ).toDouble() == 7.5 );
+}
+
+TEST_CASE( "FeatureModel default value dependents" )
+{
+  std::unique_ptr<QgsVectorLayer> layer = std::make_unique<QgsVectorLayer>( QStringLiteral( "Point?crs=EPSG:4326&field=name:text&field=label:text&field=summary:text&field=user:text" ), QStringLiteral( "vl" ), QStringLiteral( "memory" ) );
+  layer->setDefaultValueDefinition( 1, QgsDefaultValue( QStringLiteral( "upper(\"name\")" ), true ) );
+  layer->setDefaultValueDefinition( 2, QgsDefaultValue( QStringLiteral( "array_to_string(map_avals(attributes()))" ), true ) );
+  layer->setDefaultValueDefinition( 3, QgsDefaultValue( QStringLiteral( "@cloud_username" ), true ) );
+  std::unique_ptr<FeatureModel> featureModel = std::make_unique<FeatureModel>();
+  featureModel->setCurrentLayer( layer.get() );
+
+  const QList<int> nameDependents = featureModel->defaultValueDependents( 0 );
+  REQUIRE( nameDependents.size() == 2 );
+  REQUIRE( nameDependents.contains( 1 ) );
+  REQUIRE( nameDependents.contains( 2 ) );
+
+  const QList<int> userDependents = featureModel->defaultValueDependents( 3 );
+  REQUIRE( userDependents == QList<int>() << 2 );
+
+  featureModel->resetFeature();
+  featureModel->setData( featureModel->index( 0, 0 ), QStringLiteral( "point" ), FeatureModel::AttributeValue );
+  REQUIRE( featureModel->evaluateDefaultValue( 1 ).toString() == QStringLiteral( "POINT" ) );
+  REQUIRE( !featureModel->evaluateDefaultValue( 0 ).isValid() );
+
+  CloudUserInformation cloudUserInformation( QStringLiteral( "fieldworker" ), QStringLiteral( "fieldworker@example.com" ) );
+  featureModel->setCloudUserInformation( cloudUserInformation );
+  REQUIRE( featureModel->evaluateDefaultValue( 3 ).toString() == QStringLiteral( "fieldworker" ) );
+}
+
+TEST_CASE( "FeatureModel multi feature save" )
+{
+  std::unique_ptr<QgsVectorLayer> layer = std::make_unique<QgsVectorLayer>( QStringLiteral( "Point?crs=EPSG:4326&field=name:text&field=label:text" ), QStringLiteral( "vl" ), QStringLiteral( "memory" ) );
+  QgsFeatureList features;
+  for ( int i = 0; i < 3; i++ )
+  {
+    QgsFeature feature( layer->fields() );
+    feature.setAttributes( QgsAttributes() << QStringLiteral( "name %1" ).arg( i ) << QStringLiteral( "label %1" ).arg( i ) );
+    feature.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, i ) ) );
+    features << feature;
+  }
+  layer->dataProvider()->addFeatures( features );
+
+  features.clear();
+  QgsFeature feature;
+  QgsFeatureIterator it = layer->getFeatures();
+  while ( it.nextFeature( feature ) )
+    features << feature;
+  REQUIRE( features.size() == 3 );
+
+  std::unique_ptr<FeatureModel> featureModel = std::make_unique<FeatureModel>();
+  featureModel->setModelMode( FeatureModel::MultiFeatureModel );
+  featureModel->setCurrentLayer( layer.get() );
+  featureModel->setFeatures( features );
+
+  REQUIRE( !featureModel->data( featureModel->index( 1, 0 ), FeatureModel::AttributeAllowEdit ).toBool() );
+  featureModel->setData( featureModel->index( 1, 0 ), true, FeatureModel::AttributeAllowEdit );
+  featureModel->setData( featureModel->index( 1, 0 ), QStringLiteral( "batch" ), FeatureModel::AttributeValue );
+  REQUIRE( featureModel->save() );
+
+  int i = 0;
+  it = layer->getFeatures();
+  while ( it.nextFeature( feature ) )
+  {
+    REQUIRE( feature.attribute( 0 ).toString() == QStringLiteral( "name %1" ).arg( i ) );
+    REQUIRE( feature.attribute( 1 ).toString() == QStringLiteral( "batch" ) );
+    REQUIRE( feature.geometry().asPoint() == QgsPointXY( i, i ) );
+    i++;
+  }
+  REQUIRE( i == 3 );
 }
@@ -0,0 +1,165 @@
+/***************************************************************************
+                        test_featureslocatorindex.cpp
+                        --------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by OPENGIS.ch
+  email                : info at opengis dot ch
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#define QFIELDTEST_MAIN
+#include "catch2.h"
+#include "featureslocatorindex.h"
+
+#include <QElapsedTimer>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <functional>
+#include <qgsapplication.h>
+#include <qgsproject.h>
+#include <qgsvectordataprovider.h>
+#include <qgsvectorlayer.h>
+
+namespace
+{
+  bool waitFor( const std::function<bool()> &condition, int timeout = 10000 )
+  {
+    QElapsedTimer timer;
+    timer.start();
+    while ( !condition() )
+    {
+      if ( timer.elapsed() > timeout )
+        return false;
+      QCoreApplication::processEvents( QEventLoop::AllEvents, 50 );
+    }
+    return true;
+  }
+
+  QStringList displayStrings( const QList<FeaturesLocatorIndex::Match> &matches )
+  {
+    QStringList strings;
+    for ( const FeaturesLocatorIndex::Match &match : matches )
+      strings << match.displayString;
+    strings.sort();
+    return strings;
+  }
+} // namespace
+
+TEST_CASE( "FeaturesLocatorIndex" )
+{
+  // keeps the index databases out of the user data location
+  QStandardPaths::setTestModeEnabled( true );
+
+  QTemporaryDir projectDir;
+  REQUIRE( projectDir.isValid() );
+  QgsProject::instance()->clear();
+  QgsProject::instance()->setFileName( projectDir.filePath( QStringLiteral( "lands.qgs" ) ) );
+
+  std::unique_ptr<QgsVectorLayer> layer = std::make_unique<QgsVectorLayer>( QStringLiteral( "Point?crs=EPSG:3857&field=name:string" ), QStringLiteral( "land" ), QStringLiteral( "memory" ) );
+  REQUIRE( layer->isValid() );
+  layer->setDisplayExpression( QStringLiteral( "name" ) );
+
+  QgsFeatureList features;
+  const QStringList names = QStringList() << QStringLiteral( "Mordor" ) << QStringLiteral( "Gondor" ) << QStringLiteral( "Rohan" ) << QStringLiteral( "Lothlórien" ) << QStringLiteral( "Minas Tirith" );
+  for ( const QString &name : names )
+  {
+    QgsFeature feature( layer->fields() );
+    feature.setAttributes( QgsAttributes() << name );
+    features << feature;
+  }
+  REQUIRE( layer->dataProvider()->addFeatures( features ) );
+  QgsProject::instance()->addMapLayer( layer.get(), false, false );
+
+  const QString layerId = layer->id();
+  const QStringList layerIds = QStringList() << layerId;
+
+  std::unique_ptr<FeaturesLocatorIndex> index = std::make_unique<FeaturesLocatorIndex>();
+  REQUIRE( !index->isEnabled() );
+  REQUIRE( !index->isLayerIndexed( layerId ) );
+
+  // the layer is indexed in the background once enabled
+  index->setEnabled( true );
+  REQUIRE( waitFor( [&]() { return index->isLayerIndexed( layerId ); } ) );
+
+  SECTION( "Search" )
+  {
+    REQUIRE( displayStrings( index->search( QStringLiteral( "gon" ), layerIds, 10 ).value( layerId ) ) == QStringList() << QStringLiteral( "Gondor" ) );
+
+    // case and diacritics are ignored
+    REQUIRE( displayStrings( index->search( QStringLiteral( "LOTHLORIEN" ), layerIds, 10 ).value( layerId ) ) == QStringList() << QStringLiteral( "Lothlórien" ) );
+
+    // each word prefixes a word of the display string
+    REQUIRE( displayStrings( index->search( QStringLiteral( "min tir" ), layerIds, 10 ).value( layerId ) ) == QStringList() << QStringLiteral( "Minas Tirith" ) );
+    REQUIRE( index->search( QStringLiteral( "ondor" ), layerIds, 10 ).value( layerId ).isEmpty() );
+    REQUIRE( index->search( QStringLiteral( "min rohan" ), layerIds, 10 ).value( layerId ).isEmpty() );
+
+    // matches are limited per layer and carry the feature ids
+    REQUIRE( index->search( QStringLiteral( "m" ), layerIds, 1 ).value( layerId ).size() == 1 );
+    const QList<FeaturesLocatorIndex::Match> mordor = index->search( QStringLiteral( "mordor" ), layerIds, 10 ).value( layerId );
+    REQUIRE( mordor.size() == 1 );
+    REQUIRE( layer->getFeature( mordor.at( 0 ).featureId ).attribute( 0 ).toString() == QStringLiteral( "Mordor" ) );
+
+    // layers not asked for are not searched
+    REQUIRE( index->search( QStringLiteral( "gondor" ), QStringList() << QStringLiteral( "other" ), 10 ).value( layerId ).isEmpty() );
+  }
+
+  SECTION( "CommittedChanges" )
+  {
+    const QgsFeatureId mordorId = index->search( QStringLiteral( "mordor" ), layerIds, 10 ).value( layerId ).at( 0 ).featureId;
+    const QgsFeatureId rohanId = index->search( QStringLiteral( "rohan" ), layerIds, 10 ).value( layerId ).at( 0 ).featureId;
+
+    REQUIRE( layer->startEditing() );
+    QgsFeature feature( layer->fields() );
+    feature.setAttributes( QgsAttributes() << QStringLiteral( "Gondolin" ) );
+    REQUIRE( layer->addFeature( feature ) );
+    REQUIRE( layer->changeAttributeValue( mordorId, 0, QStringLiteral( "Minas Morgul" ) ) );
+    REQUIRE( layer->deleteFeature( rohanId ) );
+    REQUIRE( layer->commitChanges() );
+
+    // committed changes are written to the index shortly after
+    REQUIRE( waitFor( [&]() { return !index->search( QStringLiteral( "gondolin" ), layerIds, 10 ).value( layerId ).isEmpty(); } ) );
+    REQUIRE( displayStrings( index->search( QStringLiteral( "gon" ), layerIds, 10 ).value( layerId ) ) == QStringList() << QStringLiteral( "Gondolin" ) << QStringLiteral( "Gondor" ) );
+    REQUIRE( displayStrings( index->search( QStringLiteral( "minas" ), layerIds, 10 ).value( layerId ) ) == QStringList() << QStringLiteral( "Minas Morgul" ) << QStringLiteral( "Minas Tirith" ) );
+    REQUIRE( index->search( QStringLiteral( "mordor" ), layerIds, 10 ).value( layerId ).isEmpty() );
+    REQUIRE( index->search( QStringLiteral( "rohan" ), layerIds, 10 ).value( layerId ).isEmpty() );
+  }
+
+  SECTION( "DisplayExpressionChanged" )
+  {
+    layer->setDisplayExpression( QStringLiteral( "concat( name, ' realm' )" ) );
+    REQUIRE( !index->isLayerIndexed( layerId ) );
+
+    REQUIRE( waitFor( [&]() { return index->isLayerIndexed( layerId ); } ) );
+    REQUIRE( index->search( QStringLiteral( "realm" ), layerIds, 10 ).value( layerId ).size() == 5 );
+    REQUIRE( displayStrings( index->search( QStringLiteral( "rohan" ), layerIds, 10 ).value( layerId ) ) == QStringList() << QStringLiteral( "Rohan realm" ) );
+  }
+
+  SECTION( "Reopened" )
+  {
+    // an unchanged layer is searchable right away through the index kept from the previous session
+    index.reset();
+    index = std::make_unique<FeaturesLocatorIndex>();
+    index->setEnabled( true );
+    REQUIRE( index->isLayerIndexed( layerId ) );
+    REQUIRE( displayStrings( index->search( QStringLiteral( "gondor" ), layerIds, 10 ).value( layerId ) ) == QStringList() << QStringLiteral( "Gondor" ) );
+  }
+
+  SECTION( "Disabled" )
+  {
+    index->setEnabled( false );
+    REQUIRE( !index->isLayerIndexed( layerId ) );
+    REQUIRE( index->search( QStringLiteral( "gondor" ), layerIds, 10 ).isEmpty() );
+  }
+
+  index.reset();
+  QgsProject::instance()->removeMapLayer( layerId );
+  QgsProject::instance()->clear();
+}
@@ -0,0 +1,117 @@
+/***************************************************************************
+                        test_filedeltautils.cpp
+                        --------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by OPENGIS.ch
+  email                : info@opengis.ch
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "catch2.h"
+#include "utils/filedeltautils.h"
+
+#include <QBuffer>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+static QString writeFile( const QTemporaryDir &dir, const QString &name, const QByteArray &content )
+{
+  const QString fileName = dir.filePath( name );
+  QFile file( fileName );
+  file.open( QIODevice::WriteOnly );
+  file.write( content );
+  file.close();
+  return fileName;
+}
+
+static QByteArray roundTrip( const QTemporaryDir &dir, const QByteArray &base, const QByteArray &modified, qint64 &deltaSize )
+{
+  const QString baseFileName = writeFile( dir, QStringLiteral( "base.bin" ), base );
+  const QString modifiedFileName = writeFile( dir, QStringLiteral( "modified.bin" ), modified );
+
+  // the client computes the signature of its local copy, the server answers with a delta
+  const QByteArray signature = FileDeltaUtils::signature( baseFileName, 1024 );
+  REQUIRE( !signature.isEmpty() );
+
+  QBuffer delta;
+  delta.open( QIODevice::ReadWrite );
+  REQUIRE( FileDeltaUtils::createDelta( signature, modifiedFileName, &delta ) );
+  deltaSize = delta.size();
+
+  delta.seek( 0 );
+  QBuffer output;
+  output.open( QIODevice::WriteOnly );
+  QCryptographicHash hash( QCryptographicHash::Sha256 );
+  REQUIRE( FileDeltaUtils::applyDelta( baseFileName, &delta, &output, &hash ) );
+  REQUIRE( hash.result() == QCryptographicHash::hash( output.data(), QCryptographicHash::Sha256 ) );
+
+  return output.data();
+}
+
+TEST_CASE( "FileDeltaUtils" )
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  QByteArray base( 256 * 1024, Qt::Uninitialized );
+  QRandomGenerator generator( 42 );
+  for ( int i = 0; i < base.size(); i++ )
+    base[i] = static_cast<char>( generator.bounded( 256 ) );
+
+  qint64 deltaSize = 0;
+
+  SECTION( "Identical" )
+  {
+    REQUIRE( roundTrip( dir, base, base, deltaSize ) == base );
+    REQUIRE( deltaSize < 64 );
+  }
+
+  SECTION( "Modified" )
+  {
+    QByteArray modified = base;
+    modified[1000] = static_cast<char>( ~modified.at( 1000 ) );
+    modified[200000] = static_cast<char>( ~modified.at( 200000 ) );
+
+    REQUIRE( roundTrip( dir, base, modified, deltaSize ) == modified );
+    REQUIRE( deltaSize < 4 * 1024 );
+  }
+
+  SECTION( "Inserted and removed" )
+  {
+    QByteArray modified = base;
+    modified.insert( 5000, QByteArray( "inserted content shifting every following block" ) );
+    modified.remove( 150000, 777 );
+    modified.append( QByteArray( "tail" ) );
+
+    REQUIRE( roundTrip( dir, base, modified, deltaSize ) == modified );
+    REQUIRE( deltaSize < 8 * 1024 );
+  }
+
+  SECTION( "Unrelated" )
+  {
+    QByteArray modified( 10000, 'x' );
+    REQUIRE( roundTrip( dir, base, modified, deltaSize ) == modified );
+  }
+
+  SECTION( "Invalid" )
+  {
+    const QString baseFileName = writeFile( dir, QStringLiteral( "base.bin" ), base );
+
+    QBuffer output;
+    output.open( QIODevice::WriteOnly );
+    REQUIRE( !FileDeltaUtils::createDelta( QByteArray( "garbage" ), baseFileName, &output ) );
+
+    QBuffer delta;
+    delta.setData( QByteArray( "garbage" ) );
+    delta.open( QIODevice::ReadOnly );
+    REQUIRE( !FileDeltaUtils::applyDelta( baseFileName, &delta, &output ) );
+  }
+}
@@ -16,8 +16,10 @@
  ***************************************************************************/
 
 #include "catch2.h"
+#include "utils/filechecksumcache.h"
 #include "utils/fileutils.h"
 
+#include <QTemporaryDir>
 #include <QTemporaryFile>
 
 TEST_CASE( "FileUtils" )
@@ -62,4 +64,53 @@ TEST_CASE( "FileUtils" )
     delete f;
     REQUIRE( !FileUtils::fileExists( fileName ) );
   }
+
+
+  SECTION( "FileChecksum" )
+  {
+    QTemporaryFile f;
+    REQUIRE( f.open() );
+    f.write( "QField" );
+    f.flush();
+
+    REQUIRE( FileUtils::fileChecksum( f.fileName() ) == QCryptographicHash::hash( "QField", QCryptographicHash::Sha256 ) );
+    REQUIRE( FileUtils::fileChecksum( QStringLiteral( "/no/such/file" ) ).isNull() );
+  }
+
+
+  SECTION( "FileChecksumCache" )
+  {
+    QTemporaryDir dir;
+    REQUIRE( dir.isValid() );
+
+    const QString cacheFileName = dir.filePath( QStringLiteral( "checksums.cache" ) );
+    const QString fileName = dir.filePath( QStringLiteral( "file.txt" ) );
+    QFile file( fileName );
+    REQUIRE( file.open( QIODevice::WriteOnly ) );
+    file.write( "QField" );
+    file.close();
+
+    {
+      FileChecksumCache cache( cacheFileName );
+      REQUIRE( cache.checksum( fileName ) == QCryptographicHash::hash( "QField", QCryptographicHash::Sha256 ) );
+      REQUIRE( cache.checksums( QStringList() << fileName << dir.filePath( QStringLiteral( "missing.txt" ) ) ).size() == 1 );
+
+      // a recorded checksum is trusted as long as the file is unchanged
+      cache.insert( fileName, QByteArray( "recorded" ) );
+      REQUIRE( cache.checksum( fileName ) == QByteArray( "recorded" ) );
+    }
+
+    REQUIRE( QFile::exists( cacheFileName ) );
+
+    {
+      FileChecksumCache cache( cacheFileName );
+      REQUIRE( cache.checksum( fileName ) == QByteArray( "recorded" ) );
+
+      // a modified file is hashed again
+      REQUIRE( file.open( QIODevice::WriteOnly | QIODevice::Append ) );
+      file.write( " Cloud" );
+      file.close();
+      REQUIRE( cache.checksum( fileName ) == QCryptographicHash::hash( "QField Cloud", QCryptographicHash::Sha256 ) );
+    }
+  }
 }
@@ -0,0 +1,318 @@
+/***************************************************************************
+                        test_layertreemodel.cpp
+                        --------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by OPENGIS.ch
+  email                : info at opengis dot ch
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#define QFIELDTEST_MAIN
+#include "catch2.h"
+#include "layertreemodel.h"
+
+#include <QAbstractItemModelTester>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <functional>
+#include <qgsapplication.h>
+#include <qgscategorizedsymbolrenderer.h>
+#include <qgslayertree.h>
+#include <qgsproject.h>
+#include <qgssymbol.h>
+#include <qgsvectordataprovider.h>
+#include <qgsvectorlayer.h>
+
+namespace
+{
+  bool waitFor( const std::function<bool()> &condition, int timeout = 10000 )
+  {
+    QElapsedTimer timer;
+    timer.start();
+    while ( !condition() )
+    {
+      if ( timer.elapsed() > timeout )
+        return false;
+      QCoreApplication::processEvents( QEventLoop::AllEvents, 50 );
+    }
+    return true;
+  }
+
+  //! Lets pending timers fire for \a msecs milliseconds
+  void wait( int msecs )
+  {
+    QElapsedTimer timer;
+    timer.start();
+    while ( timer.elapsed() < msecs )
+      QCoreApplication::processEvents( QEventLoop::AllEvents, 10 );
+  }
+
+  //! Returns the number of data changes reported by \a spy which include the feature count role
+  int featureCountChanges( const QSignalSpy &spy )
+  {
+    int count = 0;
+    for ( const QList<QVariant> &arguments : spy )
+    {
+      if ( arguments.at( 2 ).value<QVector<int>>().contains( FlatLayerTreeModel::FeatureCount ) )
+        count++;
+    }
+    return count;
+  }
+
+  QgsFeatureList createFeatures( QgsVectorLayer *layer, int count )
+  {
+    QgsFeatureList features;
+    for ( int i = 0; i < count; i++ )
+    {
+      QgsFeature feature( layer->fields() );
+      feature.setAttributes( QgsAttributes() << QStringLiteral( "point %1" ).arg( i ) );
+      feature.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, i ) ) );
+      features << feature;
+    }
+    return features;
+  }
+
+  //! Returns the tree level, type, name and collapsed states of the rows of \a model
+  QStringList rowStates( const QAbstractItemModel *model )
+  {
+    QStringList states;
+    for ( int row = 0; row < model->rowCount(); row++ )
+    {
+      const QModelIndex index = model->index( row, 0 );
+      states << QStringLiteral( "%1 %2 %3 collapsed:%4 parentCollapsed:%5" )
+                  .arg( model->data( index, FlatLayerTreeModel::TreeLevel ).toString(),
+                        model->data( index, FlatLayerTreeModel::Type ).toString(),
+                        model->data( index, FlatLayerTreeModel::Name ).toString(),
+                        model->data( index, FlatLayerTreeModel::IsCollapsed ).toString(),
+                        model->data( index, FlatLayerTreeModel::IsParentCollapsed ).toString() );
+    }
+    return states;
+  }
+
+  //! Returns the row of the node named \a name in \a model, or -1
+  int rowOf( const QAbstractItemModel *model, const QString &name )
+  {
+    for ( int row = 0; row < model->rowCount(); row++ )
+    {
+      if ( model->data( model->index( row, 0 ), FlatLayerTreeModel::Name ).toString() == name )
+        return row;
+    }
+    return -1;
+  }
+
+  QgsVectorLayer *createLayer( const QString &name, bool categorized = false )
+  {
+    QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Point?crs=EPSG:3857&field=name:string" ), name, QStringLiteral( "memory" ) );
+    if ( categorized )
+    {
+      // categories are shown as legend rows below the layer
+      QgsCategoryList categories;
+      categories << QgsRendererCategory( QStringLiteral( "a" ), QgsSymbol::defaultSymbol( QgsWkbTypes::PointGeometry ), QStringLiteral( "category a" ) );
+      categories << QgsRendererCategory( QStringLiteral( "b" ), QgsSymbol::defaultSymbol( QgsWkbTypes::PointGeometry ), QStringLiteral( "category b" ) );
+      layer->setRenderer( new QgsCategorizedSymbolRenderer( QStringLiteral( "name" ), categories ) );
+    }
+    return layer;
+  }
+} // namespace
+
+TEST_CASE( "FlatLayerTreeModel feature counts" )
+{
+  QgsProject project;
+  QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Point?crs=EPSG:3857&field=name:string" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  REQUIRE( layer->isValid() );
+  REQUIRE( layer->dataProvider()->addFeatures( createFeatures( layer, 3 ) ) );
+  project.addMapLayer( layer );
+
+  FlatLayerTreeModel model( project.layerTreeRoot(), &project );
+  REQUIRE( model.rowCount() >= 1 );
+  const QModelIndex index = model.index( 0, 0 );
+  REQUIRE( model.data( index, FlatLayerTreeModel::VectorLayerPointer ).value<QgsVectorLayer *>() == layer );
+
+  auto featureCount = [&]() -> long long {
+    return model.data( index, FlatLayerTreeModel::FeatureCount ).toLongLong();
+  };
+
+  // the layer is counted in the background the first time its count is asked for
+  REQUIRE( waitFor( [&]() { return featureCount() == 3; } ) );
+  wait( 200 );
+
+  REQUIRE( layer->startEditing() );
+  wait( 200 );
+
+  QSignalSpy dataChangedSpy( &model, &QAbstractItemModel::dataChanged );
+
+  SECTION( "AddedFeatures" )
+  {
+    for ( QgsFeature feature : createFeatures( layer, 5 ) )
+      REQUIRE( layer->addFeature( feature ) );
+
+    // the count follows each edit right away, the views are notified once the edits are over
+    REQUIRE( featureCount() == 8 );
+    REQUIRE( featureCountChanges( dataChangedSpy ) == 0 );
+
+    REQUIRE( waitFor( [&]() { return featureCountChanges( dataChangedSpy ) > 0; } ) );
+    wait( 200 );
+    REQUIRE( featureCountChanges( dataChangedSpy ) == 1 );
+    REQUIRE( featureCount() == 8 );
+  }
+
+  SECTION( "DeletedFeatures" )
+  {
+    QgsFeatureIds fids;
+    QgsFeature feature;
+    QgsFeatureIterator it = layer->getFeatures();
+    while ( it.nextFeature( feature ) && fids.size() < 2 )
+      fids << feature.id();
+
+    for ( QgsFeatureId fid : std::as_const( fids ) )
+      REQUIRE( layer->deleteFeature( fid ) );
+
+    REQUIRE( featureCount() == 1 );
+    REQUIRE( featureCountChanges( dataChangedSpy ) == 0 );
+
+    REQUIRE( waitFor( [&]() { return featureCountChanges( dataChangedSpy ) > 0; } ) );
+    wait( 200 );
+    REQUIRE( featureCountChanges( dataChangedSpy ) == 1 );
+  }
+
+  SECTION( "EditsSpreadOverTime" )
+  {
+    QgsFeatureList features = createFeatures( layer, 2 );
+    REQUIRE( layer->addFeature( features[0] ) );
+    wait( 200 );
+    REQUIRE( layer->addFeature( features[1] ) );
+    wait( 200 );
+
+    // edits further apart than the coalescing delay are notified on their own
+    REQUIRE( featureCount() == 5 );
+    REQUIRE( featureCountChanges( dataChangedSpy ) == 2 );
+  }
+
+  SECTION( "CommittedChanges" )
+  {
+    for ( QgsFeature feature : createFeatures( layer, 4 ) )
+      REQUIRE( layer->addFeature( feature ) );
+    REQUIRE( layer->commitChanges() );
+
+    // committing recounts the layer
+    REQUIRE( waitFor( [&]() { return featureCount() == 7 && featureCountChanges( dataChangedSpy ) > 0; } ) );
+    REQUIRE( layer->featureCount() == 7 );
+  }
+
+  if ( layer->isEditable() )
+    REQUIRE( layer->rollBack() );
+}
+
+TEST_CASE( "FlatLayerTreeModel incremental updates" )
+{
+  QgsProject project;
+  QgsVectorLayer *roads = createLayer( QStringLiteral( "roads" ), true );
+  QgsVectorLayer *rivers = createLayer( QStringLiteral( "rivers" ) );
+  QgsVectorLayer *wells = createLayer( QStringLiteral( "wells" ), true );
+  QgsVectorLayer *trees = createLayer( QStringLiteral( "trees" ) );
+  QgsVectorLayer *lakes = createLayer( QStringLiteral( "lakes" ) );
+  project.addMapLayers( QList<QgsMapLayer *>() << roads << rivers << wells << trees << lakes, false );
+
+  QgsLayerTree *root = project.layerTreeRoot();
+  QgsLayerTreeGroup *network = root->addGroup( QStringLiteral( "network" ) );
+  network->addLayer( roads );
+  network->addLayer( rivers );
+  root->addLayer( trees );
+
+  QObject modelOwner;
+  FlatLayerTreeModel model( root, &project, &modelOwner );
+
+  // both the flattened model and its filtered proxy are checked on every change they report
+  QAbstractItemModelTester baseTester( model.sourceModel(), QAbstractItemModelTester::FailureReportingMode::Fatal );
+  QAbstractItemModelTester tester( &model, QAbstractItemModelTester::FailureReportingMode::Fatal );
+
+  // the incrementally updated rows must match those of a model built from scratch over the same tree
+  auto requireSameAsRebuilt = [&]() {
+    QObject rebuiltOwner;
+    FlatLayerTreeModel rebuilt( root, &project, &rebuiltOwner );
+    REQUIRE( rowStates( model.sourceModel() ) == rowStates( rebuilt.sourceModel() ) );
+    REQUIRE( rowStates( &model ) == rowStates( &rebuilt ) );
+  };
+
+  auto setCollapsed = [&]( const QString &name, bool collapsed ) {
+    const int row = rowOf( &model, name );
+    REQUIRE( row > -1 );
+    REQUIRE( model.setData( model.index( row, 0 ), collapsed, FlatLayerTreeModel::IsCollapsed ) );
+  };
+
+  requireSameAsRebuilt();
+  REQUIRE( rowOf( &model, QStringLiteral( "category a" ) ) > rowOf( &model, QStringLiteral( "roads" ) ) );
+
+  SECTION( "InsertNodes" )
+  {
+    // a layer between siblings, then a group holding layers with legend rows
+    network->insertLayer( 1, wells );
+    requireSameAsRebuilt();
+
+    QgsLayerTreeGroup *nested = new QgsLayerTreeGroup( QStringLiteral( "nested" ) );
+    nested->addLayer( lakes );
+    root->insertChildNode( 0, nested );
+    requireSameAsRebuilt();
+
+    nested->addGroup( QStringLiteral( "empty" ) );
+    requireSameAsRebuilt();
+  }
+
+  SECTION( "RemoveNodes" )
+  {
+    network->removeLayer( rivers );
+    requireSameAsRebuilt();
+
+    // a group along with all its descendant rows
+    root->removeChildNode( network );
+    requireSameAsRebuilt();
+    REQUIRE( rowOf( &model, QStringLiteral( "roads" ) ) == -1 );
+    REQUIRE( rowOf( &model, QStringLiteral( "category a" ) ) == -1 );
+  }
+
+  SECTION( "CollapseNodes" )
+  {
+    setCollapsed( QStringLiteral( "network" ), true );
+    requireSameAsRebuilt();
+    REQUIRE( rowOf( &model, QStringLiteral( "roads" ) ) == -1 );
+    REQUIRE( rowOf( model.sourceModel(), QStringLiteral( "roads" ) ) > -1 );
+
+    // a collapsed layer within a collapsed group stays collapsed once the group is expanded
+    const int roadsRow = rowOf( model.sourceModel(), QStringLiteral( "roads" ) );
+    REQUIRE( model.sourceModel()->setData( model.sourceModel()->index( roadsRow, 0 ), true, FlatLayerTreeModel::IsCollapsed ) );
+    setCollapsed( QStringLiteral( "network" ), false );
+    requireSameAsRebuilt();
+    REQUIRE( rowOf( &model, QStringLiteral( "roads" ) ) > -1 );
+    REQUIRE( rowOf( &model, QStringLiteral( "category a" ) ) == -1 );
+
+    setCollapsed( QStringLiteral( "roads" ), false );
+    requireSameAsRebuilt();
+    REQUIRE( rowOf( &model, QStringLiteral( "category a" ) ) > -1 );
+  }
+
+  SECTION( "ChangesWithinCollapsedNodes" )
+  {
+    setCollapsed( QStringLiteral( "network" ), true );
+
+    // rows inserted in a collapsed group are hidden, removing them keeps the other rows in place
+    network->addLayer( wells );
+    requireSameAsRebuilt();
+    REQUIRE( rowOf( &model, QStringLiteral( "wells" ) ) == -1 );
+
+    network->removeLayer( roads );
+    requireSameAsRebuilt();
+
+    setCollapsed( QStringLiteral( "network" ), false );
+    requireSameAsRebuilt();
+    REQUIRE( rowOf( &model, QStringLiteral( "wells" ) ) > -1 );
+    REQUIRE( rowOf( &model, QStringLiteral( "roads" ) ) == -1 );
+  }
+}
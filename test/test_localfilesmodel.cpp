@@ -0,0 +1,147 @@
+/***************************************************************************
+                        test_localfilesmodel.cpp
+                        --------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by OPENGIS.ch
+  email                : info at opengis dot ch
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#define QFIELDTEST_MAIN
+#include "catch2.h"
+#include "localfilesmodel.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <functional>
+
+namespace
+{
+  bool waitFor( const std::function<bool()> &condition, int timeout = 10000 )
+  {
+    QElapsedTimer timer;
+    timer.start();
+    while ( !condition() )
+    {
+      if ( timer.elapsed() > timeout )
+        return false;
+      QCoreApplication::processEvents( QEventLoop::AllEvents, 50 );
+    }
+    return true;
+  }
+
+  QStringList rowPaths( const LocalFilesModel &model )
+  {
+    QStringList paths;
+    for ( int row = 0; row < model.rowCount( QModelIndex() ); row++ )
+      paths << model.data( model.index( row, 0 ), LocalFilesModel::ItemPathRole ).toString();
+    return paths;
+  }
+
+  bool isSorted( const LocalFilesModel &model )
+  {
+    for ( int row = 1; row < model.rowCount( QModelIndex() ); row++ )
+    {
+      const QModelIndex previous = model.index( row - 1, 0 );
+      const QModelIndex current = model.index( row, 0 );
+      const int previousMetaType = model.data( previous, LocalFilesModel::ItemMetaTypeRole ).toInt();
+      const int currentMetaType = model.data( current, LocalFilesModel::ItemMetaTypeRole ).toInt();
+      if ( previousMetaType != currentMetaType )
+      {
+        if ( previousMetaType > currentMetaType )
+          return false;
+        continue;
+      }
+
+      const QString previousPath = model.data( previous, LocalFilesModel::ItemPathRole ).toString();
+      const QString currentPath = model.data( current, LocalFilesModel::ItemPathRole ).toString();
+      if ( QString::compare( previousPath, currentPath, Qt::CaseInsensitive ) > 0 )
+        return false;
+    }
+    return true;
+  }
+} // namespace
+
+TEST_CASE( "LocalFilesModel" )
+{
+  // more entries than a single fetch, in an order unrelated to the sorted one
+  const int entryCount = 450;
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  for ( int i = 0; i < entryCount; i++ )
+  {
+    const int number = ( i * 37 ) % entryCount;
+    switch ( i % 3 )
+    {
+      case 0:
+        REQUIRE( QDir( dir.path() ).mkdir( QStringLiteral( "Folder %1" ).arg( number ) ) );
+        break;
+      case 1:
+      {
+        QFile file( dir.filePath( QStringLiteral( "project %1.qgs" ).arg( number ) ) );
+        REQUIRE( file.open( QIODevice::WriteOnly ) );
+        break;
+      }
+      case 2:
+      {
+        QFile file( dir.filePath( QStringLiteral( "Data %1.gpkg" ).arg( number ) ) );
+        REQUIRE( file.open( QIODevice::WriteOnly ) );
+        break;
+      }
+    }
+  }
+
+  LocalFilesModel model;
+  QSignalSpy layoutChangedSpy( &model, &LocalFilesModel::layoutChanged );
+  QSignalSpy rowsInsertedSpy( &model, &LocalFilesModel::rowsInserted );
+
+  model.resetToPath( dir.path() );
+  REQUIRE( model.isLoading() );
+
+  // the scan pauses after each fetch limit until more rows are fetched, rows are sorted all along
+  int fetchCount = 0;
+  int expectedRowCount = 0;
+  while ( model.isLoading() )
+  {
+    expectedRowCount = std::min( expectedRowCount + 200, entryCount );
+    REQUIRE( waitFor( [&]() { return !model.isLoading() || ( model.canFetchMore( QModelIndex() ) && model.rowCount( QModelIndex() ) >= expectedRowCount ); } ) );
+    REQUIRE( model.rowCount( QModelIndex() ) >= expectedRowCount );
+    REQUIRE( isSorted( model ) );
+
+    if ( model.canFetchMore( QModelIndex() ) )
+    {
+      model.fetchMore( QModelIndex() );
+      fetchCount++;
+    }
+  }
+
+  REQUIRE( fetchCount >= 2 );
+  REQUIRE( model.rowCount( QModelIndex() ) == entryCount );
+  REQUIRE( isSorted( model ) );
+
+  // rows are inserted in place, never moved around
+  REQUIRE( rowsInsertedSpy.count() > 0 );
+  REQUIRE( layoutChangedSpy.count() == 0 );
+
+  // folders first, then projects, then datasets
+  REQUIRE( model.data( model.index( 0, 0 ), LocalFilesModel::ItemPathRole ).toString() == dir.filePath( QStringLiteral( "Folder 0" ) ) );
+  REQUIRE( model.data( model.index( entryCount / 3, 0 ), LocalFilesModel::ItemMetaTypeRole ).toInt() == LocalFilesModel::Project );
+  REQUIRE( model.data( model.index( entryCount - 1, 0 ), LocalFilesModel::ItemMetaTypeRole ).toInt() == LocalFilesModel::Dataset );
+
+  // the unchanged directory is listed again from the cache, in the same order
+  const QStringList paths = rowPaths( model );
+  model.resetToPath( dir.path() );
+  REQUIRE( !model.isLoading() );
+  REQUIRE( rowPaths( model ) == paths );
+}
@@ -0,0 +1,254 @@
+/***************************************************************************
+                        test_multifeaturelistmodel.cpp
+                        --------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by OPENGIS.ch
+  email                : info at opengis dot ch
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#define QFIELDTEST_MAIN
+#include "catch2.h"
+#include "multifeaturelistmodel.h"
+#include "multifeaturelistmodelbase.h"
+
+#include <QSignalSpy>
+#include <qgsapplication.h>
+#include <qgsvectordataprovider.h>
+#include <qgsvectorlayer.h>
+
+TEST_CASE( "MultiFeatureListModel" )
+{
+  // three unit squares side by side, apart from each other
+  std::unique_ptr<QgsVectorLayer> layer = std::make_unique<QgsVectorLayer>( QStringLiteral( "MultiPolygon?crs=EPSG:3857&field=name:string" ), QStringLiteral( "squares" ), QStringLiteral( "memory" ) );
+  REQUIRE( layer->isValid() );
+
+  QgsFeatureList features;
+  for ( int i = 0; i < 3; i++ )
+  {
+    QgsFeature feature( layer->fields() );
+    feature.setAttributes( QgsAttributes() << QStringLiteral( "square %1" ).arg( i ) );
+    feature.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "MultiPolygon(((%1 0, %2 0, %2 1, %1 1, %1 0)))" ).arg( i * 2 ).arg( i * 2 + 1 ) ) );
+    features << feature;
+  }
+  REQUIRE( layer->dataProvider()->addFeatures( features ) );
+  REQUIRE( layer->featureCount() == 3 );
+
+  std::unique_ptr<MultiFeatureListModelBase> model = std::make_unique<MultiFeatureListModelBase>();
+  QMap<QgsVectorLayer *, QgsFeatureRequest> requests;
+  requests.insert( layer.get(), QgsFeatureRequest() );
+  model->setFeatures( requests );
+  REQUIRE( model->count() == 3 );
+
+  auto featureAt = [&model]( int row ) -> QgsFeature {
+    return model->data( model->index( row, 0 ), MultiFeatureListModel::FeatureRole ).value<QgsFeature>();
+  };
+  const QgsFeatureId firstFid = featureAt( 0 ).id();
+  const QgsFeatureId secondFid = featureAt( 1 ).id();
+  const QgsFeatureId thirdFid = featureAt( 2 ).id();
+
+  QSignalSpy modelResetSpy( model.get(), &MultiFeatureListModelBase::modelReset );
+  QSignalSpy dataChangedSpy( model.get(), &MultiFeatureListModelBase::dataChanged );
+  QSignalSpy rowsRemovedSpy( model.get(), &MultiFeatureListModelBase::rowsRemoved );
+
+  SECTION( "DeleteSelection" )
+  {
+    model->toggleSelectedItem( 0 );
+    model->toggleSelectedItem( 2 );
+    REQUIRE( model->selectedCount() == 2 );
+    dataChangedSpy.clear();
+
+    REQUIRE( model->deleteSelection() );
+    REQUIRE( !layer->isEditable() );
+    REQUIRE( layer->featureCount() == 1 );
+
+    // deletions are applied once the edit command is over, one removal per range of contiguous rows
+    REQUIRE( modelResetSpy.count() == 0 );
+    REQUIRE( rowsRemovedSpy.count() == 2 );
+    REQUIRE( rowsRemovedSpy.at( 0 ).at( 1 ).toInt() == 2 );
+    REQUIRE( rowsRemovedSpy.at( 0 ).at( 2 ).toInt() == 2 );
+    REQUIRE( rowsRemovedSpy.at( 1 ).at( 1 ).toInt() == 0 );
+    REQUIRE( rowsRemovedSpy.at( 1 ).at( 2 ).toInt() == 0 );
+    REQUIRE( dataChangedSpy.count() == 0 );
+    REQUIRE( model->count() == 1 );
+    REQUIRE( featureAt( 0 ).id() == secondFid );
+    REQUIRE( model->selectedCount() == 0 );
+  }
+
+  SECTION( "DeleteFeature" )
+  {
+    // a single deletion goes through an edit command too and removes its row only
+    REQUIRE( model->deleteFeature( layer.get(), secondFid, false ) );
+    REQUIRE( !layer->isEditable() );
+    REQUIRE( layer->featureCount() == 2 );
+
+    REQUIRE( modelResetSpy.count() == 0 );
+    REQUIRE( rowsRemovedSpy.count() == 1 );
+    REQUIRE( rowsRemovedSpy.at( 0 ).at( 1 ).toInt() == 1 );
+    REQUIRE( rowsRemovedSpy.at( 0 ).at( 2 ).toInt() == 1 );
+    REQUIRE( model->count() == 2 );
+    REQUIRE( featureAt( 0 ).id() == firstFid );
+    REQUIRE( featureAt( 1 ).id() == thirdFid );
+  }
+
+  SECTION( "MoveSelection" )
+  {
+    model->toggleSelectedItem( 0 );
+    model->toggleSelectedItem( 2 );
+    dataChangedSpy.clear();
+
+    REQUIRE( model->moveSelection( 10, 5 ) );
+    REQUIRE( !layer->isEditable() );
+
+    // updates are applied with a single data change spanning the moved features
+    REQUIRE( modelResetSpy.count() == 0 );
+    REQUIRE( dataChangedSpy.count() == 1 );
+    REQUIRE( dataChangedSpy.at( 0 ).at( 0 ).toModelIndex().row() == 0 );
+    REQUIRE( dataChangedSpy.at( 0 ).at( 1 ).toModelIndex().row() == 2 );
+
+    REQUIRE( featureAt( 0 ).geometry().boundingBox() == QgsRectangle( 10, 5, 11, 6 ) );
+    REQUIRE( featureAt( 1 ).geometry().boundingBox() == QgsRectangle( 2, 0, 3, 1 ) );
+    REQUIRE( featureAt( 2 ).geometry().boundingBox() == QgsRectangle( 14, 5, 15, 6 ) );
+    REQUIRE( layer->getFeature( thirdFid ).geometry().boundingBox() == QgsRectangle( 14, 5, 15, 6 ) );
+  }
+
+  SECTION( "MergeSelection" )
+  {
+    model->toggleSelectedItem( 0 );
+    model->toggleSelectedItem( 1 );
+    model->toggleSelectedItem( 2 );
+    REQUIRE( model->canMergeSelection() );
+    dataChangedSpy.clear();
+
+    // the deletion command nested within the merge command does not flush the pending changes on its own
+    REQUIRE( model->mergeSelection() );
+    REQUIRE( !layer->isEditable() );
+    REQUIRE( layer->featureCount() == 1 );
+
+    // the merged feature row changes and the following contiguous rows are removed at once
+    REQUIRE( modelResetSpy.count() == 0 );
+    REQUIRE( dataChangedSpy.count() == 1 );
+    REQUIRE( dataChangedSpy.at( 0 ).at( 0 ).toModelIndex().row() == 0 );
+    REQUIRE( rowsRemovedSpy.count() == 1 );
+    REQUIRE( rowsRemovedSpy.at( 0 ).at( 1 ).toInt() == 1 );
+    REQUIRE( rowsRemovedSpy.at( 0 ).at( 2 ).toInt() == 2 );
+    REQUIRE( model->count() == 1 );
+    REQUIRE( featureAt( 0 ).id() == firstFid );
+    REQUIRE( featureAt( 0 ).geometry().area() == 3.0 );
+    REQUIRE( layer->getFeature( firstFid ).geometry().area() == 3.0 );
+  }
+
+  SECTION( "DuplicateSelection" )
+  {
+    model->toggleSelectedItem( 1 );
+    model->toggleSelectedItem( 2 );
+
+    REQUIRE( model->duplicateSelection() );
+    REQUIRE( !layer->isEditable() );
+    REQUIRE( layer->featureCount() == 5 );
+
+    // the model holds the duplicated features, selected
+    REQUIRE( modelResetSpy.count() == 1 );
+    REQUIRE( model->count() == 2 );
+    REQUIRE( model->selectedCount() == 2 );
+    for ( int row = 0; row < 2; row++ )
+    {
+      const QgsFeature duplicatedFeature = featureAt( row );
+      REQUIRE( duplicatedFeature.id() != secondFid );
+      REQUIRE( duplicatedFeature.id() != thirdFid );
+      REQUIRE( layer->getFeature( duplicatedFeature.id() ).isValid() );
+    }
+    REQUIRE( featureAt( 0 ).attribute( 0 ).toString() == QStringLiteral( "square 1" ) );
+    REQUIRE( featureAt( 1 ).attribute( 0 ).toString() == QStringLiteral( "square 2" ) );
+  }
+
+  SECTION( "NestedEditCommands" )
+  {
+    REQUIRE( layer->startEditing() );
+
+    layer->beginEditCommand( QStringLiteral( "outer" ) );
+    layer->beginEditCommand( QStringLiteral( "inner" ) );
+    REQUIRE( layer->changeGeometry( firstFid, QgsGeometry::fromWkt( QStringLiteral( "MultiPolygon(((0 0, 2 0, 2 2, 0 2, 0 0)))" ) ) ) );
+    REQUIRE( layer->changeAttributeValue( secondFid, 0, QStringLiteral( "renamed" ) ) );
+    layer->endEditCommand();
+
+    // the changes wait for the outermost command
+    REQUIRE( dataChangedSpy.count() == 0 );
+    REQUIRE( featureAt( 0 ).geometry().area() == 1.0 );
+    REQUIRE( featureAt( 1 ).attribute( 0 ).toString() == QStringLiteral( "square 1" ) );
+
+    layer->endEditCommand();
+
+    REQUIRE( modelResetSpy.count() == 0 );
+    REQUIRE( dataChangedSpy.count() == 1 );
+    REQUIRE( dataChangedSpy.at( 0 ).at( 0 ).toModelIndex().row() == 0 );
+    REQUIRE( dataChangedSpy.at( 0 ).at( 1 ).toModelIndex().row() == 1 );
+    REQUIRE( featureAt( 0 ).geometry().area() == 4.0 );
+    REQUIRE( featureAt( 1 ).attribute( 0 ).toString() == QStringLiteral( "renamed" ) );
+
+    // outside of edit commands, changes are applied right away
+    dataChangedSpy.clear();
+    REQUIRE( layer->changeAttributeValue( thirdFid, 0, QStringLiteral( "direct" ) ) );
+    REQUIRE( dataChangedSpy.count() == 1 );
+    REQUIRE( featureAt( 2 ).attribute( 0 ).toString() == QStringLiteral( "direct" ) );
+
+    REQUIRE( layer->rollBack() );
+  }
+
+  SECTION( "DestroyedEditCommand" )
+  {
+    REQUIRE( layer->startEditing() );
+
+    layer->beginEditCommand( QStringLiteral( "destroyed" ) );
+    REQUIRE( layer->deleteFeature( firstFid ) );
+    REQUIRE( layer->changeGeometry( secondFid, QgsGeometry::fromWkt( QStringLiteral( "MultiPolygon(((2 0, 4 0, 4 2, 2 2, 2 0)))" ) ) ) );
+    REQUIRE( model->count() == 3 );
+    layer->destroyEditCommand();
+
+    // the deleted feature is restored and the changed geometry reverted, no row goes away
+    REQUIRE( modelResetSpy.count() == 0 );
+    REQUIRE( rowsRemovedSpy.count() == 0 );
+    REQUIRE( model->count() == 3 );
+    REQUIRE( featureAt( 0 ).id() == firstFid );
+    REQUIRE( featureAt( 1 ).geometry().area() == 1.0 );
+
+    // the model is back to applying changes right away
+    REQUIRE( layer->deleteFeature( thirdFid ) );
+    REQUIRE( rowsRemovedSpy.count() == 1 );
+    REQUIRE( model->count() == 2 );
+
+    REQUIRE( layer->rollBack() );
+  }
+
+  SECTION( "DestroyedNestedEditCommand" )
+  {
+    REQUIRE( layer->startEditing() );
+
+    layer->beginEditCommand( QStringLiteral( "outer" ) );
+    REQUIRE( layer->deleteFeature( firstFid ) );
+
+    layer->beginEditCommand( QStringLiteral( "inner" ) );
+    REQUIRE( layer->deleteFeature( thirdFid ) );
+    layer->destroyEditCommand();
+
+    // only the deletion of the destroyed command is dropped
+    REQUIRE( rowsRemovedSpy.count() == 0 );
+    layer->endEditCommand();
+
+    REQUIRE( modelResetSpy.count() == 0 );
+    REQUIRE( rowsRemovedSpy.count() == 1 );
+    REQUIRE( model->count() == 2 );
+    REQUIRE( featureAt( 0 ).id() == secondFid );
+    REQUIRE( featureAt( 1 ).id() == thirdFid );
+
+    REQUIRE( layer->rollBack() );
+  }
+}
@@ -129,8 +129,11 @@ TEST_CASE( "OrderedRelationModel" )
     REQUIRE( mReferencingLayer->getFeature( 3 ).attribute( QStringLiteral( "rank" ) ).toInt() == 3 );
     REQUIRE( mReferencingLayer->getFeature( 4 ).attribute( QStringLiteral( "rank" ) ).toInt() == 4 );
 
+    // the model is updated in place, without reloading the features
+    QSignalSpy rowsMovedSpy( mModel.get(), &QAbstractItemModel::rowsMoved );
     REQUIRE( mModel->moveItems( 1, 3 ) );
-    REQUIRE( QSignalSpy( mModel.get(), &ReferencingFeatureListModel::modelUpdated ).wait( 1000 ) );
+    REQUIRE( rowsMovedSpy.count() == 1 );
+    REQUIRE( !mModel->isLoading() );
     REQUIRE( mModel->rowCount() == 4 );
     REQUIRE( mReferencingLayer->getFeature( 1 ).attribute( QStringLiteral( "rank" ) ).toInt() == 1 );
     REQUIRE( mReferencingLayer->getFeature( 2 ).attribute( QStringLiteral( "rank" ) ).toInt() == 4 );
@@ -143,4 +146,38 @@ TEST_CASE( "OrderedRelationModel" )
     REQUIRE( mModel->data( mModel->index( 2, 0 ), OrderedRelationModel::FeatureIdRole ) == 4 );
     REQUIRE( mModel->data( mModel->index( 3, 0 ), OrderedRelationModel::FeatureIdRole ) == 2 );
   }
+
+  SECTION( "ReorderFeatures" )
+  {
+    mModel->setRelation( mRelation );
+    mModel->setOrderingField( QStringLiteral( "rank" ) );
+    mModel->setFeature( mReferencedLayer->getFeature( 1 ) );
+
+    REQUIRE( QSignalSpy( mModel.get(), &ReferencingFeatureListModel::modelUpdated ).wait( 1000 ) );
+    REQUIRE( mModel->rowCount() == 4 );
+
+    // not a permutation of the rows
+    REQUIRE( !mModel->reorderItems( QList<int>() << 0 << 1 << 2 ) );
+    REQUIRE( !mModel->reorderItems( QList<int>() << 0 << 1 << 1 << 3 ) );
+
+    // swapping the first two rows leaves the other orderings untouched
+    QSignalSpy attributeValueChangedSpy( mReferencingLayer.get(), &QgsVectorLayer::attributeValueChanged );
+    REQUIRE( mModel->reorderItems( QList<int>() << 1 << 0 << 2 << 3 ) );
+    REQUIRE( attributeValueChangedSpy.count() == 2 );
+    REQUIRE( mReferencingLayer->getFeature( 1 ).attribute( QStringLiteral( "rank" ) ).toInt() == 2 );
+    REQUIRE( mReferencingLayer->getFeature( 2 ).attribute( QStringLiteral( "rank" ) ).toInt() == 1 );
+    REQUIRE( mReferencingLayer->getFeature( 3 ).attribute( QStringLiteral( "rank" ) ).toInt() == 3 );
+    REQUIRE( mReferencingLayer->getFeature( 4 ).attribute( QStringLiteral( "rank" ) ).toInt() == 4 );
+
+    // reverse the whole list
+    REQUIRE( mModel->reorderItems( QList<int>() << 3 << 2 << 1 << 0 ) );
+    REQUIRE( mModel->data( mModel->index( 0, 0 ), OrderedRelationModel::FeatureIdRole ) == 4 );
+    REQUIRE( mModel->data( mModel->index( 1, 0 ), OrderedRelationModel::FeatureIdRole ) == 3 );
+    REQUIRE( mModel->data( mModel->index( 2, 0 ), OrderedRelationModel::FeatureIdRole ) == 1 );
+    REQUIRE( mModel->data( mModel->index( 3, 0 ), OrderedRelationModel::FeatureIdRole ) == 2 );
+    REQUIRE( mReferencingLayer->getFeature( 4 ).attribute( QStringLiteral( "rank" ) ).toInt() == 1 );
+    REQUIRE( mReferencingLayer->getFeature( 3 ).attribute( QStringLiteral( "rank" ) ).toInt() == 2 );
+    REQUIRE( mReferencingLayer->getFeature( 1 ).attribute( QStringLiteral( "rank" ) ).toInt() == 3 );
+    REQUIRE( mReferencingLayer->getFeature( 2 ).attribute( QStringLiteral( "rank" ) ).toInt() == 4 );
+  }
 }
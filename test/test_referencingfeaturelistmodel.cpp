@@ -322,4 +322,60 @@ TEST_CASE( "ReferencingFeatureListModel" )
     //Frodo has still shares of 4 lands (Mordor, Gondor, Eriador, Rohan) because his shares are untouched
     REQUIRE( mModel->rowCount() == 4 );
   }
+
+  /*
+      FetchMoreReferencingFeatures
+      - add enough lands for Gollum to span three pages
+      - create model (set relation, set feature)
+      - only the first page is loaded
+      - fetch the following pages
+    */
+  SECTION( "FetchMoreReferencingFeatures" )
+  {
+    mL_Land->startEditing();
+    for ( int i = 0; i < 250; i++ )
+    {
+      QgsFeature land( mL_Land->fields() );
+      land.setAttribute( QStringLiteral( "id" ), 100 + i );
+      land.setAttribute( QStringLiteral( "name" ), QStringLiteral( "Land %1" ).arg( i, 3, 10, QLatin1Char( '0' ) ) );
+      land.setAttribute( QStringLiteral( "king_id" ), 1 );
+      mL_Land->addFeature( land );
+    }
+    mL_Land->commitChanges();
+    REQUIRE( mL_Land->featureCount() == 254L );
+
+    mModel->setNmRelation( QgsRelation() );
+    QSignalSpy( mModel.get(), &ReferencingFeatureListModel::modelUpdated ).wait( 500 );
+    mModel->setRelation( mR_Landhasoneking );
+    QSignalSpy( mModel.get(), &ReferencingFeatureListModel::modelUpdated ).wait( 500 );
+
+    //check out Gollum
+    mModel->setFeature( mL_King->getFeature( 2 ) );
+    REQUIRE( QSignalSpy( mModel.get(), &ReferencingFeatureListModel::modelUpdated ).wait( 1000 ) );
+
+    //Gollum rules 251 lands, only the first page of 100 is loaded
+    REQUIRE( mModel->rowCount() == 100 );
+    REQUIRE( mModel->canFetchMore( QModelIndex() ) );
+    REQUIRE( mModel->data( mModel->index( 99, 0 ), ReferencingFeatureListModel::DisplayString ).toString() == QStringLiteral( "Land 099" ) );
+
+    QSignalSpy rowsInsertedSpy( mModel.get(), &QAbstractItemModel::rowsInserted );
+    mModel->fetchMore( QModelIndex() );
+    REQUIRE( mModel->rowCount() == 200 );
+    REQUIRE( mModel->canFetchMore( QModelIndex() ) );
+    REQUIRE( rowsInsertedSpy.count() == 1 );
+    REQUIRE( rowsInsertedSpy.at( 0 ).at( 1 ).toInt() == 100 );
+    REQUIRE( rowsInsertedSpy.at( 0 ).at( 2 ).toInt() == 199 );
+    //pages follow the display expression ordering
+    REQUIRE( mModel->data( mModel->index( 100, 0 ), ReferencingFeatureListModel::DisplayString ).toString() == QStringLiteral( "Land 100" ) );
+
+    mModel->fetchMore( QModelIndex() );
+    REQUIRE( mModel->rowCount() == 251 );
+    REQUIRE( !mModel->canFetchMore( QModelIndex() ) );
+    REQUIRE( mModel->data( mModel->index( 249, 0 ), ReferencingFeatureListModel::DisplayString ).toString() == QStringLiteral( "Land 249" ) );
+    REQUIRE( mModel->data( mModel->index( 250, 0 ), ReferencingFeatureListModel::DisplayString ).toString() == QStringLiteral( "Mordor" ) );
+
+    //nothing left to fetch
+    mModel->fetchMore( QModelIndex() );
+    REQUIRE( mModel->rowCount() == 251 );
+  }
 }
@@ -46,4 +46,26 @@ TEST_CASE( "StringUtils" )
     REQUIRE( StringUtils::fuzzyMatch( "Quercus rubra", "q   r" ) == true );
     REQUIRE( StringUtils::fuzzyMatch( "Quercus rubra", "q   ubra" ) == false );
   }
+
+  SECTION( "FuzzyMatchScore" )
+  {
+    REQUIRE( StringUtils::fuzzyMatchScore( "Quercus rubra", "quercus rubra" ) == 1.0 );
+    REQUIRE( StringUtils::fuzzyMatchScore( "Quercus rubra", "Pinus nigra" ) == 0.0 );
+    REQUIRE( StringUtils::fuzzyMatchScore( "Quercus rubra", "" ) == 0.0 );
+
+    const double prefixScore = StringUtils::fuzzyMatchScore( "Quercus rubra", "querc" );
+    const double wordScore = StringUtils::fuzzyMatchScore( "Quercus rubra", "rubr" );
+    const double substringScore = StringUtils::fuzzyMatchScore( "Quercus rubra", "ubra" );
+    const double wordsScore = StringUtils::fuzzyMatchScore( "Quercus rubra", "q r" );
+    REQUIRE( prefixScore >= 0.75 );
+    REQUIRE( prefixScore < 1.0 );
+    REQUIRE( wordScore < prefixScore );
+    REQUIRE( substringScore < wordScore );
+    REQUIRE( wordsScore < substringScore );
+    REQUIRE( wordsScore > 0.0 );
+
+    // longer terms rank higher within a tier
+    REQUIRE( StringUtils::fuzzyMatchScore( "Quercus rubra", "quercus r" ) > prefixScore );
+    REQUIRE( StringUtils::fuzzyMatchScore( "Quercus", "querc" ) > prefixScore );
+  }
 }